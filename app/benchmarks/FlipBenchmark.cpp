@@ -0,0 +1,176 @@
+//
+// Created by user on 10/17/26.
+//
+
+// Flips generated RGBA images for OpenGL three ways: the copying flipVertically, flipVerticallyInPlace, and
+// decoding a PNG of the image bottom-up through ImageLoadOptions::flipVertically, next to a plain decode.
+// Usage: FlipBenchmark [size...], defaulting to 1024 2048 4096 8192
+
+#include <algorithm>
+#include <chrono>
+#include <csetjmp>
+#include <cstdio>
+#include <filesystem>
+#include <format>
+#include <memory>
+#include <print>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <png.h>
+#include "app/Image.h"
+
+namespace
+{
+    constexpr auto ITERATIONS{ 5 };
+
+    // Median wall time of one call, in milliseconds
+    template<typename Function>
+    double measure(Function function)
+    {
+        std::vector<double> samples{};
+        samples.reserve(ITERATIONS);
+        for (auto i{ 0 }; i < ITERATIONS; ++i)
+        {
+            const auto start{ std::chrono::steady_clock::now() };
+            function();
+            const std::chrono::duration<double, std::milli> elapsed{ std::chrono::steady_clock::now() - start };
+            samples.push_back(elapsed.count());
+        }
+        std::ranges::nth_element(samples, samples.begin() + ITERATIONS / 2);
+        return samples[ITERATIONS / 2];
+    }
+
+    // Gradients with a pattern, so the PNG neither compresses to nothing nor decodes as noise
+    lgl::ImageData generateImage(const uint32_t size)
+    {
+        lgl::ImageData image{};
+        image.width = size;
+        image.height = size;
+        image.channels = 4;
+        image.pixelFormat = lgl::PixelFormat::RGBA;
+        image.data.resize(static_cast<std::size_t>(size) * size * 4);
+        auto* pixel{ image.data.data() };
+        for (uint32_t y{ 0 }; y < size; ++y)
+        {
+            for (uint32_t x{ 0 }; x < size; ++x)
+            {
+                *pixel++ = static_cast<std::byte>(x * 255 / size);
+                *pixel++ = static_cast<std::byte>(y * 255 / size);
+                *pixel++ = static_cast<std::byte>((x ^ y) & 0xFF);
+                *pixel++ = std::byte{ 255 };
+            }
+        }
+        return image;
+    }
+
+    // libpng reports errors through longjmp; nothing with a destructor is created after setjmp
+    void writePng(const std::filesystem::path& path, const lgl::ImageData& image)
+    {
+        const std::unique_ptr<std::FILE, decltype(&std::fclose)> file{
+            std::fopen(path.string().c_str(), "wb"),
+            &std::fclose
+        };
+        if (file == nullptr)
+        {
+            throw std::runtime_error(std::format("Failed to create '{}'", path.string()));
+        }
+        auto* png{ png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr) };
+        auto* info{ png != nullptr ? png_create_info_struct(png) : nullptr };
+        if (info == nullptr || setjmp(png_jmpbuf(png)))
+        {
+            png_destroy_write_struct(&png, &info);
+            throw std::runtime_error(std::format("Failed to write '{}'", path.string()));
+        }
+
+        png_init_io(png, file.get());
+        png_set_IHDR(png,
+                     info,
+                     image.width,
+                     image.height,
+                     8,
+                     PNG_COLOR_TYPE_RGB_ALPHA,
+                     PNG_INTERLACE_NONE,
+                     PNG_COMPRESSION_TYPE_DEFAULT,
+                     PNG_FILTER_TYPE_DEFAULT);
+        png_set_compression_level(png, 1);
+        png_write_info(png, info);
+        for (uint32_t y{ 0 }; y < image.height; ++y)
+        {
+            png_write_row(png, reinterpret_cast<png_const_bytep>(image.row(y, image.rowOrder).data()));
+        }
+        png_write_end(png, nullptr);
+        png_destroy_write_struct(&png, &info);
+    }
+}
+
+int main(const int argc, char* argv[])
+{
+    std::vector<uint32_t> sizes{};
+    for (auto i{ 1 }; i < argc; ++i)
+    {
+        sizes.push_back(static_cast<uint32_t>(std::stoul(argv[i])));
+    }
+    if (sizes.empty())
+    {
+        sizes = { 1024, 2048, 4096, 8192 };
+    }
+
+    std::println("{:>6} {:>10} {:>10} {:>10} {:>10} {:>10} {:>12}",
+                 "size", "copy ms", "inplace ms", "GB/s", "decode ms", "flag ms", "flag cost ms");
+    for (const auto size : sizes)
+    {
+        auto image{ generateImage(size) };
+        const auto path{ std::filesystem::temp_directory_path() / std::format("lgl_flip_benchmark_{}.png", size) };
+        writePng(path, image);
+
+        // Every variant has to produce the same bottom-up pixels
+        const auto copied{ image.flipVertically() };
+        const auto decoded{ lgl::loadImage(path, { .flipVertically = true }) };
+        image.flipVerticallyInPlace();
+        if (copied.data != image.data || decoded.data != image.data)
+        {
+            std::println(stderr, "Flipping a {0}x{0} image gives different pixels", size);
+            std::filesystem::remove(path);
+            return 1;
+        }
+
+        const auto copy{
+            measure([&]
+            {
+                const auto flipped{ image.flipVertically() };
+            })
+        };
+        const auto inPlace{
+            measure([&]
+            {
+                image.flipVerticallyInPlace();
+            })
+        };
+        const auto decode{
+            measure([&]
+            {
+                const auto topDown{ lgl::loadImage(path, { .flipVertically = false }) };
+            })
+        };
+        const auto flag{
+            measure([&]
+            {
+                const auto bottomUp{ lgl::loadImage(path, { .flipVertically = true }) };
+            })
+        };
+        std::filesystem::remove(path);
+
+        // The in-place flip reads and writes every byte once
+        const auto bytes{ static_cast<double>(image.data.size()) };
+        std::println("{:>6} {:>10.2f} {:>10.2f} {:>10.2f} {:>10.2f} {:>10.2f} {:>12.2f}",
+                     size,
+                     copy,
+                     inPlace,
+                     2.0 * bytes / (inPlace * 1e6),
+                     decode,
+                     flag,
+                     flag - decode);
+    }
+    return 0;
+}
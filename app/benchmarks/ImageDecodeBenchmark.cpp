@@ -0,0 +1,130 @@
+//
+// Created by user on 10/17/26.
+//
+
+// Decodes the same images through the direct libpng/libjpeg readers and through the boost::gil any_image path
+// they replaced, which staged the image and copied it out pixel by pixel before flipping it for OpenGL.
+// Usage: ImageDecodeBenchmark [image...], defaulting to the bundled textures
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <print>
+#include <utility>
+#include <vector>
+#include <boost/gil.hpp>
+#include <boost/gil/extension/io/jpeg.hpp>
+#include <boost/gil/extension/io/png.hpp>
+#include "app/Image.h"
+
+namespace
+{
+    constexpr auto ITERATIONS{ 20 };
+
+    template<typename Image>
+    lgl::ImageData copyPixels(const Image& image)
+    {
+        using PixelType = typename Image::value_type;
+        constexpr auto channels{ boost::gil::num_channels<PixelType>::value };
+
+        lgl::ImageData texture{};
+        texture.width = static_cast<uint32_t>(image.width());
+        texture.height = static_cast<uint32_t>(image.height());
+        texture.channels = channels;
+        texture.pixelFormat = lgl::ImageData::getPixelFormat(texture.channels);
+        texture.data.resize(static_cast<std::size_t>(texture.width) * texture.height * channels);
+
+        std::size_t i{ 0 };
+        for (const auto& pixel : boost::gil::const_view(image))
+        {
+            [&]<std::size_t... Channel>(std::index_sequence<Channel...>)
+            {
+                ((texture.data[i++] = static_cast<std::byte>(boost::gil::at_c<Channel>(pixel))), ...);
+            }(std::make_index_sequence<channels>{});
+        }
+        return texture;
+    }
+
+    // The reader removed from Image.h, followed by the flip Mesh used to apply afterward
+    lgl::ImageData readWithGil(const std::filesystem::path& path)
+    {
+        lgl::ImageData texture{};
+        if (path.extension() == ".png")
+        {
+            boost::gil::any_image<
+                boost::gil::gray8_image_t,
+                boost::gil::gray_alpha8_image_t,
+                boost::gil::rgb8_image_t,
+                boost::gil::rgba8_image_t
+            > image;
+            boost::gil::read_image(path.string(), image, boost::gil::png_tag{});
+            boost::variant2::visit([&texture](const auto& typedImage) { texture = copyPixels(typedImage); }, image);
+        }
+        else
+        {
+            boost::gil::any_image<boost::gil::gray8_image_t, boost::gil::rgb8_image_t> image;
+            boost::gil::read_image(path.string(), image, boost::gil::jpeg_tag{});
+            boost::variant2::visit([&texture](const auto& typedImage) { texture = copyPixels(typedImage); }, image);
+        }
+        return texture.flipVertically();
+    }
+
+    lgl::ImageData readDirect(const std::filesystem::path& path)
+    {
+        return lgl::loadImage(path, lgl::ImageLoadOptions{ .flipVertically = true });
+    }
+
+    // Median wall time of one decode, in milliseconds
+    template<typename Read>
+    double measure(const std::filesystem::path& path, Read read)
+    {
+        std::vector<double> samples{};
+        samples.reserve(ITERATIONS);
+        for (auto i{ 0 }; i < ITERATIONS; ++i)
+        {
+            const auto start{ std::chrono::steady_clock::now() };
+            const auto image{ read(path) };
+            const std::chrono::duration<double, std::milli> elapsed{ std::chrono::steady_clock::now() - start };
+            samples.push_back(elapsed.count());
+        }
+        std::ranges::nth_element(samples, samples.begin() + ITERATIONS / 2);
+        return samples[ITERATIONS / 2];
+    }
+}
+
+int main(const int argc, char* argv[])
+{
+    std::vector<std::filesystem::path> paths{ argv + 1, argv + argc };
+    if (paths.empty())
+    {
+        for (const auto& entry : std::filesystem::directory_iterator{ LEARNOPENGL_RESOURCE_DIR "/textures" })
+        {
+            if (entry.path().extension() == ".png" || entry.path().extension() == ".jpg")
+            {
+                paths.push_back(entry.path());
+            }
+        }
+        std::ranges::sort(paths);
+    }
+
+    std::println("{:<28} {:>10} {:>10} {:>10} {:>8}", "image", "pixels", "gil ms", "direct ms", "speedup");
+    for (const auto& path : paths)
+    {
+        const auto reference{ readWithGil(path) };
+        if (const auto image{ readDirect(path) }; image.data != reference.data)
+        {
+            std::println(stderr, "'{}' decodes differently through both paths", path.string());
+            return 1;
+        }
+
+        const auto gil{ measure(path, readWithGil) };
+        const auto direct{ measure(path, readDirect) };
+        std::println("{:<28} {:>10} {:>10.2f} {:>10.2f} {:>7.2f}x",
+                     path.filename().string(),
+                     std::format("{}x{}", reference.width, reference.height),
+                     gil,
+                     direct,
+                     gil / direct);
+    }
+    return 0;
+}
@@ -0,0 +1,188 @@
+//
+// Created by user on 10/17/26.
+//
+
+// Draws growing numbers of backpacks in a row receding from the camera, every copy farther away than the last, once
+// at full detail and once with level of detail selection, and reports the triangles submitted, the frame time and
+// the triangle throughput of each.
+// Usage: LodBenchmark [count] [spacing], defaulting to 64 copies 4 units apart; needs an OpenGL 3.3 context
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <print>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/ext/matrix_transform.hpp>
+#include <glm/mat3x3.hpp>
+#include <glm/mat4x4.hpp>
+#include "app/CookedModel.h"
+#include "app/CookedTexture.h"
+#include "app/Mesh.h"
+#include "app/Model.h"
+#include "app/PerspectiveCamera.h"
+#include "app/ShaderProgram.h"
+
+using namespace lgl::literals;
+
+namespace
+{
+    constexpr auto ITERATIONS{ 20 };
+    // Frames drawn before timing, so the selected levels and the driver have settled
+    constexpr auto WARMUP_FRAMES{ 5 };
+    constexpr auto WIDTH{ 1280 };
+    constexpr auto HEIGHT{ 720 };
+
+    struct FrameResult
+    {
+        std::size_t triangles{ 0 };
+        double milliseconds{ 0.0 };
+    };
+
+    // Median wall time of a frame including the GPU work, and the triangles it submitted
+    template<typename DrawFrame>
+    FrameResult measure(DrawFrame drawFrame)
+    {
+        for (auto i{ 0 }; i < WARMUP_FRAMES; ++i)
+        {
+            drawFrame();
+        }
+        glFinish();
+
+        FrameResult result{};
+        std::vector<double> samples{};
+        samples.reserve(ITERATIONS);
+        for (auto i{ 0 }; i < ITERATIONS; ++i)
+        {
+            const auto start{ std::chrono::steady_clock::now() };
+            result.triangles = drawFrame();
+            glFinish();
+            const std::chrono::duration<double, std::milli> elapsed{ std::chrono::steady_clock::now() - start };
+            samples.push_back(elapsed.count());
+        }
+        std::ranges::nth_element(samples, samples.begin() + ITERATIONS / 2);
+        result.milliseconds = samples[ITERATIONS / 2];
+        return result;
+    }
+
+    void report(const std::size_t count, const std::string_view mode, const FrameResult& result)
+    {
+        std::println("{:>6} {:<6} {:>12} {:>10.2f} {:>12.1f}",
+                     count,
+                     mode,
+                     result.triangles,
+                     result.milliseconds,
+                     static_cast<double>(result.triangles) / (result.milliseconds * 1e3));
+    }
+}
+
+int main(const int argc, char* argv[])
+{
+    const auto count{ argc > 1 ? std::stoul(argv[1]) : 64ul };
+    const auto spacing{ argc > 2 ? std::stof(argv[2]) : 4.0f };
+    const auto cacheDirectory{ std::filesystem::temp_directory_path() / "LearnOpenGLLodBenchmark" };
+    lgl::CookedTexture::setCacheDirectory(cacheDirectory / "textures");
+    lgl::CookedModel::setCacheDirectory(cacheDirectory / "models");
+
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#ifdef __APPLE__
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#endif
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    auto* window{ glfwCreateWindow(WIDTH, HEIGHT, "LodBenchmark", nullptr, nullptr) };
+    if (window == nullptr)
+    {
+        std::println(stderr, "Failed to create GLFW window");
+        glfwTerminate();
+        return -1;
+    }
+    glfwMakeContextCurrent(window);
+    // Frames are timed by the GPU work, not by the display's refresh rate
+    glfwSwapInterval(0);
+
+    if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress)))
+    {
+        std::println(stderr, "Failed to initialize GLAD");
+        return -1;
+    }
+
+    int framebufferWidth{};
+    int framebufferHeight{};
+    glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+    glViewport(0, 0, framebufferWidth, framebufferHeight);
+    glEnable(GL_DEPTH_TEST);
+
+    {
+        const auto shaderProgram{
+            lgl::ShaderProgram::load(lgl::Mesh::vertexFormat() == lgl::VertexFormat::Full
+                                     ? LEARNOPENGL_SHADER_DIR "/backpack.vert"
+                                     : LEARNOPENGL_SHADER_DIR "/backpack_packed.vert",
+                                     LEARNOPENGL_SHADER_DIR "/backpack.frag")
+        };
+        const auto model{ lgl::Model::load(LEARNOPENGL_RESOURCE_DIR "/models/backpack/backpack.obj") };
+
+        lgl::PerspectiveCamera camera{
+            45.0f,
+            static_cast<float>(framebufferWidth) / static_cast<float>(framebufferHeight)
+        };
+        shaderProgram.use();
+        shaderProgram.setUniform("view"_u, camera.getViewMatrix());
+        shaderProgram.setUniform("projection"_u, camera.getProjectionMatrix());
+        shaderProgram.setUniform("viewPos"_u, camera.getPosition());
+        shaderProgram.setUniform("material.shininess"_u, 64.0f);
+
+        // Copies alternate left and right of the view axis so the near ones do not hide the rest
+        std::vector<glm::mat4> modelMatrices{};
+        for (std::size_t i{ 0 }; i < count; ++i)
+        {
+            const auto side{ i % 2 == 0 ? -1.5f : 1.5f };
+            const auto distance{ spacing * static_cast<float>(i + 1) };
+            modelMatrices.push_back(glm::translate(glm::mat4{ 1.0f }, glm::vec3{ side, 0.0f, -distance }));
+        }
+
+        const auto drawFrame{
+            [&](const std::size_t instances, const bool selectLods)
+            {
+                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+                std::size_t triangles{ 0 };
+                for (std::size_t i{ 0 }; i < instances; ++i)
+                {
+                    const auto& modelMatrix{ modelMatrices[i] };
+                    shaderProgram.setUniform("model"_u, modelMatrix);
+                    shaderProgram.setUniform("normalMatrix"_u, glm::transpose(glm::inverse(glm::mat3{ modelMatrix })));
+                    if (selectLods)
+                    {
+                        model.draw(shaderProgram, camera, modelMatrix, static_cast<float>(framebufferHeight));
+                    }
+                    else
+                    {
+                        model.draw(shaderProgram);
+                    }
+                    triangles += model.drawnTriangleCount();
+                }
+                glfwSwapBuffers(window);
+                return triangles;
+            }
+        };
+
+        std::println("{:>6} {:<6} {:>12} {:>10} {:>12}", "count", "lod", "triangles", "frame ms", "Mtri/s");
+        for (std::size_t instances{ 1 }; instances <= count; instances *= 2)
+        {
+            report(instances, "off", measure([&] { return drawFrame(instances, false); }));
+            report(instances, "on", measure([&] { return drawFrame(instances, true); }));
+        }
+    }
+
+    std::filesystem::remove_all(cacheDirectory);
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return 0;
+}
@@ -0,0 +1,103 @@
+//
+// Created by user on 10/17/26.
+//
+
+// Times Model::load with empty caches, with warm caches, and after touching every file next to the model, which
+// must hash the sources once and then be as fast as a warm start again.
+// Usage: ModelLoadBenchmark [model], defaulting to the bundled backpack; needs an OpenGL 3.3 context
+
+#include <chrono>
+#include <filesystem>
+#include <print>
+#include <string_view>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include "app/CookedModel.h"
+#include "app/CookedTexture.h"
+#include "app/Mesh.h"
+#include "app/Model.h"
+
+namespace
+{
+    // Gives every file next to the model a new timestamp without changing its content
+    void touchDirectory(const std::filesystem::path& directory)
+    {
+        const auto now{ std::filesystem::file_time_type::clock::now() };
+        for (const auto& entry : std::filesystem::recursive_directory_iterator{ directory })
+        {
+            if (entry.is_regular_file())
+            {
+                std::filesystem::last_write_time(entry.path(), now);
+            }
+        }
+    }
+
+    void measure(const std::string_view run, const std::filesystem::path& path)
+    {
+        {
+            const auto model{ lgl::Model::load(path) };
+            const auto& statistics{ model.statistics() };
+            std::println("{:<10} {:>10.2f} {:>10.2f} {:>10.2f} {:>6} {:>8}",
+                         run,
+                         statistics.totalTime.count(),
+                         statistics.textureDecodeTime.count(),
+                         statistics.textureUploadTime.count(),
+                         statistics.cookedModelHit ? "yes" : "no",
+                         std::format("{}/{}", statistics.cookedTextureHits, statistics.textureCount));
+        }
+
+        // Unreferenced textures would otherwise make the next load skip decoding and uploading them
+        auto& textureCache{ lgl::Mesh::textureCache() };
+        const auto budget{ textureCache.budget() };
+        textureCache.setBudget(0);
+        textureCache.setBudget(budget);
+    }
+}
+
+int main(const int argc, char* argv[])
+{
+    const std::filesystem::path path{
+        argc > 1 ? argv[1] : LEARNOPENGL_RESOURCE_DIR "/models/backpack/backpack.obj"
+    };
+    const auto cacheDirectory{ std::filesystem::temp_directory_path() / "LearnOpenGLModelLoadBenchmark" };
+    lgl::CookedTexture::setCacheDirectory(cacheDirectory / "textures");
+    lgl::CookedModel::setCacheDirectory(cacheDirectory / "models");
+
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#ifdef __APPLE__
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#endif
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    auto* window{ glfwCreateWindow(64, 64, "ModelLoadBenchmark", nullptr, nullptr) };
+    if (window == nullptr)
+    {
+        std::println(stderr, "Failed to create GLFW window");
+        glfwTerminate();
+        return -1;
+    }
+    glfwMakeContextCurrent(window);
+
+    if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress)))
+    {
+        std::println(stderr, "Failed to initialize GLAD");
+        return -1;
+    }
+
+    std::filesystem::remove_all(cacheDirectory);
+    std::println("{:<10} {:>10} {:>10} {:>10} {:>6} {:>8}",
+                 "run", "total ms", "decode ms", "upload ms", "model", "textures");
+    measure("cold", path);
+    measure("warm", path);
+    touchDirectory(path.parent_path());
+    measure("touched", path);
+    measure("warm", path);
+
+    std::filesystem::remove_all(cacheDirectory);
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return 0;
+}
@@ -0,0 +1,88 @@
+//
+// Created by user on 10/17/26.
+//
+
+// Encodes images to every block format, reporting encode and decode throughput and the PSNR of the round trip.
+// PSNR covers the channels the format keeps, so BC4 is measured on red and BC5 on red and green.
+// Usage: TextureCompressionBenchmark [image...], defaulting to the bundled textures
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <print>
+#include <vector>
+#include "app/Image.h"
+#include "app/TextureCompression.h"
+#include "app/ThreadPool.h"
+
+namespace
+{
+    constexpr auto ITERATIONS{ 5 };
+
+    constexpr std::array FORMATS{
+        lgl::CompressedFormat::BC1,
+        lgl::CompressedFormat::BC3,
+        lgl::CompressedFormat::BC4,
+        lgl::CompressedFormat::BC5,
+        lgl::CompressedFormat::BC7
+    };
+
+    // Median wall time of one call, in seconds
+    template<typename Function>
+    double measure(Function function)
+    {
+        std::vector<double> samples{};
+        samples.reserve(ITERATIONS);
+        for (auto i{ 0 }; i < ITERATIONS; ++i)
+        {
+            const auto start{ std::chrono::steady_clock::now() };
+            function();
+            const std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+            samples.push_back(elapsed.count());
+        }
+        std::ranges::nth_element(samples, samples.begin() + ITERATIONS / 2);
+        return samples[ITERATIONS / 2];
+    }
+}
+
+int main(const int argc, char* argv[])
+{
+    std::vector<std::filesystem::path> paths{ argv + 1, argv + argc };
+    if (paths.empty())
+    {
+        for (const auto& entry : std::filesystem::directory_iterator{ LEARNOPENGL_RESOURCE_DIR "/textures" })
+        {
+            if (entry.path().extension() == ".png" || entry.path().extension() == ".jpg")
+            {
+                paths.push_back(entry.path());
+            }
+        }
+        std::ranges::sort(paths);
+    }
+
+    // parallelFor runs on the pool and the calling thread
+    std::println("{} encoder threads", lgl::ThreadPool::shared().size() + 1);
+    std::println("{:<28} {:>6} {:>14} {:>14} {:>10}", "image", "format", "encode MPix/s", "decode MPix/s", "PSNR dB");
+    for (const auto& path : paths)
+    {
+        const auto image{ lgl::loadImage(path) };
+        const auto megapixels{ static_cast<double>(image.width) * image.height / 1e6 };
+        for (const auto format : FORMATS)
+        {
+            std::vector<std::byte> blocks{};
+            const auto encode{ measure([&] { blocks = lgl::compress(image, format); }) };
+            lgl::ImageData decoded{};
+            const auto decode{
+                measure([&] { decoded = lgl::decompress(blocks, image.width, image.height, format); })
+            };
+            std::println("{:<28} {:>6} {:>14.1f} {:>14.1f} {:>10.2f}",
+                         path.filename().string(),
+                         format,
+                         megapixels / encode,
+                         megapixels / decode,
+                         lgl::psnr(image, decoded));
+        }
+    }
+    return 0;
+}
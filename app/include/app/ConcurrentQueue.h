@@ -0,0 +1,51 @@
+//
+// Created by user on 10/17/26.
+//
+
+#ifndef LEARNOPENGL_APP_CONCURRENTQUEUE_H
+#define LEARNOPENGL_APP_CONCURRENTQUEUE_H
+
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+
+namespace lgl
+{
+    // Unbounded multi-producer queue, used to hand finished work back to the GL thread
+    template<typename T>
+    class ConcurrentQueue
+    {
+    public:
+        void push(T value);
+
+        // Blocks until an element is available
+        [[nodiscard]] T pop();
+
+    private:
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        std::queue<T> m_values;
+    };
+
+    template<typename T>
+    void ConcurrentQueue<T>::push(T value)
+    {
+        {
+            std::scoped_lock lock{ m_mutex };
+            m_values.push(std::move(value));
+        }
+        m_condition.notify_one();
+    }
+
+    template<typename T>
+    T ConcurrentQueue<T>::pop()
+    {
+        std::unique_lock lock{ m_mutex };
+        m_condition.wait(lock, [this] { return !m_values.empty(); });
+        auto value{ std::move(m_values.front()) };
+        m_values.pop();
+        return value;
+    }
+} // lgl
+
+#endif //LEARNOPENGL_APP_CONCURRENTQUEUE_H
@@ -0,0 +1,92 @@
+//
+// Created by user on 10/17/26.
+//
+
+#ifndef LEARNOPENGL_APP_COOKEDMODEL_H
+#define LEARNOPENGL_APP_COOKEDMODEL_H
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <vector>
+#include "app/MappedFile.h"
+#include "app/MeshSimplification.h"
+#include "app/Texture.h"
+#include "app/Vertex.h"
+
+namespace lgl
+{
+    // Node of a model's hierarchy; its meshes are a contiguous range of the model's meshes
+    struct ModelNode
+    {
+        int32_t parent{ -1 }; // -1 for the root
+        uint32_t firstMesh{ 0 };
+        uint32_t meshCount{ 0 };
+    };
+
+    // Processed geometry of one mesh: welded, reordered and with its LOD chain appended to the indices
+    struct CookedMesh
+    {
+        std::span<const Vertex> vertices;
+        std::span<const uint32_t> indices;
+        std::vector<MeshLod> lods;
+        std::vector<TextureReference> textures;
+        bool triangleList{ true };
+    };
+
+    /**
+     * Imported model in a memory-mappable binary file, so warm loads skip the importer and the mesh processing.
+     *
+     * Cooked models are persisted in the cache directory, keyed by the source path and validated against the size
+     * and modification time of every file the import read, including material libraries.
+     */
+    class CookedModel
+    {
+    public:
+        /**
+         * Maps the cooked file of a source model if it exists and is still up to date
+         *
+         * @param sourcePath Path to the source model
+         * @return The cooked model, whose meshes point into the mapping, or std::nullopt if it has to be imported
+         */
+        [[nodiscard]] static std::optional<CookedModel> load(const std::filesystem::path& sourcePath);
+
+        /**
+         * Writes a model to the cache directory; failures are logged and otherwise ignored
+         *
+         * @param sourcePath Path to the source model
+         * @param dependencies Every file the import read; the cooked model goes stale when any of them changes
+         * @param nodes Hierarchy, meshes referenced in order
+         * @param meshes Geometry and material textures of every mesh
+         */
+        static void store(const std::filesystem::path& sourcePath,
+                          std::span<const std::filesystem::path> dependencies,
+                          std::span<const ModelNode> nodes,
+                          std::span<const CookedMesh> meshes);
+
+        // Not synchronized; set before loading any model. An empty path disables the on-disk cache
+        static void setCacheDirectory(std::filesystem::path directory);
+
+        [[nodiscard]] static const std::filesystem::path& cacheDirectory() noexcept;
+
+        [[nodiscard]] static std::filesystem::path cachePath(const std::filesystem::path& sourcePath);
+
+        [[nodiscard]] std::span<const ModelNode> nodes() const noexcept;
+
+        [[nodiscard]] std::span<const CookedMesh> meshes() const noexcept;
+
+    private:
+        explicit CookedModel(MappedFile file);
+
+        [[nodiscard]] bool parse();
+
+        MappedFile m_file;
+        std::vector<ModelNode> m_nodes;
+        std::vector<CookedMesh> m_meshes;
+
+        static std::filesystem::path s_cacheDirectory;
+    };
+} // lgl
+
+#endif //LEARNOPENGL_APP_COOKEDMODEL_H
@@ -0,0 +1,115 @@
+//
+// Created by user on 10/17/26.
+//
+
+#ifndef LEARNOPENGL_APP_COOKEDTEXTURE_H
+#define LEARNOPENGL_APP_COOKEDTEXTURE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <variant>
+#include <vector>
+#include "app/Image.h"
+#include "app/MappedFile.h"
+#include "app/Mipmap.h"
+#include "app/TextureCompression.h"
+#include "app/TextureContainer.h"
+
+namespace lgl
+{
+    /**
+     * GPU-ready texture: a full mip chain with rows stored bottom-up, optionally block-compressed.
+     *
+     * Cooked textures are persisted in the cache directory, keyed by the source path and how it is processed, and
+     * validated against the source size, modification time and content hash, so warm loads map the file instead of
+     * decoding the image.
+     */
+    class CookedTexture
+    {
+    public:
+        /**
+         * Maps the cooked file of a source image if it exists and is still up to date
+         *
+         * @param sourcePath Canonical path to the source image
+         * @param options Mip options the cached chain must have been built with
+         * @param compression Block format the cached levels must be stored in; std::nullopt selects
+         *                    automaticCompressedFormat for the cached pixel format
+         * @return The cooked texture, or std::nullopt if it has to be cooked again
+         */
+        [[nodiscard]] static std::optional<CookedTexture> load(const std::filesystem::path& sourcePath,
+                                                               const MipmapOptions& options,
+                                                               std::optional<CompressedFormat> compression = {});
+
+        /**
+         * Builds the mip chain of a decoded image and writes it to the cache directory.
+         * Also usable as an offline step to pre-populate the cache.
+         *
+         * @param sourcePath Canonical path to the source image
+         * @param image The decoded source image, rows stored bottom-up
+         * @param options Filtering used to build the mip chain
+         * @param compression Block format every level is encoded to; std::nullopt selects
+         *                    automaticCompressedFormat, CompressedFormat::None keeps raw pixels
+         * @return The cooked texture, usable even if writing the cache file failed
+         */
+        [[nodiscard]] static CookedTexture cook(const std::filesystem::path& sourcePath,
+                                                ImageData image,
+                                                const MipmapOptions& options,
+                                                std::optional<CompressedFormat> compression = {});
+
+        /**
+         * Adopts a mapped KTX2/DDS file and its mip chain; nothing is written to the cache directory.
+         * Bottom-up levels are used without copying. Top-down levels are flipped in an owned copy, and BC7 or
+         * other blocks that cannot be flipped as they are get decompressed first.
+         *
+         * @param sourcePath Canonical path the container was mapped from
+         * @param container The mapped file and its levels
+         */
+        [[nodiscard]] static CookedTexture fromContainer(const std::filesystem::path& sourcePath,
+                                                         TextureContainer container);
+
+        // Not synchronized; set before loading any texture. An empty path disables the on-disk cache
+        static void setCacheDirectory(std::filesystem::path directory);
+
+        [[nodiscard]] static const std::filesystem::path& cacheDirectory() noexcept;
+
+        // One file per source path, mip options and requested compression, so an image used in two roles is cooked
+        // for each
+        [[nodiscard]] static std::filesystem::path cachePath(const std::filesystem::path& sourcePath,
+                                                             const MipmapOptions& options,
+                                                             std::optional<CompressedFormat> compression);
+
+        // Format of the source pixels; also the layout of decompressed levels
+        [[nodiscard]] PixelFormat pixelFormat() const noexcept;
+
+        // CompressedFormat::None when the levels hold raw pixels
+        [[nodiscard]] CompressedFormat compressedFormat() const noexcept;
+
+        [[nodiscard]] std::span<const MipLevel> levels() const noexcept;
+
+        // Hash of the source file bytes; for containers, of the source path, size and modification time instead
+        [[nodiscard]] uint64_t contentHash() const noexcept;
+
+        [[nodiscard]] const MipmapOptions& mipmapOptions() const noexcept;
+
+        // Whether the levels point into a memory-mapped cache file
+        [[nodiscard]] bool isMapped() const noexcept;
+
+    private:
+        CookedTexture() = default;
+
+        [[nodiscard]] bool parse();
+
+        std::variant<std::vector<std::byte>, MappedFile> m_storage;
+        std::vector<MipLevel> m_levels;
+        PixelFormat m_pixelFormat{ PixelFormat::Unknown };
+        CompressedFormat m_compressedFormat{ CompressedFormat::None };
+        uint64_t m_contentHash{ 0 };
+        MipmapOptions m_mipmapOptions{};
+
+        static std::filesystem::path s_cacheDirectory;
+    };
+} // lgl
+
+#endif //LEARNOPENGL_APP_COOKEDTEXTURE_H
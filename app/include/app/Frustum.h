@@ -0,0 +1,31 @@
+//
+// Created by user on 10/17/26.
+//
+
+#ifndef LEARNOPENGL_APP_FRUSTUM_H
+#define LEARNOPENGL_APP_FRUSTUM_H
+
+#include <array>
+#include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
+#include "app/Vertex.h"
+
+namespace lgl
+{
+    // View volume as six inward-facing planes with unit normals; xyz is the normal, w the distance
+    struct Frustum
+    {
+        std::array<glm::vec4, 6> planes{};
+
+        /**
+         * Extracts the planes of a clip-space transform (Gribb and Hartmann).
+         * Passing projection * view * model gives the frustum in that model's space
+         */
+        [[nodiscard]] static Frustum fromMatrix(const glm::mat4& matrix) noexcept;
+
+        // Conservative: spheres near a corner may pass while just outside
+        [[nodiscard]] bool intersects(const BoundingSphere& sphere) const noexcept;
+    };
+} // lgl
+
+#endif //LEARNOPENGL_APP_FRUSTUM_H
@@ -0,0 +1,85 @@
+//
+// Created by user on 10/17/26.
+//
+
+#ifndef LEARNOPENGL_APP_GLCAPABILITIES_H
+#define LEARNOPENGL_APP_GLCAPABILITIES_H
+
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <glad/glad.h>
+#include "app/TextureCompression.h"
+
+// Tokens from extensions the GL 3.3 core loader does not define
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_RGBA_BPTC_UNORM
+#define GL_COMPRESSED_RGBA_BPTC_UNORM 0x8E8C
+#endif
+#ifndef GL_DRAW_INDIRECT_BUFFER
+#define GL_DRAW_INDIRECT_BUFFER 0x8F3F
+#endif
+
+namespace lgl
+{
+    // glMultiDrawElementsIndirect, core since OpenGL 4.3
+    using MultiDrawElementsIndirectFunction = void (APIENTRYP)(GLenum mode,
+                                                               GLenum type,
+                                                               const void* indirect,
+                                                               GLsizei drawCount,
+                                                               GLsizei stride);
+
+    /**
+     * Version and extensions of the current OpenGL context.
+     * Queried once on first use, which must happen on the GL thread after the loader is initialized.
+     */
+    class GLCapabilities
+    {
+    public:
+        [[nodiscard]] static const GLCapabilities& current();
+
+        [[nodiscard]] bool hasExtension(std::string_view name) const;
+
+        [[nodiscard]] bool isVersionAtLeast(GLint major, GLint minor) const noexcept;
+
+        // Whether glCompressedTexImage2D accepts the format
+        [[nodiscard]] bool supports(CompressedFormat format) const;
+
+        // Loaded from the context when it has multi-draw indirect, nullptr otherwise
+        [[nodiscard]] MultiDrawElementsIndirectFunction multiDrawElementsIndirect() const noexcept;
+
+    private:
+        GLCapabilities();
+
+        GLint m_majorVersion{ 0 };
+        GLint m_minorVersion{ 0 };
+        std::unordered_set<std::string> m_extensions;
+        MultiDrawElementsIndirectFunction m_multiDrawElementsIndirect{ nullptr };
+    };
+
+    constexpr GLenum gl_cast(const CompressedFormat format)
+    {
+        switch (format)
+        {
+            case CompressedFormat::BC1:
+                return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+            case CompressedFormat::BC3:
+                return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+            case CompressedFormat::BC4:
+                return GL_COMPRESSED_RED_RGTC1;
+            case CompressedFormat::BC5:
+                return GL_COMPRESSED_RG_RGTC2;
+            case CompressedFormat::BC7:
+                return GL_COMPRESSED_RGBA_BPTC_UNORM;
+            default:
+                throw std::runtime_error("Not a block-compressed format");
+        }
+    }
+} // lgl
+
+#endif //LEARNOPENGL_APP_GLCAPABILITIES_H
@@ -0,0 +1,152 @@
+//
+// Created by user on 10/17/26.
+//
+
+#ifndef LEARNOPENGL_APP_GEOMETRYBUFFER_H
+#define LEARNOPENGL_APP_GEOMETRYBUFFER_H
+
+#include <cstddef>
+#include <map>
+#include <optional>
+#include <span>
+#include <glad/glad.h>
+#include "app/VertexLayout.h"
+
+namespace lgl
+{
+    // First-fit allocator of element ranges; freed ranges are merged with their free neighbors
+    class RangeAllocator
+    {
+    public:
+        explicit RangeAllocator(std::size_t capacity = 0);
+
+        /**
+         * Reserves a contiguous range
+         *
+         * @param alignment The offset is a multiple of it
+         * @return Offset of the range, or std::nullopt if no free range is large enough
+         */
+        [[nodiscard]] std::optional<std::size_t> allocate(std::size_t count, std::size_t alignment = 1);
+
+        // Returns a range reserved by allocate
+        void free(std::size_t offset, std::size_t count);
+
+        // Adds free space at the end
+        void grow(std::size_t capacity);
+
+        [[nodiscard]] std::size_t capacity() const noexcept;
+
+        [[nodiscard]] std::size_t used() const noexcept;
+
+    private:
+        void insertFree(std::size_t offset, std::size_t count);
+
+        std::map<std::size_t, std::size_t> m_free; // Offset to count
+        std::size_t m_capacity{ 0 };
+        std::size_t m_used{ 0 };
+    };
+
+    /**
+     * Vertex and index buffer shared by many meshes of one vertex layout, drawn through a single vertex array.
+     *
+     * Meshes allocate ranges of both buffers; their indices stay relative to their own first vertex, which draws
+     * pass as the base vertex. Index ranges are allocated in bytes, so 16 and 32-bit indices share the buffer.
+     * The buffers grow by copying when full, keeping every allocation in place. Must only be used on the GL thread.
+     */
+    class GeometryBuffer
+    {
+    public:
+        using handle_type = GLuint;
+
+        struct Allocation
+        {
+            std::size_t firstVertex{ 0 };
+            std::size_t vertexCount{ 0 };
+            std::size_t indexOffset{ 0 }; // In bytes, aligned to the index size
+            std::size_t indexBytes{ 0 };
+        };
+
+        template<typename VertexT>
+        [[nodiscard]] static GeometryBuffer create();
+
+        GeometryBuffer(const GeometryBuffer& other) = delete;
+
+        GeometryBuffer(GeometryBuffer&& other) noexcept;
+
+        GeometryBuffer& operator=(const GeometryBuffer& other) = delete;
+
+        GeometryBuffer& operator=(GeometryBuffer&& other) noexcept;
+
+        ~GeometryBuffer();
+
+        /**
+         * Reserves room for a mesh, growing the buffers if needed
+         *
+         * @param indexSize Bytes per index, 2 or 4
+         */
+        [[nodiscard]] Allocation allocate(std::size_t vertexCount, std::size_t indexCount, std::size_t indexSize);
+
+        void free(const Allocation& allocation);
+
+        /**
+         * Fills an allocation's vertices
+         *
+         * @throws std::invalid_argument if VertexT is not the layout the buffer was created for
+         */
+        template<typename VertexT>
+        void uploadVertices(const Allocation& allocation, std::span<const VertexT> vertices);
+
+        template<typename IndexT>
+        void uploadIndices(const Allocation& allocation, std::span<const IndexT> indices);
+
+        [[nodiscard]] handle_type vertexArray() const noexcept;
+
+        [[nodiscard]] std::size_t vertexCapacity() const noexcept;
+
+        // In bytes
+        [[nodiscard]] std::size_t indexCapacity() const noexcept;
+
+        [[nodiscard]] std::size_t usedBytes() const noexcept;
+
+    private:
+        GeometryBuffer(std::size_t vertexSize, void (*enableAttributes)());
+
+        void uploadVertexBytes(const Allocation& allocation, std::span<const std::byte> bytes, std::size_t vertexSize);
+
+        void uploadIndexBytes(const Allocation& allocation, std::span<const std::byte> bytes);
+
+        // Points the vertex array at the current buffers, after they were replaced
+        void attachBuffers() const;
+
+        void release() noexcept;
+
+        std::size_t m_vertexSize{ 0 };
+        void (*m_enableAttributes)(){ nullptr };
+        RangeAllocator m_vertices;
+        RangeAllocator m_indices; // In bytes
+
+        handle_type m_vertexArrayObject{ 0 };
+        handle_type m_vertexBufferObject{ 0 };
+        handle_type m_elementBufferObject{ 0 };
+    };
+
+    template<typename VertexT>
+    GeometryBuffer GeometryBuffer::create()
+    {
+        return GeometryBuffer{ sizeof(VertexT), &enableVertexAttributes<VertexT> };
+    }
+
+    template<typename VertexT>
+    void GeometryBuffer::uploadVertices(const Allocation& allocation, const std::span<const VertexT> vertices)
+    {
+        uploadVertexBytes(allocation, std::as_bytes(vertices), sizeof(VertexT));
+    }
+
+    template<typename IndexT>
+    void GeometryBuffer::uploadIndices(const Allocation& allocation, const std::span<const IndexT> indices)
+    {
+        uploadIndexBytes(allocation, std::as_bytes(indices));
+    }
+} // lgl
+
+#endif //LEARNOPENGL_APP_GEOMETRYBUFFER_H
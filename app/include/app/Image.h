@@ -5,18 +5,14 @@
 #ifndef LEARNOPENGL_APP_IMAGE_H
 #define LEARNOPENGL_APP_IMAGE_H
 
-#include <boost/gil.hpp>
-#include <boost/gil/extension/io/jpeg.hpp>
-#include <boost/gil/extension/io/png.hpp>
-
+#include <algorithm>
+#include <array>
 #include <cstddef>
 #include <expected>
 #include <filesystem>
 #include <fstream>
-#include <print>
 #include <span>
 #include <stdexcept>
-#include <type_traits>
 #include <vector>
 
 namespace lgl
@@ -26,8 +22,9 @@ namespace lgl
     {
         Unknown,
         JPEG,
-        PNG
-        // Extensible for future formats
+        PNG,
+        KTX2, // GPU-ready container, see TextureContainer.h
+        DDS // GPU-ready container, see TextureContainer.h
     };
 
     enum class PixelFormat
@@ -39,17 +36,77 @@ namespace lgl
         RGBA // 4 channels
     };
 
+    // Channels of a pixel format; 0 for PixelFormat::Unknown or a value that is not an enumerator
+    [[nodiscard]] constexpr uint8_t channelCount(const PixelFormat pixelFormat) noexcept
+    {
+        switch (pixelFormat)
+        {
+            case PixelFormat::Red:
+                return 1;
+            case PixelFormat::RG:
+                return 2;
+            case PixelFormat::RGB:
+                return 3;
+            case PixelFormat::RGBA:
+                return 4;
+            default:
+                return 0;
+        }
+    }
+
+    // Options applied while decoding, so no post-processing pass over the pixels is needed
+    struct ImageLoadOptions
+    {
+        bool flipVertically{ false }; // Store rows bottom-up, as OpenGL expects them
+        // Decode at 1/2, 1/4 or 1/8 scale, the largest at which both sides fit (1/8 if none does); 0 keeps
+        // the full size. JPEG scales in the DCT, PNG skips rows and columns, containers pick a stored mip level
+        uint32_t maxDimension{ 0 };
+    };
+
+    // Scale denominator maxDimension selects for an image of the given size
+    [[nodiscard]] constexpr uint32_t scaleDenominator(const uint32_t width,
+                                                      const uint32_t height,
+                                                      const uint32_t maxDimension) noexcept
+    {
+        if (maxDimension == 0)
+        {
+            return 1;
+        }
+        for (const uint32_t denominator : { 1u, 2u, 4u })
+        {
+            if ((width + denominator - 1) / denominator <= maxDimension &&
+                (height + denominator - 1) / denominator <= maxDimension)
+            {
+                return denominator;
+            }
+        }
+        return 8;
+    }
+
     // Structure to hold image data and metadata
     struct ImageData
     {
+        // Order in which rows are laid out in data; OpenGL expects BottomUp
+        enum class RowOrder
+        {
+            TopDown,
+            BottomUp
+        };
+
         std::vector<std::byte> data;
         uint32_t width{ 0 };
         uint32_t height{ 0 };
         uint8_t channels{ 0 };
         PixelFormat pixelFormat{ PixelFormat::Unknown }; // Add this
+        RowOrder rowOrder{ RowOrder::TopDown };
         [[nodiscard]] bool isValid() const noexcept;
         [[nodiscard]] std::span<const std::byte> span() const noexcept;
+        [[nodiscard]] std::size_t rowSize() const noexcept;
+        // Zero-copy access to the index-th row as seen in the requested order
+        [[nodiscard]] std::span<const std::byte> row(uint32_t index, RowOrder order) const noexcept;
         [[nodiscard]] ImageData flipVertically() const;
+        // Swaps rows in place without allocating and toggles rowOrder
+        void flipVerticallyInPlace() noexcept;
 
         // Helper to get pixel format from channel count
         [[nodiscard]] static constexpr PixelFormat getPixelFormat(uint8_t channelCount) noexcept;
@@ -99,6 +156,27 @@ namespace lgl
                 return ImageFormat::PNG;
             }
 
+            // KTX2 identifier: «KTX 20»\r\n\x1A\n
+            constexpr std::array<uint8_t, 12> ktx2Identifier{
+                0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A
+            };
+            if (header.size() >= ktx2Identifier.size() &&
+                std::ranges::equal(header.first(ktx2Identifier.size()), ktx2Identifier, {},
+                                   [](const std::byte value) { return static_cast<uint8_t>(value); }))
+            {
+                return ImageFormat::KTX2;
+            }
+
+            // DDS signature: "DDS "
+            if (header.size() >= 4 &&
+                static_cast<uint8_t>(header[0]) == 0x44 &&
+                static_cast<uint8_t>(header[1]) == 0x44 &&
+                static_cast<uint8_t>(header[2]) == 0x53 &&
+                static_cast<uint8_t>(header[3]) == 0x20)
+            {
+                return ImageFormat::DDS;
+            }
+
             return ImageFormat::Unknown;
         }
 
@@ -108,174 +186,25 @@ namespace lgl
         {
             static_assert(Format != ImageFormat::Unknown, "Unknown or unsupported image format");
 
-            static ImageData read([[maybe_unused]] const std::filesystem::path& file_path)
+            static ImageData read([[maybe_unused]] const std::filesystem::path& file_path,
+                                  [[maybe_unused]] const ImageLoadOptions& options = {})
             {
                 throw std::runtime_error("Image format not implemented");
             }
         };
 
-        // JPEG specialization
+        // JPEG specialization, decodes straight into the ImageData buffer through libjpeg
         template<>
         struct ImageReader<ImageFormat::JPEG>
         {
-            static ImageData read(const std::filesystem::path& file_path)
-            {
-                // Use any_image to handle different channel counts
-                boost::gil::any_image<
-                    boost::gil::gray8_image_t,
-                    boost::gil::rgb8_image_t
-                > img;
-
-                try
-                {
-                    boost::gil::read_image(file_path.string(), img, boost::gil::jpeg_tag{});
-                }
-                catch (const std::exception& e)
-                {
-                    std::println(stderr, "Failed to read JPEG: {}", e.what());
-                    throw;
-                }
-                ImageData texture;
-
-                // Use variant2::visit instead of apply_operation
-                boost::variant2::visit([&texture]<typename T0>(T0&& typed_img)
-                {
-                    using ImageType = std::decay_t<T0>;
-                    using PixelType = typename ImageType::value_type;
-
-                    texture.width = static_cast<uint32_t>(typed_img.width());
-                    texture.height = static_cast<uint32_t>(typed_img.height());
-                    texture.channels = boost::gil::num_channels<PixelType>::value;
-                    texture.pixelFormat = ImageData::getPixelFormat(texture.channels);
-
-                    const auto total_size{ texture.width * texture.height * texture.channels };
-                    texture.data.resize(total_size);
-
-                    const auto view{ boost::gil::view(typed_img) };
-                    std::size_t i{ 0 };
-
-                    if constexpr (boost::gil::num_channels<PixelType>::value == 1)
-                    {
-                        // Grayscale
-                        for (const auto& pixel : view)
-                        {
-                            // Extract the gray channel value
-                            texture.data[i++] = static_cast<std::byte>(boost::gil::at_c<0>(pixel));
-                        }
-                    }
-                    else if constexpr (boost::gil::num_channels<PixelType>::value == 3)
-                    {
-                        // RGB
-                        for (const auto& pixel : view)
-                        {
-                            texture.data[i++] = static_cast<std::byte>(
-                                boost::gil::get_color(pixel, boost::gil::red_t()));
-                            texture.data[i++] = static_cast<std::byte>(boost::gil::get_color(
-                                pixel, boost::gil::green_t()));
-                            texture.data[i++] = static_cast<std::byte>(boost::gil::get_color(
-                                pixel, boost::gil::blue_t()));
-                        }
-                    }
-                }, img);
-
-                return texture;
-            }
+            static ImageData read(const std::filesystem::path& file_path, const ImageLoadOptions& options = {});
         };
 
-        // PNG specialization
+        // PNG specialization, decodes straight into the ImageData buffer through libpng
         template<>
         struct ImageReader<ImageFormat::PNG>
         {
-            static ImageData read(const std::filesystem::path& file_path)
-            {
-                // Use any_image to handle different PNG formats
-                boost::gil::any_image<
-                    boost::gil::gray8_image_t,
-                    boost::gil::gray_alpha8_image_t,
-                    boost::gil::rgb8_image_t,
-                    boost::gil::rgba8_image_t
-                > img;
-
-                try
-                {
-                    boost::gil::read_image(file_path.string(), img, boost::gil::png_tag{});
-                }
-                catch (const std::exception& e)
-                {
-                    std::println(stderr, "Failed to read PNG: {}", e.what());
-                    throw;
-                }
-                ImageData texture;
-
-                // Use variant2::visit instead of apply_operation
-                boost::variant2::visit([&texture]<typename T0>(T0&& typed_img)
-                {
-                    using ImageType = std::decay_t<T0>;
-                    using PixelType = typename ImageType::value_type;
-
-                    texture.width = static_cast<uint32_t>(typed_img.width());
-                    texture.height = static_cast<uint32_t>(typed_img.height());
-                    texture.channels = boost::gil::num_channels<PixelType>::value;
-                    texture.pixelFormat = ImageData::getPixelFormat(texture.channels);
-
-                    const auto total_size = texture.width * texture.height * texture.channels;
-                    texture.data.resize(total_size);
-
-                    const auto view = boost::gil::view(typed_img);
-                    std::size_t i = 0;
-
-                    if constexpr (boost::gil::num_channels<PixelType>::value == 1)
-                    {
-                        // Grayscale
-                        for (const auto& pixel : view)
-                        {
-                            // Extract the gray channel value
-                            texture.data[i++] = static_cast<std::byte>(boost::gil::at_c<0>(pixel));
-                        }
-                    }
-                    else if constexpr (boost::gil::num_channels<PixelType>::value == 2)
-                    {
-                        // Grayscale + Alpha
-                        for (const auto& pixel : view)
-                        {
-                            texture.data[i++] = static_cast<std::byte>(boost::gil::get_color(
-                                pixel, boost::gil::gray_color_t()));
-                            texture.data[i++] = static_cast<std::byte>(boost::gil::get_color(
-                                pixel, boost::gil::alpha_t()));
-                        }
-                    }
-                    else if constexpr (boost::gil::num_channels<PixelType>::value == 3)
-                    {
-                        // RGB
-                        for (const auto& pixel : view)
-                        {
-                            texture.data[i++] = static_cast<std::byte>(
-                                boost::gil::get_color(pixel, boost::gil::red_t()));
-                            texture.data[i++] = static_cast<std::byte>(boost::gil::get_color(
-                                pixel, boost::gil::green_t()));
-                            texture.data[i++] = static_cast<std::byte>(boost::gil::get_color(
-                                pixel, boost::gil::blue_t()));
-                        }
-                    }
-                    else if constexpr (boost::gil::num_channels<PixelType>::value == 4)
-                    {
-                        // RGBA
-                        for (const auto& pixel : view)
-                        {
-                            texture.data[i++] = static_cast<std::byte>(
-                                boost::gil::get_color(pixel, boost::gil::red_t()));
-                            texture.data[i++] = static_cast<std::byte>(boost::gil::get_color(
-                                pixel, boost::gil::green_t()));
-                            texture.data[i++] = static_cast<std::byte>(boost::gil::get_color(
-                                pixel, boost::gil::blue_t()));
-                            texture.data[i++] = static_cast<std::byte>(boost::gil::get_color(
-                                pixel, boost::gil::alpha_t()));
-                        }
-                    }
-                }, img);
-
-                return texture;
-            }
+            static ImageData read(const std::filesystem::path& file_path, const ImageLoadOptions& options = {});
         };
     }
 
@@ -288,16 +217,37 @@ namespace lgl
      */
     [[nodiscard]] ImageData loadImage(const std::filesystem::path& filePath);
 
+    /**
+     * Loads an image file, applying the given options while decoding
+     *
+     * @param filePath Path to the image file
+     * @param options Decode-time transformations, e.g. flipping rows for OpenGL upload
+     * @return TextureData containing the image as bytes with metadata
+     * @throws std::runtime_error if file is not a valid image or cannot be read
+     */
+    [[nodiscard]] ImageData loadImage(const std::filesystem::path& filePath, const ImageLoadOptions& options);
+
+    /**
+     * Loads a reduced-resolution preview of an image, scaled down while decoding rather than afterward.
+     * Shorthand for loadImage with only ImageLoadOptions::maxDimension set
+     *
+     * @param filePath Path to the image file
+     * @param maxDimension Size both sides should fit in, reached by scaling to 1/2, 1/4 or 1/8
+     * @return TextureData containing the image as bytes with metadata
+     * @throws std::runtime_error if file is not a valid image or cannot be read
+     */
+    [[nodiscard]] ImageData loadImagePreview(const std::filesystem::path& filePath, uint32_t maxDimension);
+
     // Helper method for if format is already known
     template<ImageFormat Format>
-    [[nodiscard]] ImageData loadImage(const std::filesystem::path& file_path)
+    [[nodiscard]] ImageData loadImage(const std::filesystem::path& file_path, const ImageLoadOptions& options = {})
     {
         if (!std::filesystem::exists(file_path) || !std::filesystem::is_regular_file(file_path))
         {
             throw std::runtime_error("Path does not exist or is not a regular file");
         }
 
-        return detail::ImageReader<Format>::read(file_path);
+        return detail::ImageReader<Format>::read(file_path, options);
     }
 } // lgl
 
@@ -0,0 +1,73 @@
+//
+// Created by user on 10/17/26.
+//
+
+#ifndef LEARNOPENGL_APP_INDIRECTDRAWBUFFER_H
+#define LEARNOPENGL_APP_INDIRECTDRAWBUFFER_H
+
+#include <cstddef>
+#include <span>
+#include <vector>
+#include <glad/glad.h>
+
+namespace lgl
+{
+    // Layout glMultiDrawElementsIndirect reads its draws in
+    struct DrawElementsIndirectCommand
+    {
+        GLuint count{ 0 };
+        GLuint instanceCount{ 1 };
+        GLuint firstIndex{ 0 }; // In indices, from the start of the bound index buffer
+        GLint baseVertex{ 0 };
+        GLuint baseInstance{ 0 };
+    };
+
+    static_assert(sizeof(DrawElementsIndirectCommand) == 20);
+
+    /**
+     * Draw commands gathered on the CPU and submitted at once.
+     *
+     * With multi-draw indirect the commands are streamed into an indirect buffer and drawn in a single call;
+     * otherwise, on OpenGL 3.3, the same list is looped with glDrawElementsInstancedBaseVertex.
+     * Must only be used on the GL thread.
+     */
+    class IndirectDrawBuffer
+    {
+    public:
+        using handle_type = GLuint;
+
+        IndirectDrawBuffer() = default;
+
+        IndirectDrawBuffer(const IndirectDrawBuffer& other) = delete;
+
+        IndirectDrawBuffer(IndirectDrawBuffer&& other) noexcept;
+
+        IndirectDrawBuffer& operator=(const IndirectDrawBuffer& other) = delete;
+
+        IndirectDrawBuffer& operator=(IndirectDrawBuffer&& other) noexcept;
+
+        ~IndirectDrawBuffer();
+
+        void push(const DrawElementsIndirectCommand& command);
+
+        void clear() noexcept;
+
+        [[nodiscard]] std::span<const DrawElementsIndirectCommand> commands() const noexcept;
+
+        /**
+         * Draws the commands from the bound vertex array and clears them
+         *
+         * @param indexType Type of every index the commands address
+         */
+        void submit(GLenum indexType);
+
+        // Whether submit draws in a single call rather than the OpenGL 3.3 loop
+        [[nodiscard]] static bool isMultiDrawSupported();
+
+    private:
+        std::vector<DrawElementsIndirectCommand> m_commands;
+        handle_type m_bufferObject{ 0 }; // Created on the first multi-draw submission
+    };
+} // lgl
+
+#endif //LEARNOPENGL_APP_INDIRECTDRAWBUFFER_H
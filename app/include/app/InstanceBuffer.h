@@ -0,0 +1,84 @@
+//
+// Created by user on 10/17/26.
+//
+
+#ifndef LEARNOPENGL_APP_INSTANCEBUFFER_H
+#define LEARNOPENGL_APP_INSTANCEBUFFER_H
+
+#include <array>
+#include <cstddef>
+#include <span>
+#include <glad/glad.h>
+#include <glm/mat3x3.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include "app/VertexLayout.h"
+
+namespace lgl
+{
+    // Per-instance inputs of the instanced shaders; the model matrix takes locations 8 to 11,
+    // the normal matrix 12 to 14
+    struct InstanceTransform
+    {
+        glm::mat4 model{ 1.0f };
+        glm::mat3 normalMatrix{ 1.0f };
+
+        [[nodiscard]] static InstanceTransform from(const glm::mat4& model);
+    };
+
+    static_assert(sizeof(InstanceTransform) == 100);
+
+    template<>
+    struct VertexLayout<InstanceTransform>
+    {
+        static constexpr std::array attributes{
+            attribute<glm::vec4>(8, offsetof(InstanceTransform, model)),
+            attribute<glm::vec4>(9, offsetof(InstanceTransform, model) + sizeof(glm::vec4)),
+            attribute<glm::vec4>(10, offsetof(InstanceTransform, model) + 2 * sizeof(glm::vec4)),
+            attribute<glm::vec4>(11, offsetof(InstanceTransform, model) + 3 * sizeof(glm::vec4)),
+            attribute<glm::vec3>(12, offsetof(InstanceTransform, normalMatrix)),
+            attribute<glm::vec3>(13, offsetof(InstanceTransform, normalMatrix) + sizeof(glm::vec3)),
+            attribute<glm::vec3>(14, offsetof(InstanceTransform, normalMatrix) + 2 * sizeof(glm::vec3))
+        };
+    };
+
+    /**
+     * Stream of instance transforms, refilled for every instanced draw.
+     *
+     * Vertex arrays attach to it once; uploads orphan the storage instead of replacing the buffer, so the
+     * attachments stay valid and the driver need not wait for draws still reading the previous transforms.
+     * Must only be used on the GL thread.
+     */
+    class InstanceBuffer
+    {
+    public:
+        using handle_type = GLuint;
+
+        // Holds a single identity transform until the first upload
+        InstanceBuffer();
+
+        InstanceBuffer(const InstanceBuffer& other) = delete;
+
+        InstanceBuffer(InstanceBuffer&& other) noexcept;
+
+        InstanceBuffer& operator=(const InstanceBuffer& other) = delete;
+
+        InstanceBuffer& operator=(InstanceBuffer&& other) noexcept;
+
+        ~InstanceBuffer();
+
+        void upload(std::span<const InstanceTransform> instances);
+
+        // Sets up the instance attributes of the bound vertex array to read from this buffer
+        void attach() const;
+
+        [[nodiscard]] std::size_t size() const noexcept;
+
+    private:
+        handle_type m_bufferObject{ 0 };
+        std::size_t m_size{ 0 };
+    };
+} // lgl
+
+#endif //LEARNOPENGL_APP_INSTANCEBUFFER_H
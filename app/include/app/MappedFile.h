@@ -0,0 +1,52 @@
+//
+// Created by user on 10/17/26.
+//
+
+#ifndef LEARNOPENGL_APP_MAPPEDFILE_H
+#define LEARNOPENGL_APP_MAPPEDFILE_H
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+namespace lgl
+{
+    // Read-only memory mapping of a whole file
+    class MappedFile
+    {
+    public:
+        /**
+         * Maps a file into memory
+         *
+         * @param path Path to the file
+         * @return MappedFile exposing the file contents
+         * @throws std::runtime_error if the file cannot be opened or mapped
+         */
+        [[nodiscard]] static MappedFile open(const std::filesystem::path& path);
+
+        MappedFile(const MappedFile& other) = delete;
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(const MappedFile& other) = delete;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        ~MappedFile();
+
+        [[nodiscard]] std::span<const std::byte> bytes() const noexcept;
+
+        [[nodiscard]] std::size_t size() const noexcept;
+
+    private:
+        MappedFile() = default;
+
+        void unmap() noexcept;
+
+        const std::byte* m_data{ nullptr };
+        std::size_t m_size{ 0 };
+#ifdef _WIN32
+        void* m_fileHandle{ nullptr };
+        void* m_mappingHandle{ nullptr };
+#endif
+    };
+} // lgl
+
+#endif //LEARNOPENGL_APP_MAPPEDFILE_H
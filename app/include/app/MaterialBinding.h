@@ -0,0 +1,47 @@
+//
+// Created by user on 10/17/26.
+//
+
+#ifndef LEARNOPENGL_APP_MATERIALBINDING_H
+#define LEARNOPENGL_APP_MATERIALBINDING_H
+
+#include <span>
+#include <vector>
+#include <glad/glad.h>
+#include "app/ShaderProgram.h"
+#include "app/Texture.h"
+
+namespace lgl
+{
+    /**
+     * Textures of a mesh resolved against one program: each texture's unit and the location of the sampler reading
+     * it, looked up once so binding does no string formatting, uniform lookups or allocations
+     */
+    class MaterialBinding
+    {
+    public:
+        struct Slot
+        {
+            GLint location; // -1 if the program does not use the sampler
+            GLuint unit;
+            GLuint texture;
+        };
+
+        // Assigns the textures consecutive units, in order, each to the next material.<type>s[i] sampler of its type
+        [[nodiscard]] static MaterialBinding build(const ShaderProgram& shaderProgram,
+                                                   std::span<const Texture> textures);
+
+        // Binds every texture to its unit and points its sampler at it; the program must be in use
+        void bind() const noexcept;
+
+        [[nodiscard]] GLuint program() const noexcept;
+
+        [[nodiscard]] std::span<const Slot> slots() const noexcept;
+
+    private:
+        GLuint m_program{ 0 };
+        std::vector<Slot> m_slots;
+    };
+} // lgl
+
+#endif //LEARNOPENGL_APP_MATERIALBINDING_H
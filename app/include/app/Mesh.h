@@ -5,49 +5,53 @@
 #ifndef LEARNOPENGL_APP_MESH_H
 #define LEARNOPENGL_APP_MESH_H
 
+#include <array>
 #include <filesystem>
 #include <format>
+#include <map>
+#include <optional>
+#include <span>
 #include <string_view>
-#include <unordered_map>
 #include <vector>
 #include <assimp/scene.h>
 #include <glad/glad.h>
-#include <glm/vec2.hpp>
-#include <glm/vec3.hpp>
+#include "app/CookedModel.h"
+#include "app/CookedTexture.h"
 #include "app/Image.h"
+#include "app/InstanceBuffer.h"
+#include "app/Frustum.h"
+#include "app/GeometryBuffer.h"
+#include "app/IndirectDrawBuffer.h"
+#include "app/MaterialBinding.h"
+#include "app/Meshlet.h"
+#include "app/MeshOptimization.h"
+#include "app/MeshSimplification.h"
+#include "app/Mipmap.h"
 #include "app/ShaderProgram.h"
+#include "app/TextureCache.h"
+#include "app/Texture.h"
+#include "app/TextureCompression.h"
+#include "app/Vertex.h"
 
 namespace lgl
 {
-    class Model;
-
-    constexpr auto MAX_BONE_INFLUENCE{ 4 };
-
-    struct Vertex
+    // Geometry and material of an imported mesh, processed on the CPU and ready to upload
+    struct MeshData
     {
-        glm::vec3 position;
-        glm::vec3 normal;
-        glm::vec2 textureCoordinates;
-        glm::vec3 tangent;
-        glm::vec3 bitangent;
-        std::array<int, MAX_BONE_INFLUENCE> boneIds;
-        std::array<float, MAX_BONE_INFLUENCE> weights;
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> indices;
+        std::vector<MeshLod> lods;
+        std::vector<TextureReference> textures;
+        bool triangleList{ true }; // False for point, line and mixed meshes, which get no LODs or meshlets
+        // Vertex cache statistics of the whole mesh before optimization and of this part after; triangle lists only
+        std::optional<MeshOptimizationResult> optimization;
     };
 
-    struct Texture
+    // Where meshes keep their geometry on the GPU
+    enum class BufferAllocation
     {
-        enum class Type
-        {
-            DIFFUSE = 0,
-            SPECULAR,
-            NORMAL,
-            HEIGHT,
-            Size
-        };
-
-        GLuint id;
-        Type type;
-        std::filesystem::path path;
+        Separate, // A vertex array, vertex buffer and index buffer per mesh
+        Shared // Ranges of one GeometryBuffer per vertex format, drawn with base vertices from a single vertex array
     };
 
     class Mesh
@@ -63,7 +67,11 @@ namespace lgl
 
         [[nodiscard]] Mesh(vertex_container_type vertices, index_container_type, texture_container_type textures);
 
-        [[nodiscard]] Mesh(const Model& model, const aiMesh* mesh, const aiScene* scene);
+        // Uploads a processed mesh; its textures are loaded unless already resident
+        [[nodiscard]] explicit Mesh(MeshData data);
+
+        // Uploads a cooked mesh straight from its mapping; the geometry is not kept on the CPU
+        [[nodiscard]] explicit Mesh(const CookedMesh& mesh);
 
         Mesh(const Mesh& other) = delete;
 
@@ -75,34 +83,240 @@ namespace lgl
 
         ~Mesh();
 
-        void draw(const ShaderProgram& shaderProgram) const;
+        // Draws one level of detail, the full mesh by default. Leaves the vertex array bound, so meshes sharing one
+        // are drawn without switching it
+        void draw(const ShaderProgram& shaderProgram, std::size_t lod = 0) const;
+
+        /**
+         * Draws one level of detail with the state bound by bindTextures, setGeometryUniforms and the vertex array;
+         * lets a caller that sorted its draws skip binding what did not change
+         */
+        void drawBound(std::size_t lod = 0) const;
+
+        // Binds the textures to consecutive units and points the material samplers at them. The first bind with a
+        // program resolves the samplers; later ones neither allocate nor look up uniforms
+        void bindTextures(const ShaderProgram& shaderProgram) const;
+
+        // Sets the uniforms decoding packed positions; nothing for the full vertex format
+        void setGeometryUniforms(const ShaderProgram& shaderProgram) const;
+
+        // Own vertex array, or the shared geometry buffer's
+        [[nodiscard]] handle_type vertexArray() const;
+
+        // Meshes with the same textures in the same order have the same material
+        [[nodiscard]] uint32_t materialId() const noexcept;
+
+        /**
+         * Draws copies of one level of detail, transformed by the first instanceCount transforms in instanceBuffer().
+         * Needs a shader reading the instance attributes, see shaders/backpack_instanced.vert
+         */
+        void drawInstanced(const ShaderProgram& shaderProgram, std::size_t instanceCount, std::size_t lod = 0) const;
+
+        /**
+         * Draws the full mesh without the meshlets outside the frustum or facing away from the camera.
+         * Meshes that are no triangle list have no meshlets and are drawn whole
+         *
+         * @param frustum View volume in the mesh's space
+         * @param cameraPosition Camera in the mesh's space
+         * @return Triangles submitted; like draw, leaves the vertex array bound
+         */
+        std::size_t drawCulled(const ShaderProgram& shaderProgram,
+                               const Frustum& frustum,
+                               const glm::vec3& cameraPosition) const;
+
+        /**
+         * Draws commands gathered from this mesh and others sharing its draw state with one submission
+         *
+         * @param commands Cleared once drawn; like draw, leaves the vertex array bound
+         */
+        void drawIndirect(const ShaderProgram& shaderProgram, IndirectDrawBuffer& commands) const;
+
+        // Command drawing one level of detail, for drawIndirect
+        [[nodiscard]] DrawElementsIndirectCommand drawCommand(std::size_t lod = 0) const noexcept;
+
+        /**
+         * Same meshlet culling as drawCulled, gathering the runs of visible meshlets as commands instead of drawing
+         *
+         * @return Triangles the commands draw
+         */
+        std::size_t pushCulledDrawCommands(const Frustum& frustum,
+                                           const glm::vec3& cameraPosition,
+                                           IndirectDrawBuffer& commands) const;
+
+        // Whether draw commands of the other mesh may be submitted through this one: same vertex array, index type,
+        // textures and per-mesh uniforms
+        [[nodiscard]] bool sharesDrawState(const Mesh& other) const noexcept;
+
+        // Levels of detail sharing the vertex buffer, the full mesh first
+        [[nodiscard]] std::span<const MeshLod> lods() const noexcept;
+
+        [[nodiscard]] const BoundingSphere& bounds() const noexcept;
+
+        // GL_UNSIGNED_SHORT when every vertex is addressable with 16 bits, GL_UNSIGNED_INT otherwise
+        [[nodiscard]] GLenum indexType() const noexcept;
+
+        // Bytes of GPU index memory, every LOD included
+        [[nodiscard]] std::size_t indexBufferSize() const noexcept;
+
+        // Geometry and textures to persist in a CookedModel; empty geometry for meshes loaded from one
+        [[nodiscard]] CookedMesh cookedMesh() const;
+
+        /**
+         * CPU part of importing a mesh: converts the vertices, flattens the faces, optimizes triangle lists and builds
+         * their LOD chain. Touches no GL state, so meshes can be processed in parallel on worker threads.
+         * Triangle lists with more vertices than 16-bit indices address are split where that saves memory
+         *
+         * @param directory Directory the material's texture paths are relative to
+         * @return The mesh, or its parts in draw order
+         */
+        [[nodiscard]] static std::vector<MeshData> process(const aiMesh* mesh,
+                                              const aiScene* scene,
+                                              const std::filesystem::path& directory);
+
+        // Textures of the supported types a material references, in binding order
+        [[nodiscard]] static std::vector<TextureReference> materialTextures(const aiMaterial* material,
+                                                                            const std::filesystem::path& directory);
+
+        [[nodiscard]] static std::filesystem::path resolveTexturePath(const std::filesystem::path& directory,
+                                                                      const aiString& textureFilename);
+
+        [[nodiscard]] static bool isTextureCached(const TextureReference& texture);
+
+        // CPU-only part of texture loading, served from the cooked texture cache when possible;
+        // safe to call from worker threads
+        [[nodiscard]] static CookedTexture decodeTexture(const std::filesystem::path& path, Texture::Type type);
+
+        // Creates the GL texture from a cooked mip chain and caches it unreferenced; must run on the GL thread.
+        // Content already resident under another path is shared instead of uploaded again.
+        // Blocks in a format the driver lacks are decompressed before the upload
+        static void uploadTexture(const TextureReference& reference, const CookedTexture& texture);
+
+        // Block format textures of a type are cooked to; std::nullopt (the default) picks one from the pixel
+        // format, CompressedFormat::None keeps them uncompressed. Not synchronized; set before loading models
+        static void setCompressedFormat(Texture::Type type, std::optional<CompressedFormat> format);
+
+        [[nodiscard]] static std::optional<CompressedFormat> compressedFormat(Texture::Type type);
+
+        // Textures shared by all meshes; each mesh holds a reference to the textures it draws with
+        [[nodiscard]] static TextureCache& textureCache() noexcept;
+
+        // Layout meshes created afterward upload their vertices in. Packed formats drop the bone data and
+        // need a vertex shader that decodes them, see shaders/backpack_packed.vert
+        static void setVertexFormat(VertexFormat format) noexcept;
+
+        [[nodiscard]] static VertexFormat vertexFormat() noexcept;
+
+        // Allocation mode of meshes created afterward. Not synchronized; set before loading models
+        static void setBufferAllocation(BufferAllocation allocation) noexcept;
+
+        [[nodiscard]] static BufferAllocation bufferAllocation() noexcept;
+
+        // Transforms of instanced draws, attached to every mesh's vertex array; created on first use
+        [[nodiscard]] static InstanceBuffer& instanceBuffer();
+
+        // Buffer holding every shared mesh of a vertex format, created on first use; must be used on the GL thread
+        [[nodiscard]] static GeometryBuffer& sharedGeometryBuffer(VertexFormat format);
 
     private:
         vertex_container_type m_vertices;
         index_container_type m_indices;
         texture_container_type m_textures;
-
+        std::vector<MeshLod> m_lods;
+        BoundingSphere m_bounds{};
+        bool m_triangleList{ true };
+        std::vector<Meshlet> m_meshlets; // Of the full mesh; empty unless it is a triangle list
+        MeshletCuller m_meshletCuller;
+        // Scratch for drawCulled, kept to avoid allocating every frame
+        mutable std::vector<uint8_t> m_visibleMeshlets;
+        mutable std::vector<GLsizei> m_drawCounts;
+        mutable std::vector<std::size_t> m_drawFirstIndices;
+        mutable std::vector<const GLvoid*> m_drawOffsets;
+        mutable std::vector<GLint> m_drawBaseVertices;
+        // Per program the mesh was drawn with, by handle; programs must not be replaced by others under the same one
+        mutable std::vector<MaterialBinding> m_materialBindings;
+
+        // Own buffers, unless the geometry lives in a shared GeometryBuffer
         handle_type m_vertexArrayObject{ 0 };
         handle_type m_vertexBufferObject{ 0 };
         handle_type m_elementBufferObject{ 0 };
+        std::optional<GeometryBuffer::Allocation> m_allocation;
+        GLenum m_indexType{ GL_UNSIGNED_INT };
+        std::size_t m_indexCount{ 0 };
+        uint32_t m_materialId{ 0 };
+
+        VertexFormat m_vertexFormat{ VertexFormat::Full };
+        Dequantization m_dequantization{};
+
+        static TextureCache s_textureCache;
+        static VertexFormat s_vertexFormat;
+        static BufferAllocation s_bufferAllocation;
+        static std::array<std::optional<GeometryBuffer>, 3> s_geometryBuffers; // Per VertexFormat
+        static std::optional<InstanceBuffer> s_instanceBuffer;
+        static std::map<std::vector<GLuint>, uint32_t> s_materialIds; // By texture handles, never removed
+        static std::array<std::optional<CompressedFormat>, static_cast<std::size_t>(Texture::Type::Size)>
+        s_compressedFormats;
+
+        void setupMesh(std::span<const vertex_type> vertices, std::span<const index_type> indices);
+
+        // Binds textures, per-mesh uniforms and the vertex array for a draw
+        void bind(const ShaderProgram& shaderProgram) const;
+
+        // Built on the first draw with the program
+        [[nodiscard]] const MaterialBinding& materialBinding(const ShaderProgram& shaderProgram) const;
+
+        // Bytes per index on the GPU
+        [[nodiscard]] std::size_t indexSize() const noexcept;
 
-        const Model* m_parent{ nullptr };
-        static std::unordered_map<std::filesystem::path, handle_type> s_textureCache;
+        // Byte offset of an index within the bound index buffer
+        [[nodiscard]] const GLvoid* indexOffset(std::size_t index) const noexcept;
 
-        void setupMesh();
+        // Position of an index within the bound index buffer, in indices
+        [[nodiscard]] std::size_t bufferIndex(std::size_t index) const noexcept;
+
+        // Gathers the runs of visible meshlets into m_drawCounts and m_drawFirstIndices; returns their triangles.
+        // Meshes that are no triangle list have no meshlets and are gathered whole
+        std::size_t cullMeshlets(const Frustum& frustum, const glm::vec3& cameraPosition) const;
+
+        // Added to every index by draws; non-zero for meshes in a shared buffer
+        [[nodiscard]] GLint baseVertex() const noexcept;
+
+        // Deletes the own buffers or returns the shared allocation
+        void releaseBuffers() noexcept;
+
+        // Fills the vertex buffer and sets up the attributes from VertexLayout<VertexT>
+        template<typename VertexT>
+        void uploadVertices(std::span<const VertexT> vertices) const;
 
         static constexpr auto elementSizeOf(std::ranges::sized_range auto&& range) noexcept;
 
         static constexpr auto sizeOf(std::ranges::sized_range auto&& range) noexcept;
 
-        [[nodiscard]] std::vector<texture_type> loadMaterialTextures(const aiMaterial* material,
-                                                                     aiTextureType assimpTextureType) const;
+        // Acquires the textures from the cache, loading those that are not resident
+        void loadTextures(std::span<const TextureReference> textures);
 
-        [[nodiscard]] static handle_type loadTextureFromFile(const std::filesystem::path& path);
+        [[nodiscard]] static handle_type loadTextureFromFile(const std::filesystem::path& path, Texture::Type type);
+
+        void releaseTextures() noexcept;
 
         static void clearTextureCache();
     };
 
+    template<typename VertexT>
+    void Mesh::uploadVertices(const std::span<const VertexT> vertices) const
+    {
+        if (m_allocation.has_value())
+        {
+            sharedGeometryBuffer(m_vertexFormat).uploadVertices(*m_allocation, vertices);
+            return;
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, m_vertexBufferObject);
+        glBufferData(GL_ARRAY_BUFFER,
+                     static_cast<GLsizeiptr>(sizeOf(vertices)),
+                     vertices.data(),
+                     GL_STATIC_DRAW);
+        enableVertexAttributes<VertexT>();
+    }
+
     constexpr auto Mesh::elementSizeOf(std::ranges::sized_range auto&& range) noexcept
     {
         return sizeof(std::ranges::range_value_t<decltype(range)>);
@@ -113,6 +327,14 @@ namespace lgl
         return std::ranges::size(range) * elementSizeOf(range);
     }
 
+    // Assimp texture types a Mesh loads, in the order they are bound
+    constexpr std::array supportedTextureTypes{
+        aiTextureType_DIFFUSE,
+        aiTextureType_SPECULAR,
+        aiTextureType_NORMALS,
+        aiTextureType_HEIGHT
+    };
+
     constexpr Texture::Type from(const aiTextureType assimpTextureType)
     {
         switch (assimpTextureType)
@@ -130,6 +352,23 @@ namespace lgl
         }
     }
 
+    // Mip filtering per texture role: color maps are filtered in linear light, normal maps are renormalized
+    constexpr MipmapOptions mipmapOptions(const Texture::Type type)
+    {
+        switch (type)
+        {
+            case Texture::Type::DIFFUSE:
+                return { .filter = MipmapOptions::Filter::Kaiser, .colorSpace = MipmapOptions::ColorSpace::SRGB };
+            case Texture::Type::SPECULAR:
+            case Texture::Type::HEIGHT:
+                return { .filter = MipmapOptions::Filter::Kaiser };
+            case Texture::Type::NORMAL:
+                return { .filter = MipmapOptions::Filter::Kaiser, .normalMap = true };
+            default:
+                throw std::runtime_error("Unknown texture type");
+        }
+    }
+
     constexpr auto gl_cast(const PixelFormat pixelFormat)
     {
         switch (pixelFormat)
@@ -148,37 +387,4 @@ namespace lgl
     }
 } // lgl
 
-template<>
-struct std::formatter<lgl::Texture::Type> : std::formatter<std::string_view>
-{
-    constexpr auto parse(std::format_parse_context& ctx)
-    {
-        return std::formatter<std::string_view>::parse(ctx);
-    }
-
-    template<typename FormatContext>
-    auto format(const lgl::Texture::Type type, FormatContext& ctx) const
-    {
-        std::string_view name{};
-        switch (type)
-        {
-            case lgl::Texture::Type::DIFFUSE:
-                name = "diffuse";
-                break;
-            case lgl::Texture::Type::SPECULAR:
-                name = "specular";
-                break;
-            case lgl::Texture::Type::NORMAL:
-                name = "normal";
-                break;
-            case lgl::Texture::Type::HEIGHT:
-                name = "height";
-                break;
-            default:
-                throw std::runtime_error{ "Unknown texture type" };
-        }
-        return std::formatter<std::string_view>::format(name, ctx);
-    }
-};
-
 #endif //LEARNOPENGL_APP_MESH_H
@@ -0,0 +1,87 @@
+//
+// Created by user on 10/17/26.
+//
+
+#ifndef LEARNOPENGL_APP_MESHOPTIMIZATION_H
+#define LEARNOPENGL_APP_MESHOPTIMIZATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "app/Vertex.h"
+
+namespace lgl
+{
+    // Post-transform cache size the optimizations target; a conservative FIFO size for current GPUs
+    constexpr std::size_t DEFAULT_VERTEX_CACHE_SIZE{ 16 };
+
+    // Vertex shader efficiency of an index buffer, from a simulated FIFO post-transform cache
+    struct VertexCacheStatistics
+    {
+        float acmr{ 0.0f }; // Average cache miss ratio: transformed vertices per triangle, 0.5 at best
+        float atvr{ 0.0f }; // Average transformed vertex ratio: transformed vertices per vertex, 1 at best
+    };
+
+    // Vertices that 16-bit indices can address
+    constexpr std::size_t MAX_SHORT_INDEX_VERTICES{ 65536 };
+
+    struct MeshOptimizationResult
+    {
+        std::size_t vertexCountBefore{ 0 };
+        std::size_t vertexCountAfter{ 0 };
+        VertexCacheStatistics before{};
+        VertexCacheStatistics after{};
+    };
+
+    [[nodiscard]] VertexCacheStatistics analyzeVertexCache(std::span<const uint32_t> indices,
+                                                           std::size_t vertexCount,
+                                                           std::size_t cacheSize = DEFAULT_VERTEX_CACHE_SIZE);
+
+    // Merges bitwise identical vertices and rewrites the indices to match
+    void weldVertices(std::vector<Vertex>& vertices, std::span<uint32_t> indices);
+
+    /**
+     * Reorders triangles for the post-transform cache (Tipsify, Sander et al. 2007)
+     *
+     * @return First triangle of every hard cluster: runs after which the cache starts cold
+     */
+    [[nodiscard]] std::vector<std::size_t> optimizeVertexCache(std::span<uint32_t> indices,
+                                                               std::size_t vertexCount,
+                                                               std::size_t cacheSize = DEFAULT_VERTEX_CACHE_SIZE);
+
+    /**
+     * Reorders the clusters of a cache-optimized index buffer so triangles likely to occlude others come first.
+     * Clusters are split further where that keeps the ACMR within threshold times the cluster's own
+     *
+     * @param clusters Result of optimizeVertexCache for these indices
+     */
+    void optimizeOverdraw(std::span<uint32_t> indices,
+                          std::span<const Vertex> vertices,
+                          std::span<const std::size_t> clusters,
+                          float threshold = 1.05f,
+                          std::size_t cacheSize = DEFAULT_VERTEX_CACHE_SIZE);
+
+    // Stores vertices in the order the indices first use them and drops unused ones
+    void optimizeVertexFetch(std::vector<Vertex>& vertices, std::span<uint32_t> indices);
+
+    // All of the above, in order, on a triangle list
+    MeshOptimizationResult optimizeMesh(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+
+    struct MeshPart
+    {
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> indices;
+    };
+
+    /**
+     * Splits a triangle list into consecutive runs of triangles using at most maxVertexCount vertices each.
+     * Vertices on the seams are duplicated; each part stores its vertices in the order its indices first use them,
+     * so an optimized index buffer stays optimized
+     */
+    [[nodiscard]] std::vector<MeshPart> splitMesh(std::span<const Vertex> vertices,
+                                                  std::span<const uint32_t> indices,
+                                                  std::size_t maxVertexCount);
+} // lgl
+
+#endif //LEARNOPENGL_APP_MESHOPTIMIZATION_H
@@ -0,0 +1,60 @@
+//
+// Created by user on 10/17/26.
+//
+
+#ifndef LEARNOPENGL_APP_MESHSIMPLIFICATION_H
+#define LEARNOPENGL_APP_MESHSIMPLIFICATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "app/Vertex.h"
+
+namespace lgl
+{
+    // Index range of one level of detail within a mesh's index buffer
+    struct MeshLod
+    {
+        std::size_t firstIndex{ 0 };
+        std::size_t indexCount{ 0 };
+        float error{ 0.0f }; // Largest distance the surface moved from the full mesh, in model units
+    };
+
+    struct LodOptions
+    {
+        std::size_t maxLevels{ 6 }; // Including the full mesh
+        float reduction{ 0.5f }; // Triangle count of each level relative to the previous one
+        std::size_t minTriangleCount{ 64 };
+    };
+
+    struct SimplifiedMesh
+    {
+        std::vector<uint32_t> indices;
+        float error{ 0.0f };
+    };
+
+    /**
+     * Quadric error metric simplification (Garland and Heckbert 1997) by half-edge collapses.
+     *
+     * Vertices only ever collapse onto existing ones, so the result indexes the same vertex buffer.
+     * Border, non-manifold and attribute seam vertices stay in place, which keeps silhouettes and texture
+     * coordinates intact at the cost of stopping early on heavily seamed meshes.
+     *
+     * @param targetIndexCount Collapses stop once the result has at most this many indices
+     */
+    [[nodiscard]] SimplifiedMesh simplify(std::span<const Vertex> vertices,
+                                          std::span<const uint32_t> indices,
+                                          std::size_t targetIndexCount);
+
+    /**
+     * Appends coarser levels of detail of indices[0, size) to indices, each cache-optimized
+     *
+     * @return Every level, the full mesh first; levels that would barely reduce the previous one are skipped
+     */
+    [[nodiscard]] std::vector<MeshLod> buildLodChain(std::span<const Vertex> vertices,
+                                                     std::vector<uint32_t>& indices,
+                                                     const LodOptions& options = {});
+} // lgl
+
+#endif //LEARNOPENGL_APP_MESHSIMPLIFICATION_H
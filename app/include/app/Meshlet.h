@@ -0,0 +1,84 @@
+//
+// Created by user on 10/17/26.
+//
+
+#ifndef LEARNOPENGL_APP_MESHLET_H
+#define LEARNOPENGL_APP_MESHLET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include <glm/vec3.hpp>
+#include "app/Frustum.h"
+#include "app/Vertex.h"
+
+namespace lgl
+{
+    constexpr std::size_t MAX_MESHLET_VERTICES{ 64 };
+    constexpr std::size_t MAX_MESHLET_TRIANGLES{ 124 };
+
+    // Contiguous run of a mesh's triangles, small enough to cull as one
+    struct Meshlet
+    {
+        std::size_t firstIndex{ 0 };
+        std::size_t indexCount{ 0 };
+    };
+
+    struct MeshletBounds
+    {
+        BoundingSphere sphere{};
+        glm::vec3 coneAxis{ 0.0f }; // Average facing of the triangles
+        float coneCutoff{ 1.0f }; // Sine of the cone's half angle; 1 when the meshlet faces every way
+    };
+
+    /**
+     * Splits triangles into meshlets of at most MAX_MESHLET_VERTICES vertices and MAX_MESHLET_TRIANGLES triangles,
+     * keeping their order, so a cache-optimized index buffer gives spatially coherent meshlets
+     *
+     * @param indices Triangle list; its size must be a multiple of 3
+     * @param firstIndex Offset of indices within the mesh's index buffer, added to every meshlet
+     */
+    [[nodiscard]] std::vector<Meshlet> buildMeshlets(std::span<const uint32_t> indices,
+                                                     std::size_t firstIndex,
+                                                     std::size_t vertexCount);
+
+    // Bounds of a meshlet's triangle list
+    [[nodiscard]] MeshletBounds computeMeshletBounds(std::span<const Vertex> vertices,
+                                                     std::span<const uint32_t> indices);
+
+    /**
+     * Frustum and back-face culling of meshlets by their bounds.
+     * Bounds are kept as structure of arrays, so the per-meshlet tests run branch-free and vectorize
+     */
+    class MeshletCuller
+    {
+    public:
+        MeshletCuller() = default;
+
+        explicit MeshletCuller(std::span<const MeshletBounds> bounds);
+
+        /**
+         * Flags the meshlets that may be visible: inside the frustum and not entirely facing away from the camera
+         *
+         * @param frustum View volume in the mesh's space
+         * @param cameraPosition Camera in the mesh's space
+         * @param visible Output, one entry per meshlet
+         */
+        void cull(const Frustum& frustum, const glm::vec3& cameraPosition, std::span<uint8_t> visible) const;
+
+        [[nodiscard]] std::size_t size() const noexcept;
+
+    private:
+        std::vector<float> m_centerX;
+        std::vector<float> m_centerY;
+        std::vector<float> m_centerZ;
+        std::vector<float> m_radius;
+        std::vector<float> m_axisX;
+        std::vector<float> m_axisY;
+        std::vector<float> m_axisZ;
+        std::vector<float> m_cutoff;
+    };
+} // lgl
+
+#endif //LEARNOPENGL_APP_MESHLET_H
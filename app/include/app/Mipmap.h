@@ -0,0 +1,67 @@
+//
+// Created by user on 10/17/26.
+//
+
+#ifndef LEARNOPENGL_APP_MIPMAP_H
+#define LEARNOPENGL_APP_MIPMAP_H
+
+#include <bit>
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "app/Image.h"
+
+namespace lgl
+{
+    struct MipmapOptions
+    {
+        enum class Filter
+        {
+            Box, // Area average of the source footprint
+            Kaiser // Kaiser-windowed sinc, sharper minification
+        };
+
+        enum class ColorSpace
+        {
+            Linear,
+            SRGB // Color channels are linearized before filtering and re-encoded afterward; alpha stays linear
+        };
+
+        Filter filter{ Filter::Box };
+        ColorSpace colorSpace{ ColorSpace::Linear };
+        bool normalMap{ false }; // Renormalize the XYZ channels of every filtered texel; implies linear color space
+
+        [[nodiscard]] constexpr bool operator==(const MipmapOptions& other) const noexcept = default;
+    };
+
+    // View of one level of a texture whose pixels or blocks are owned elsewhere
+    struct MipLevel
+    {
+        uint32_t width{ 0 };
+        uint32_t height{ 0 };
+        std::span<const std::byte> data;
+    };
+
+    // Number of levels in a full mip chain down to 1x1
+    [[nodiscard]] constexpr uint32_t mipLevelCount(const uint32_t width, const uint32_t height) noexcept
+    {
+        return std::bit_width(std::max({ width, height, 1u }));
+    }
+
+    // Halves an image with the filter selected in options
+    [[nodiscard]] ImageData downsample(const ImageData& image, const MipmapOptions& options = {});
+
+    /**
+     * Builds every level of the mip chain on the CPU, starting with the image itself.
+     * Levels are filtered from a floating-point copy of the previous level, so quantization error does not
+     * accumulate down the chain.
+     *
+     * @param image 8-bit source image, level 0 of the chain
+     * @param options Filter, color space and normal map handling
+     * @return All levels down to 1x1, in the pixel format and row order of the source image
+     */
+    [[nodiscard]] std::vector<ImageData> generateMipChain(ImageData image, const MipmapOptions& options = {});
+} // lgl
+
+#endif //LEARNOPENGL_APP_MIPMAP_H
@@ -5,22 +5,92 @@
 #ifndef LEARNOPENGL_APP_MODEL_H
 #define LEARNOPENGL_APP_MODEL_H
 
+#include <chrono>
+#include <optional>
+#include <span>
 #include <vector>
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
+#include <glm/mat4x4.hpp>
 
+#include "app/CookedModel.h"
 #include "app/Mesh.h"
+#include "app/PerspectiveCamera.h"
+#include "app/RenderQueue.h"
 #include "app/ShaderProgram.h"
 
 namespace lgl
 {
+    // How models hand their meshes to the driver
+    enum class DrawSubmission
+    {
+        Direct, // A draw call per mesh
+        Indirect // Draw commands gathered per group of meshes sharing their draw state, submitted once per group
+    };
+
     class Model
     {
     public:
+        // Wall-clock timings gathered while loading
+        struct LoadStatistics
+        {
+            bool cookedModelHit{ false }; // Geometry mapped from the cooked cache instead of imported
+            std::size_t shortIndexMeshCount{ 0 }; // Meshes drawn with 16-bit indices
+            std::size_t savedIndexBytes{ 0 }; // Index memory 16-bit indices save over 32-bit ones
+            std::size_t splitMeshCount{ 0 }; // Source meshes split to fit 16-bit indices; on import only
+            std::size_t textureCount{ 0 };
+            std::size_t cookedTextureHits{ 0 }; // Textures mapped from the cooked cache instead of decoded
+            std::size_t deduplicatedTextureBytes{ 0 }; // Texture memory saved by sharing identical images
+            std::chrono::duration<double, std::milli> totalTime{};
+            std::chrono::duration<double, std::milli> textureDecodeTime{};
+            std::chrono::duration<double, std::milli> textureUploadTime{};
+        };
+
         [[nodiscard]] static Model load(const std::filesystem::path& path);
 
+        // Draws every mesh at full detail
         void draw(const ShaderProgram& shaderProgram) const;
 
+        /**
+         * Draws every mesh at the coarsest level of detail whose error stays below a pixel on screen.
+         * Levels only get coarser once their error is well below that, so meshes near a switch do not flicker
+         *
+         * @param modelMatrix Transform the shader draws the model with
+         * @param viewportHeight Height of the viewport in pixels
+         */
+        void draw(const ShaderProgram& shaderProgram,
+                  const PerspectiveCamera& camera,
+                  const glm::mat4& modelMatrix,
+                  float viewportHeight) const;
+
+        /**
+         * Same level of detail selection and culling as draw, meshlets included, submitting the visible meshes to a
+         * queue that draws them later in state order with indirect draw commands
+         *
+         * @param modelMatrix Set by the queue as the model and normalMatrix uniforms
+         */
+        void enqueue(RenderQueue& queue,
+                     const ShaderProgram& shaderProgram,
+                     const PerspectiveCamera& camera,
+                     const glm::mat4& modelMatrix,
+                     float viewportHeight) const;
+
+        /**
+         * Draws a copy of the model per transform at full detail, with one instanced draw per mesh
+         *
+         * @param modelMatrices Transform of each copy; the shader reads them from the instance attributes,
+         *                      see shaders/backpack_instanced.vert
+         */
+        void drawInstanced(const ShaderProgram& shaderProgram, std::span<const glm::mat4> modelMatrices) const;
+
+        // Triangles submitted by the last draw
+        [[nodiscard]] std::size_t drawnTriangleCount() const noexcept;
+
+        // Submission mode of both draw overloads; drawInstanced is unaffected
+        static void setDrawSubmission(DrawSubmission submission) noexcept;
+
+        [[nodiscard]] static DrawSubmission drawSubmission() noexcept;
+
         Model(const Model& other) = delete;
 
         Model(Model&& other) noexcept;
@@ -31,13 +101,69 @@ namespace lgl
 
         [[nodiscard]] const std::filesystem::path& directory() const noexcept;
 
+        // Hierarchy of the source scene, parents before their children
+        [[nodiscard]] std::span<const ModelNode> nodes() const noexcept;
+
+        [[nodiscard]] const LoadStatistics& statistics() const noexcept;
+
     private:
+        // Inputs of the level of detail selection and culling, shared by every mesh of a draw
+        struct DrawView
+        {
+            Frustum frustum; // In model space
+            glm::vec3 cameraPosition; // In model space
+            glm::vec3 eye; // Camera in world space
+            glm::mat4 modelMatrix;
+            float scale; // Largest scale along the model's axes
+            float projectionScale; // Pixels one model unit spans at distance 1
+            float nearPlane;
+        };
+
         explicit Model(std::filesystem::path directory);
 
-        void processNodes(const aiNode* node, const aiScene* scene);
+        [[nodiscard]] static DrawView drawView(const PerspectiveCamera& camera,
+                                               const glm::mat4& modelMatrix,
+                                               float viewportHeight);
+
+        /**
+         * Updates the mesh's level of detail in m_selectedLods
+         *
+         * @return Distance from the camera to the mesh's bounding sphere, std::nullopt if outside the frustum
+         */
+        std::optional<float> selectVisibleLod(std::size_t index, const DrawView& view) const;
+
+        // Imports the source with Assimp, then stores the result as a cooked model
+        void importScene(const std::filesystem::path& path);
+
+        // Every texture the scene's materials reference, resolved against the model's directory
+        [[nodiscard]] std::vector<TextureReference> collectTextures(const aiScene* scene) const;
+
+        // Decodes the textures that are not resident on the shared thread pool and uploads them as they finish
+        void loadTextures(std::span<const TextureReference> textures);
+
+        // Records the hierarchy and the meshes of every node, in the order they are uploaded
+        void processNodes(const aiNode* node,
+                          const aiScene* scene,
+                          int32_t parent,
+                          std::vector<const aiMesh*>& meshes);
+
+        // Sorts the meshes into the groups indirect draws are submitted by
+        void groupMeshes();
 
         std::vector<Mesh> m_meshes;
+        std::vector<ModelNode> m_nodes;
+        std::vector<std::vector<std::size_t>> m_drawGroups; // Indices of meshes sharing their draw state
         std::filesystem::path m_directory;
+        LoadStatistics m_statistics;
+        // Per mesh, remembered between frames for the hysteresis
+        mutable std::vector<std::size_t> m_selectedLods;
+        mutable std::size_t m_drawnTriangleCount{ 0 };
+        // Scratch for drawInstanced, kept to avoid allocating every frame
+        mutable std::vector<InstanceTransform> m_instanceTransforms;
+        // Commands of the group being drawn in indirect submission
+        mutable IndirectDrawBuffer m_drawCommands;
+
+        static DrawSubmission s_drawSubmission;
     };
 } // lgl
 
@@ -0,0 +1,154 @@
+//
+// Created by user on 10/17/26.
+//
+
+#ifndef LEARNOPENGL_APP_RENDERQUEUE_H
+#define LEARNOPENGL_APP_RENDERQUEUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include "app/IndirectDrawBuffer.h"
+
+namespace lgl
+{
+    struct Frustum;
+    class Mesh;
+    class ShaderProgram;
+
+    // Passes are drawn in order; opaque submissions front to back, transparent ones back to front
+    enum class RenderPass : uint8_t
+    {
+        Opaque = 0,
+        Transparent
+    };
+
+    /**
+     * Packs a sort key; most significant first, pass (4 bits), program (12), material (16), vertex array (12) and
+     * depth (20). Transparent passes move the depth, inverted, right after the pass. Identifiers wider than their
+     * field only group less tightly, since state changes are detected on the identifiers themselves
+     *
+     * @param depth Non-negative distance from the camera
+     */
+    [[nodiscard]] uint64_t renderKey(RenderPass pass,
+                                     uint32_t program,
+                                     uint32_t material,
+                                     uint32_t vertexArray,
+                                     float depth) noexcept;
+
+    struct SortEntry
+    {
+        uint64_t key;
+        uint32_t index;
+    };
+
+    // Stable LSD radix sort by key, 8 bits a pass; passes where every key has the same digit are skipped
+    void radixSort(std::vector<SortEntry>& entries, std::vector<SortEntry>& scratch);
+
+    /**
+     * Mesh draws collected over a frame and submitted in state order: every program is used once, every material
+     * bound once per program and vertex arrays switched as rarely as the order allows.
+     * Each submission is a range of draw commands; consecutive submissions sharing their draw state and transform
+     * are drawn with one IndirectDrawBuffer submission.
+     * Scene uniforms must be set on the programs before flush; the queue only sets the model and normalMatrix
+     * uniforms of each submission's transform. Must only be used on the GL thread.
+     */
+    class RenderQueue
+    {
+    public:
+        // State changes of the last flush, and how many more the submission order would have needed
+        struct Statistics
+        {
+            std::size_t submissionCount{ 0 };
+            std::size_t commandCount{ 0 }; // A level of detail or run of visible meshlets each
+            std::size_t indirectSubmissions{ 0 }; // Single calls where multi-draw indirect is supported
+            std::size_t programChanges{ 0 };
+            std::size_t materialChanges{ 0 };
+            std::size_t vertexArrayChanges{ 0 };
+            std::size_t programChangesAvoided{ 0 };
+            std::size_t materialChangesAvoided{ 0 };
+            std::size_t vertexArrayChangesAvoided{ 0 };
+        };
+
+        // Adds a model matrix for submissions to refer to; valid until the next flush
+        [[nodiscard]] uint32_t pushTransform(const glm::mat4& modelMatrix);
+
+        /**
+         * Queues a draw of one level of detail. The mesh and program must outlive the next flush
+         *
+         * @param transform Index returned by pushTransform
+         * @param depth Distance from the camera
+         */
+        void submit(RenderPass pass,
+                    const ShaderProgram& shaderProgram,
+                    const Mesh& mesh,
+                    std::size_t lod,
+                    uint32_t transform,
+                    float depth);
+
+        /**
+         * Queues the full mesh without the meshlets outside the frustum or facing away from the camera, see
+         * Mesh::pushCulledDrawCommands
+         *
+         * @param frustum View volume in the mesh's space
+         * @param cameraPosition Camera in the mesh's space
+         * @return Triangles the queued commands draw
+         */
+        std::size_t submitCulled(RenderPass pass,
+                                 const ShaderProgram& shaderProgram,
+                                 const Mesh& mesh,
+                                 const Frustum& frustum,
+                                 const glm::vec3& cameraPosition,
+                                 uint32_t transform,
+                                 float depth);
+
+        // Sorts and draws everything submitted since the last flush, then clears it
+        void flush();
+
+        [[nodiscard]] const Statistics& statistics() const noexcept;
+
+    private:
+        struct Submission
+        {
+            const ShaderProgram* program;
+            const Mesh* mesh;
+            uint32_t firstCommand; // In m_commands
+            uint32_t commandCount;
+            uint32_t transform;
+        };
+
+        struct StateChanges
+        {
+            std::size_t program{ 0 };
+            std::size_t material{ 0 };
+            std::size_t vertexArray{ 0 };
+        };
+
+        // State changes drawing the submissions in the order given would take
+        [[nodiscard]] StateChanges countStateChanges(std::span<const SortEntry> order) const;
+
+        // Adds a submission of the commands pushed to m_commands since firstCommand
+        void addSubmission(RenderPass pass,
+                           const ShaderProgram& shaderProgram,
+                           const Mesh& mesh,
+                           std::size_t firstCommand,
+                           uint32_t transform,
+                           float depth);
+
+        // Sets the state that changed since the previous submission
+        void bind(const Submission& submission, const Submission* previous) const;
+
+        std::vector<Submission> m_submissions;
+        IndirectDrawBuffer m_commands; // Of every submission, in submission order; never submitted itself
+        IndirectDrawBuffer m_batch; // Commands of the submissions drawn with the current state
+        std::vector<glm::mat4> m_transforms;
+        std::vector<SortEntry> m_order;
+        std::vector<SortEntry> m_scratch; // Kept to avoid allocating every frame
+        Statistics m_statistics{};
+    };
+} // lgl
+
+#endif //LEARNOPENGL_APP_RENDERQUEUE_H
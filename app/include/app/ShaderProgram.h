@@ -5,17 +5,63 @@
 #ifndef LEARNOPENGL_APP_SHADERPROGRAM_H
 #define LEARNOPENGL_APP_SHADERPROGRAM_H
 
+#include <cstdint>
 #include <filesystem>
+#include <functional>
 #include <print>
+#include <stdexcept>
+#include <string>
 #include <string_view>
+#include <type_traits>
+#include <unordered_map>
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include "app/Shader.h"
+#include "app/UniformId.h"
 
 namespace lgl
 {
     class Shader;
 
+    // Location of a uniform of type T in one program, resolved once; see ShaderProgram::uniformHandle
+    template<typename T>
+    struct UniformHandle
+    {
+        GLint location{ -1 }; // -1 if the program has no such active uniform; setting it does nothing then
+
+        [[nodiscard]] constexpr bool isValid() const noexcept
+        {
+            return location != -1;
+        }
+    };
+
+    // Whether a uniform glGetActiveUniform reports as type is set with a value of type T
+    template<typename T>
+    constexpr bool isUniformType(const GLenum type) noexcept
+    {
+        if constexpr (std::is_same_v<T, GLfloat>)
+            return type == GL_FLOAT;
+        else if constexpr (std::is_same_v<T, glm::vec2>)
+            return type == GL_FLOAT_VEC2;
+        else if constexpr (std::is_same_v<T, glm::vec3>)
+            return type == GL_FLOAT_VEC3;
+        else if constexpr (std::is_same_v<T, glm::vec4>)
+            return type == GL_FLOAT_VEC4;
+        else if constexpr (std::is_same_v<T, glm::mat3>)
+            return type == GL_FLOAT_MAT3;
+        else if constexpr (std::is_same_v<T, glm::mat4>)
+            return type == GL_FLOAT_MAT4;
+        else if constexpr (std::is_same_v<T, GLint>)
+            return type == GL_INT || type == GL_BOOL || type == GL_SAMPLER_2D || type == GL_SAMPLER_3D
+                   || type == GL_SAMPLER_CUBE || type == GL_SAMPLER_2D_ARRAY || type == GL_SAMPLER_2D_SHADOW;
+        else if constexpr (std::is_same_v<T, GLuint>)
+            return type == GL_UNSIGNED_INT || type == GL_BOOL;
+        else if constexpr (std::is_same_v<T, bool>)
+            return type == GL_BOOL;
+        else
+            static_assert(sizeof(T) == 0, "Unsupported uniform handle type");
+    }
+
     class ShaderProgram
     {
     public:
@@ -34,15 +80,61 @@ namespace lgl
 
         [[nodiscard]] GLuint getId() const;
 
+        // From the uniforms reflected at link time; -1 if the program has no such active uniform
         [[nodiscard]] GLint getUniformLocation(std::string_view name) const;
 
+        // Same, by a name hashed at compile time
+        [[nodiscard]] GLint getUniformLocation(UniformId id) const;
+
+        /**
+         * Resolves a uniform for hot paths, which then set it without hashing names
+         *
+         * @return An invalid handle if the program has no such active uniform
+         * @throws std::invalid_argument if the uniform is not of type T
+         */
+        template<typename T>
+        [[nodiscard]] UniformHandle<T> uniformHandle(std::string_view name) const;
+
         template<typename... Args>
         void setUniform(std::string_view name, Args... args) const;
 
+        template<typename... Args>
+        void setUniform(UniformId id, Args... args) const;
+
+        template<typename T>
+        void setUniform(UniformHandle<T> handle, const std::type_identity_t<T>& value) const;
+
         void use() const;
 
     private:
+        struct UniformInfo
+        {
+            GLint location;
+            GLenum type;
+        };
+
+        // Lets the table be searched with string views
+        struct StringHash
+        {
+            using is_transparent = void;
+
+            [[nodiscard]] std::size_t operator()(const std::string_view value) const noexcept
+            {
+                return std::hash<std::string_view>{}(value);
+            }
+        };
+
         GLuint m_programId;
+        // Every active uniform outside blocks; arrays also by their bare name and each element
+        std::unordered_map<std::string, UniformInfo, StringHash, std::equal_to<>> m_uniforms;
+        // Locations by UniformId hash; names with one index also by their empty-bracket id indexed
+        std::unordered_map<uint64_t, GLint> m_uniformIds;
+
+        // Fills m_uniforms and m_uniformIds from the linked program
+        void reflectUniforms();
+
+        // Adds a reflected name to m_uniformIds
+        void addUniformId(std::string_view name, GLint location);
 
         static void setUniform(GLint location, GLint value);
         static void setUniform(GLint location, GLfloat value);
@@ -99,7 +191,7 @@ namespace lgl
 
         void link() const;
 
-        void linkAndValidate() const;
+        void linkAndValidate();
     };
 
     template<typename... Args>
@@ -113,6 +205,43 @@ namespace lgl
         }
         setUniform(location, std::forward<Args>(args)...);
     }
+
+    template<typename... Args>
+    void ShaderProgram::setUniform(const UniformId id, Args... args) const
+    {
+        const auto location{ getUniformLocation(id) };
+        if (location == -1)
+        {
+            return;
+        }
+        setUniform(location, std::forward<Args>(args)...);
+    }
+
+    template<typename T>
+    UniformHandle<T> ShaderProgram::uniformHandle(const std::string_view name) const
+    {
+        const auto uniform{ m_uniforms.find(name) };
+        if (uniform == m_uniforms.end())
+        {
+            return {};
+        }
+        if (!isUniformType<T>(uniform->second.type))
+        {
+            std::println(stderr, "Uniform '{}' of type {:#x} requested as another type", name, uniform->second.type);
+            throw std::invalid_argument("Uniform type mismatch");
+        }
+        return { .location = uniform->second.location };
+    }
+
+    template<typename T>
+    void ShaderProgram::setUniform(const UniformHandle<T> handle, const std::type_identity_t<T>& value) const
+    {
+        if (!handle.isValid())
+        {
+            return;
+        }
+        setUniform(handle.location, value);
+    }
 } // lgl
 
 #endif //LEARNOPENGL_APP_SHADERPROGRAM_H
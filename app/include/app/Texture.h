@@ -0,0 +1,76 @@
+//
+// Created by user on 10/17/26.
+//
+
+#ifndef LEARNOPENGL_APP_TEXTURE_H
+#define LEARNOPENGL_APP_TEXTURE_H
+
+#include <filesystem>
+#include <format>
+#include <stdexcept>
+#include <string_view>
+#include <glad/glad.h>
+
+namespace lgl
+{
+    struct Texture
+    {
+        enum class Type
+        {
+            DIFFUSE = 0,
+            SPECULAR,
+            NORMAL,
+            HEIGHT,
+            Size
+        };
+
+        GLuint id;
+        Type type;
+        std::filesystem::path path;
+    };
+
+    // A texture a material uses, before it is loaded. The type decides how the file is processed, so the same
+    // path under two types is two textures
+    struct TextureReference
+    {
+        std::filesystem::path path;
+        Texture::Type type;
+
+        bool operator==(const TextureReference& other) const = default;
+    };
+} // lgl
+
+template<>
+struct std::formatter<lgl::Texture::Type> : std::formatter<std::string_view>
+{
+    constexpr auto parse(std::format_parse_context& ctx)
+    {
+        return std::formatter<std::string_view>::parse(ctx);
+    }
+
+    template<typename FormatContext>
+    auto format(const lgl::Texture::Type type, FormatContext& ctx) const
+    {
+        std::string_view name{};
+        switch (type)
+        {
+            case lgl::Texture::Type::DIFFUSE:
+                name = "diffuse";
+                break;
+            case lgl::Texture::Type::SPECULAR:
+                name = "specular";
+                break;
+            case lgl::Texture::Type::NORMAL:
+                name = "normal";
+                break;
+            case lgl::Texture::Type::HEIGHT:
+                name = "height";
+                break;
+            default:
+                throw std::runtime_error{ "Unknown texture type" };
+        }
+        return std::formatter<std::string_view>::format(name, ctx);
+    }
+};
+
+#endif //LEARNOPENGL_APP_TEXTURE_H
@@ -0,0 +1,117 @@
+//
+// Created by user on 10/17/26.
+//
+
+#ifndef LEARNOPENGL_APP_TEXTURECACHE_H
+#define LEARNOPENGL_APP_TEXTURECACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <list>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+#include <glad/glad.h>
+#include "app/Texture.h"
+
+namespace lgl
+{
+    /**
+     * Resident GL textures, reference-counted across the meshes that use them.
+     *
+     * Textures are keyed by content, so identical images found under different paths share one GL texture;
+     * every reference, a path and the type it was processed as, is an alias of the content it was loaded with.
+     *
+     * Textures nobody references stay resident for reuse until the total size exceeds the budget; then the least
+     * recently released ones are deleted first. Referenced textures are never evicted, so usage can exceed the
+     * budget while they are in use. Must only be used on the GL thread.
+     */
+    class TextureCache
+    {
+    public:
+        using handle_type = GLuint;
+
+        TextureCache() = default;
+
+        TextureCache(const TextureCache& other) = delete;
+
+        TextureCache& operator=(const TextureCache& other) = delete;
+
+        // Takes a reference to a resident texture
+        [[nodiscard]] std::optional<handle_type> acquire(const TextureReference& texture);
+
+        /**
+         * Makes texture another name for already resident content, saving an upload
+         *
+         * @return Whether content with that key is resident
+         */
+        [[nodiscard]] bool alias(const TextureReference& texture, uint64_t contentKey);
+
+        /**
+         * Registers a freshly uploaded texture, unreferenced and most recently used.
+         * Does not evict, so textures uploaded ahead of the meshes that will acquire them survive until then.
+         *
+         * @param texture Source path of the texture and the type it was processed as
+         * @param contentKey Hash identifying the texture contents, including how they were processed
+         * @param handle GL texture the cache takes ownership of
+         * @param size Bytes of texture memory the handle occupies
+         */
+        void insert(const TextureReference& texture, uint64_t contentKey, handle_type handle, std::size_t size);
+
+        // Drops a reference taken by acquire and evicts if over budget; textures that are not resident are ignored
+        void release(const TextureReference& texture);
+
+        [[nodiscard]] bool contains(const TextureReference& texture) const;
+
+        // Deletes unreferenced textures, least recently released first, until usage fits the budget
+        void trim();
+
+        // Deletes every texture, referenced or not
+        void clear();
+
+        void setBudget(std::size_t bytes);
+
+        [[nodiscard]] std::size_t budget() const noexcept;
+
+        [[nodiscard]] std::size_t usage() const noexcept;
+
+        [[nodiscard]] std::size_t peakUsage() const noexcept;
+
+        [[nodiscard]] std::size_t residentCount() const noexcept;
+
+        // Texture memory uploads would have taken had aliases not shared content, since creation
+        [[nodiscard]] std::size_t savedBytes() const noexcept;
+
+    private:
+        struct Entry
+        {
+            handle_type handle{ 0 };
+            std::size_t size{ 0 };
+            std::size_t references{ 0 };
+            std::vector<TextureReference> aliases;
+            std::list<uint64_t>::iterator unreferencedPosition{}; // Valid while references is 0
+        };
+
+        struct ReferenceHash
+        {
+            [[nodiscard]] std::size_t operator()(const TextureReference& texture) const noexcept
+            {
+                return std::filesystem::hash_value(texture.path) * 31 + static_cast<std::size_t>(texture.type);
+            }
+        };
+
+        [[nodiscard]] Entry* find(const TextureReference& texture);
+
+        std::unordered_map<uint64_t, Entry> m_entries;
+        std::unordered_map<TextureReference, uint64_t, ReferenceHash> m_contentKeys;
+        std::list<uint64_t> m_unreferenced; // Least recently released first
+        std::size_t m_budget{ std::numeric_limits<std::size_t>::max() };
+        std::size_t m_usage{ 0 };
+        std::size_t m_peakUsage{ 0 };
+        std::size_t m_savedBytes{ 0 };
+    };
+} // lgl
+
+#endif //LEARNOPENGL_APP_TEXTURECACHE_H
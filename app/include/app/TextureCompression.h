@@ -0,0 +1,173 @@
+//
+// Created by user on 10/17/26.
+//
+
+#ifndef LEARNOPENGL_APP_TEXTURECOMPRESSION_H
+#define LEARNOPENGL_APP_TEXTURECOMPRESSION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+#include "app/Image.h"
+
+namespace lgl
+{
+    // GPU block-compressed formats; every format encodes 4x4 texel blocks
+    enum class CompressedFormat
+    {
+        None,
+        BC1, // RGB, 8 bytes per block
+        BC3, // RGBA, BC1 color plus a BC4 alpha block
+        BC4, // One channel, 8 bytes per block
+        BC5, // Two channels, two BC4 blocks; used for tangent-space normal maps
+        BC7 // RGBA, 16 bytes per block; encoded in mode 6 only, decoded in every mode
+    };
+
+    [[nodiscard]] constexpr std::size_t blockSize(const CompressedFormat format)
+    {
+        switch (format)
+        {
+            case CompressedFormat::BC1:
+            case CompressedFormat::BC4:
+                return 8;
+            case CompressedFormat::BC3:
+            case CompressedFormat::BC5:
+            case CompressedFormat::BC7:
+                return 16;
+            default:
+                throw std::runtime_error("Not a block-compressed format");
+        }
+    }
+
+    [[nodiscard]] constexpr std::size_t compressedSize(const CompressedFormat format,
+                                                       const uint32_t width,
+                                                       const uint32_t height)
+    {
+        return static_cast<std::size_t>((width + 3) / 4) * ((height + 3) / 4) * blockSize(format);
+    }
+
+    // Channels a decoded block of this format carries
+    [[nodiscard]] constexpr uint8_t channelCount(const CompressedFormat format)
+    {
+        switch (format)
+        {
+            case CompressedFormat::BC4:
+                return 1;
+            case CompressedFormat::BC5:
+                return 2;
+            case CompressedFormat::BC1:
+                return 3;
+            case CompressedFormat::BC3:
+            case CompressedFormat::BC7:
+                return 4;
+            default:
+                throw std::runtime_error("Not a block-compressed format");
+        }
+    }
+
+    // Format picked when none is configured: two-channel BC5 for normal maps, otherwise by channel count
+    [[nodiscard]] constexpr CompressedFormat automaticCompressedFormat(const PixelFormat pixelFormat,
+                                                                       const bool normalMap) noexcept
+    {
+        if (normalMap)
+        {
+            return CompressedFormat::BC5;
+        }
+        switch (pixelFormat)
+        {
+            case PixelFormat::Red:
+                return CompressedFormat::BC4;
+            case PixelFormat::RG:
+                return CompressedFormat::BC5;
+            case PixelFormat::RGB:
+                return CompressedFormat::BC1;
+            case PixelFormat::RGBA:
+                return CompressedFormat::BC7;
+            default:
+                return CompressedFormat::None;
+        }
+    }
+
+    /**
+     * Encodes an image into blocks, spreading block rows over the shared thread pool.
+     * Channels are read the way OpenGL samples the uncompressed format: missing color channels are 0 and a
+     * missing alpha is opaque.
+     *
+     * @param image 8-bit image with 1 to 4 channels
+     * @param format Target block format
+     * @return Blocks in row-major block order, compressedSize(format, width, height) bytes
+     */
+    [[nodiscard]] std::vector<std::byte> compress(const ImageData& image, CompressedFormat format);
+
+    /**
+     * Decodes blocks back into an 8-bit image with channelCount(format) channels.
+     * Used for quality metrics and as an upload fallback when the driver lacks the format.
+     */
+    [[nodiscard]] ImageData decompress(std::span<const std::byte> blocks,
+                                       uint32_t width,
+                                       uint32_t height,
+                                       CompressedFormat format);
+
+    // Whether flipVertically can flip blocks of this format, in a level of this height, without decoding them
+    [[nodiscard]] constexpr bool isVerticallyFlippable(const CompressedFormat format, const uint32_t height) noexcept
+    {
+        // BC7 partitions are not symmetric under a flip, and texel rows only map onto whole block rows when the
+        // height is a multiple of 4 or fits in a single block row
+        return format != CompressedFormat::None && format != CompressedFormat::BC7 && (height % 4 == 0 || height < 4);
+    }
+
+    /**
+     * Flips a level of blocks vertically in place by reversing the block rows and the texel rows inside each block
+     *
+     * @throws std::runtime_error unless isVerticallyFlippable(format, height)
+     */
+    void flipVertically(std::span<std::byte> blocks, uint32_t width, uint32_t height, CompressedFormat format);
+
+    // Peak signal-to-noise ratio in dB over the channels both images share; infinite for identical images
+    [[nodiscard]] double psnr(const ImageData& reference, const ImageData& image);
+} // lgl
+
+template<>
+struct std::formatter<lgl::CompressedFormat> : std::formatter<std::string_view>
+{
+    constexpr auto parse(std::format_parse_context& ctx)
+    {
+        return std::formatter<std::string_view>::parse(ctx);
+    }
+
+    template<typename FormatContext>
+    auto format(const lgl::CompressedFormat format, FormatContext& ctx) const
+    {
+        std::string_view name{};
+        switch (format)
+        {
+            case lgl::CompressedFormat::None:
+                name = "uncompressed";
+                break;
+            case lgl::CompressedFormat::BC1:
+                name = "BC1";
+                break;
+            case lgl::CompressedFormat::BC3:
+                name = "BC3";
+                break;
+            case lgl::CompressedFormat::BC4:
+                name = "BC4";
+                break;
+            case lgl::CompressedFormat::BC5:
+                name = "BC5";
+                break;
+            case lgl::CompressedFormat::BC7:
+                name = "BC7";
+                break;
+            default:
+                throw std::runtime_error{ "Unknown compressed format" };
+        }
+        return std::formatter<std::string_view>::format(name, ctx);
+    }
+};
+
+#endif //LEARNOPENGL_APP_TEXTURECOMPRESSION_H
@@ -0,0 +1,66 @@
+//
+// Created by user on 10/17/26.
+//
+
+#ifndef LEARNOPENGL_APP_TEXTURECONTAINER_H
+#define LEARNOPENGL_APP_TEXTURECONTAINER_H
+
+#include <filesystem>
+#include <optional>
+#include <vector>
+#include "app/Image.h"
+#include "app/MappedFile.h"
+#include "app/Mipmap.h"
+#include "app/TextureCompression.h"
+
+namespace lgl
+{
+    /**
+     * GPU-ready texture file mapped into memory; the levels point straight into the mapping, so they can be
+     * handed to glCompressedTexImage2D / glTexImage2D without a copy.
+     */
+    struct TextureContainer
+    {
+        MappedFile file;
+        PixelFormat pixelFormat{ PixelFormat::Unknown }; // Layout of the pixels, or of the decompressed blocks
+        CompressedFormat compressedFormat{ CompressedFormat::None };
+        ImageData::RowOrder rowOrder{ ImageData::RowOrder::TopDown };
+        std::vector<MipLevel> levels; // Base level first
+    };
+
+    namespace detail
+    {
+        // KTX2 specialization; supports 2D textures of 8-bit UNORM/sRGB or BC1/3/4/5/7 formats without
+        // supercompression
+        template<>
+        struct ImageReader<ImageFormat::KTX2>
+        {
+            [[nodiscard]] static TextureContainer map(const std::filesystem::path& file_path);
+
+            // Copies (or decompresses) the level options.maxDimension selects into an ImageData
+            static ImageData read(const std::filesystem::path& file_path, const ImageLoadOptions& options = {});
+        };
+
+        // DDS specialization; supports 2D textures in DXT1/DXT5/ATI1/ATI2 or DX10 BC1/3/4/5/7, R8, R8G8 and
+        // R8G8B8A8 formats
+        template<>
+        struct ImageReader<ImageFormat::DDS>
+        {
+            [[nodiscard]] static TextureContainer map(const std::filesystem::path& file_path);
+
+            // Copies (or decompresses) the level options.maxDimension selects into an ImageData
+            static ImageData read(const std::filesystem::path& file_path, const ImageLoadOptions& options = {});
+        };
+    }
+
+    /**
+     * Maps a KTX2 or DDS file
+     *
+     * @param filePath Path to the texture file
+     * @return The mapped container, or std::nullopt if the file is not a KTX2 or DDS file
+     * @throws std::runtime_error if the container is malformed or uses an unsupported format
+     */
+    [[nodiscard]] std::optional<TextureContainer> mapTextureContainer(const std::filesystem::path& filePath);
+} // lgl
+
+#endif //LEARNOPENGL_APP_TEXTURECONTAINER_H
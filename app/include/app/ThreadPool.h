@@ -0,0 +1,135 @@
+//
+// Created by user on 10/17/26.
+//
+
+#ifndef LEARNOPENGL_APP_THREADPOOL_H
+#define LEARNOPENGL_APP_THREADPOOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <stop_token>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace lgl
+{
+    class ThreadPool
+    {
+    public:
+        explicit ThreadPool(std::size_t threadCount);
+
+        ThreadPool(const ThreadPool& other) = delete;
+        ThreadPool(ThreadPool&& other) noexcept = delete;
+        ThreadPool& operator=(const ThreadPool& other) = delete;
+        ThreadPool& operator=(ThreadPool&& other) noexcept = delete;
+
+        ~ThreadPool();
+
+        // Pool shared by asset loading, sized to the hardware concurrency
+        [[nodiscard]] static ThreadPool& shared();
+
+        template<typename F>
+        [[nodiscard]] auto submit(F&& task) -> std::future<std::invoke_result_t<std::decay_t<F>>>;
+
+        /**
+         * Runs body(i) for every i in [0, count) on the pool and the calling thread, returning once all are done.
+         * The caller only waits for iterations that are already running, so this may be called from a pool task.
+         *
+         * @throws The first exception thrown by body, after every iteration has finished
+         */
+        template<typename F>
+        void parallelFor(std::size_t count, F&& body);
+
+        [[nodiscard]] std::size_t size() const noexcept;
+
+    private:
+        void enqueue(std::move_only_function<void()> task);
+
+        void workerLoop(std::stop_token stopToken);
+
+        std::mutex m_mutex;
+        std::condition_variable_any m_condition;
+        std::queue<std::move_only_function<void()>> m_tasks;
+        std::vector<std::jthread> m_workers;
+    };
+
+    template<typename F>
+    auto ThreadPool::submit(F&& task) -> std::future<std::invoke_result_t<std::decay_t<F>>>
+    {
+        std::packaged_task<std::invoke_result_t<std::decay_t<F>>()> packagedTask{ std::forward<F>(task) };
+        auto future{ packagedTask.get_future() };
+        enqueue([packagedTask = std::move(packagedTask)]() mutable
+        {
+            packagedTask();
+        });
+        return future;
+    }
+
+    template<typename F>
+    void ThreadPool::parallelFor(const std::size_t count, F&& body)
+    {
+        struct State
+        {
+            std::size_t count{ 0 };
+            std::atomic<std::size_t> next{ 0 };
+            std::atomic<std::size_t> completed{ 0 };
+            std::mutex failureMutex;
+            std::exception_ptr failure;
+        };
+
+        const auto state{ std::make_shared<State>() };
+        state->count = count;
+
+        // Helpers that start after every iteration was claimed return without touching body
+        const auto work{
+            [state, &body]
+            {
+                for (auto i{ state->next.fetch_add(1) }; i < state->count; i = state->next.fetch_add(1))
+                {
+                    try
+                    {
+                        body(i);
+                    }
+                    catch (...)
+                    {
+                        std::scoped_lock lock{ state->failureMutex };
+                        if (state->failure == nullptr)
+                        {
+                            state->failure = std::current_exception();
+                        }
+                    }
+                    if (state->completed.fetch_add(1) + 1 == state->count)
+                    {
+                        state->completed.notify_all();
+                    }
+                }
+            }
+        };
+
+        const auto helperCount{ std::min(size(), count) };
+        for (std::size_t i{ 1 }; i < helperCount; ++i)
+        {
+            enqueue(work);
+        }
+        work();
+
+        for (auto completed{ state->completed.load() }; completed < count; completed = state->completed.load())
+        {
+            state->completed.wait(completed);
+        }
+        if (state->failure != nullptr)
+        {
+            std::rethrow_exception(state->failure);
+        }
+    }
+} // lgl
+
+#endif //LEARNOPENGL_APP_THREADPOOL_H
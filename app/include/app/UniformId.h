@@ -0,0 +1,57 @@
+//
+// Created by user on 10/17/26.
+//
+
+#ifndef LEARNOPENGL_APP_UNIFORMID_H
+#define LEARNOPENGL_APP_UNIFORMID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace lgl
+{
+    /**
+     * Uniform name hashed at compile time, matched against the table a ShaderProgram builds when it links.
+     * Array elements are named with empty brackets and indexed, so "pointLights[].position"_u[2] is the id of
+     * pointLights[2].position without formatting or hashing anything at run time
+     */
+    struct UniformId
+    {
+        uint64_t hash{ 0 };
+
+        // 64-bit FNV-1a
+        [[nodiscard]] static constexpr UniformId of(const std::string_view name) noexcept
+        {
+            uint64_t hash{ 0xCBF29CE484222325 };
+            for (const auto character : name)
+            {
+                hash ^= static_cast<uint8_t>(character);
+                hash *= 0x100000001B3;
+            }
+            return { hash };
+        }
+
+        // Only for names with a single pair of empty brackets
+        [[nodiscard]] constexpr UniformId operator[](const std::size_t index) const noexcept
+        {
+            // SplitMix64 finalizer, so neighboring indices give unrelated ids
+            auto mixed{ hash + (static_cast<uint64_t>(index) + 1) * 0x9E3779B97F4A7C15 };
+            mixed = (mixed ^ mixed >> 30) * 0xBF58476D1CE4E5B9;
+            mixed = (mixed ^ mixed >> 27) * 0x94D049BB133111EB;
+            return { mixed ^ mixed >> 31 };
+        }
+
+        friend constexpr bool operator==(UniformId, UniformId) noexcept = default;
+    };
+
+    namespace literals
+    {
+        consteval UniformId operator""_u(const char* name, const std::size_t length) noexcept
+        {
+            return UniformId::of({ name, length });
+        }
+    } // literals
+} // lgl
+
+#endif //LEARNOPENGL_APP_UNIFORMID_H
@@ -0,0 +1,143 @@
+//
+// Created by user on 10/17/26.
+//
+
+#ifndef LEARNOPENGL_APP_VERTEX_H
+#define LEARNOPENGL_APP_VERTEX_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include "app/VertexLayout.h"
+
+namespace lgl
+{
+    constexpr auto MAX_BONE_INFLUENCE{ 4 };
+
+    struct Vertex
+    {
+        glm::vec3 position;
+        glm::vec3 normal;
+        glm::vec2 textureCoordinates;
+        glm::vec3 tangent;
+        glm::vec3 bitangent;
+        std::array<int, MAX_BONE_INFLUENCE> boneIds;
+        std::array<float, MAX_BONE_INFLUENCE> weights;
+    };
+
+    // GPU layout a Mesh uploads its vertices in
+    enum class VertexFormat
+    {
+        Full, // Vertex as is, 88 bytes
+        Packed, // PackedVertex, 28 bytes
+        Quantized // QuantizedVertex, 24 bytes; positions need the mesh's Dequantization
+    };
+
+    /**
+     * Compact vertex without skinning data.
+     * Normals are octahedral-encoded, the bitangent is rebuilt in the shader as
+     * cross(normal, tangent.xyz) * tangent.w, and texture coordinates are half floats.
+     */
+    struct PackedVertex
+    {
+        glm::vec3 position;
+        std::array<int16_t, 2> normal; // Octahedral, snorm16
+        std::array<uint16_t, 2> textureCoordinates; // Half floats
+        std::array<int16_t, 4> tangent; // xyz snorm16, w is the bitangent sign (±32767)
+    };
+
+    // PackedVertex with positions normalized to the mesh bounds
+    struct QuantizedVertex
+    {
+        std::array<uint16_t, 4> position; // xyz unorm16 within the bounds, w unused
+        std::array<int16_t, 2> normal;
+        std::array<uint16_t, 2> textureCoordinates;
+        std::array<int16_t, 4> tangent;
+    };
+
+    static_assert(sizeof(PackedVertex) == 28 && sizeof(QuantizedVertex) == 24);
+
+    template<>
+    struct VertexLayout<Vertex>
+    {
+        static constexpr std::array attributes{
+            attribute<decltype(Vertex::position)>(0, offsetof(Vertex, position)),
+            attribute<decltype(Vertex::normal)>(1, offsetof(Vertex, normal)),
+            attribute<decltype(Vertex::textureCoordinates)>(2, offsetof(Vertex, textureCoordinates)),
+            attribute<decltype(Vertex::tangent)>(3, offsetof(Vertex, tangent)),
+            attribute<decltype(Vertex::bitangent)>(4, offsetof(Vertex, bitangent)),
+            attribute<decltype(Vertex::boneIds)>(5, offsetof(Vertex, boneIds)),
+            attribute<decltype(Vertex::weights)>(6, offsetof(Vertex, weights))
+        };
+    };
+
+    template<>
+    struct VertexLayout<PackedVertex>
+    {
+        static constexpr std::array attributes{
+            attribute<decltype(PackedVertex::position)>(0, offsetof(PackedVertex, position)),
+            attribute<decltype(PackedVertex::normal)>(1,
+                                                      offsetof(PackedVertex, normal),
+                                                      AttributeInterpretation::Normalized),
+            attribute<decltype(PackedVertex::textureCoordinates)>(2,
+                                                                  offsetof(PackedVertex, textureCoordinates),
+                                                                  AttributeInterpretation::HalfFloat),
+            attribute<decltype(PackedVertex::tangent)>(3,
+                                                       offsetof(PackedVertex, tangent),
+                                                       AttributeInterpretation::Normalized)
+        };
+    };
+
+    // The unused w of the position reaches the shader too, which only reads xyz
+    template<>
+    struct VertexLayout<QuantizedVertex>
+    {
+        static constexpr std::array attributes{
+            attribute<decltype(QuantizedVertex::position)>(0,
+                                                           offsetof(QuantizedVertex, position),
+                                                           AttributeInterpretation::Normalized),
+            attribute<decltype(QuantizedVertex::normal)>(1,
+                                                         offsetof(QuantizedVertex, normal),
+                                                         AttributeInterpretation::Normalized),
+            attribute<decltype(QuantizedVertex::textureCoordinates)>(2,
+                                                                     offsetof(QuantizedVertex, textureCoordinates),
+                                                                     AttributeInterpretation::HalfFloat),
+            attribute<decltype(QuantizedVertex::tangent)>(3,
+                                                          offsetof(QuantizedVertex, tangent),
+                                                          AttributeInterpretation::Normalized)
+        };
+    };
+
+    // Maps quantized positions back to model space: position * scale + offset
+    struct Dequantization
+    {
+        glm::vec3 scale{ 1.0f };
+        glm::vec3 offset{ 0.0f };
+    };
+
+    // Octahedral encoding of a unit vector into two snorm16 components
+    [[nodiscard]] std::array<int16_t, 2> encodeOctahedral(const glm::vec3& direction) noexcept;
+
+    [[nodiscard]] glm::vec3 decodeOctahedral(const std::array<int16_t, 2>& encoded) noexcept;
+
+    [[nodiscard]] PackedVertex pack(const Vertex& vertex) noexcept;
+
+    // Bounds of the positions, so quantization spends all 16 bits on the mesh itself
+    [[nodiscard]] Dequantization dequantization(std::span<const Vertex> vertices) noexcept;
+
+    struct BoundingSphere
+    {
+        glm::vec3 center{ 0.0f };
+        float radius{ 0.0f };
+    };
+
+    // Sphere around the center of the bounding box; not minimal, but cheap and stable
+    [[nodiscard]] BoundingSphere boundingSphere(std::span<const Vertex> vertices) noexcept;
+
+    [[nodiscard]] QuantizedVertex quantize(const Vertex& vertex, const Dequantization& dequantization) noexcept;
+} // lgl
+
+#endif //LEARNOPENGL_APP_VERTEX_H
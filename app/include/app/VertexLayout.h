@@ -0,0 +1,231 @@
+//
+// Created by user on 10/17/26.
+//
+
+#ifndef LEARNOPENGL_APP_VERTEXLAYOUT_H
+#define LEARNOPENGL_APP_VERTEXLAYOUT_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <glad/glad.h>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+namespace lgl
+{
+    // How the shader sees the components of an attribute
+    enum class AttributeInterpretation
+    {
+        Default, // Floats as floats, integers as integers (glVertexAttribIPointer)
+        Normalized, // Integers mapped to [0, 1] or [-1, 1]
+        HalfFloat // 16-bit components holding half floats
+    };
+
+    // One glVertexAttribPointer call, resolved at compile time
+    struct VertexAttribute
+    {
+        GLuint location{ 0 };
+        GLint components{ 0 };
+        GLenum type{ GL_FLOAT };
+        GLboolean normalized{ GL_FALSE };
+        bool integer{ false };
+        std::size_t offset{ 0 };
+        std::size_t size{ 0 };
+    };
+
+    template<typename T>
+    struct AttributeComponent;
+
+    template<>
+    struct AttributeComponent<float>
+    {
+        static constexpr GLenum type{ GL_FLOAT };
+    };
+
+    template<>
+    struct AttributeComponent<int32_t>
+    {
+        static constexpr GLenum type{ GL_INT };
+    };
+
+    template<>
+    struct AttributeComponent<uint32_t>
+    {
+        static constexpr GLenum type{ GL_UNSIGNED_INT };
+    };
+
+    template<>
+    struct AttributeComponent<int16_t>
+    {
+        static constexpr GLenum type{ GL_SHORT };
+    };
+
+    template<>
+    struct AttributeComponent<uint16_t>
+    {
+        static constexpr GLenum type{ GL_UNSIGNED_SHORT };
+    };
+
+    template<>
+    struct AttributeComponent<int8_t>
+    {
+        static constexpr GLenum type{ GL_BYTE };
+    };
+
+    template<>
+    struct AttributeComponent<uint8_t>
+    {
+        static constexpr GLenum type{ GL_UNSIGNED_BYTE };
+    };
+
+    // Component type and count of a vertex member: a scalar, a glm vector or a std::array
+    template<typename T>
+    struct AttributeShape
+    {
+        using component_type = T;
+        static constexpr GLint components{ 1 };
+    };
+
+    template<glm::length_t L, typename T, glm::qualifier Q>
+    struct AttributeShape<glm::vec<L, T, Q>>
+    {
+        using component_type = T;
+        static constexpr GLint components{ L };
+    };
+
+    template<typename T, std::size_t N>
+    struct AttributeShape<std::array<T, N>>
+    {
+        using component_type = T;
+        static constexpr GLint components{ N };
+    };
+
+    /**
+     * Describes a member of a vertex type; the GL type and component count follow from the member's type
+     *
+     * @tparam Member Type of the vertex member, decltype(Vertex::member)
+     * @param location Shader attribute location
+     * @param offset offsetof(Vertex, member)
+     * @param interpretation How integer components reach the shader
+     */
+    template<typename Member>
+    constexpr VertexAttribute attribute(const GLuint location,
+                                        const std::size_t offset,
+                                        const AttributeInterpretation interpretation = AttributeInterpretation::Default)
+    {
+        using shape = AttributeShape<Member>;
+        using component_type = typename shape::component_type;
+
+        if (interpretation == AttributeInterpretation::HalfFloat)
+        {
+            if (sizeof(component_type) != 2)
+            {
+                // Reached during constant evaluation, so this fails to compile
+                throw std::invalid_argument("Half float attributes need 16-bit components");
+            }
+            return {
+                .location = location,
+                .components = shape::components,
+                .type = GL_HALF_FLOAT,
+                .offset = offset,
+                .size = sizeof(Member)
+            };
+        }
+        return {
+            .location = location,
+            .components = shape::components,
+            .type = AttributeComponent<component_type>::type,
+            .normalized = static_cast<GLboolean>(interpretation == AttributeInterpretation::Normalized),
+            .integer = std::is_integral_v<component_type> && interpretation == AttributeInterpretation::Default,
+            .offset = offset,
+            .size = sizeof(Member)
+        };
+    }
+
+    /**
+     * Attribute layout of a vertex type, specialized next to each type a Mesh can upload:
+     *
+     *   template<>
+     *   struct VertexLayout<MyVertex>
+     *   {
+     *       static constexpr std::array attributes{ attribute<decltype(MyVertex::position)>(0, offsetof(...)), ... };
+     *   };
+     */
+    template<typename VertexT>
+    struct VertexLayout;
+
+    // Attributes lie within the vertex, do not overlap and use distinct locations
+    template<typename VertexT>
+    consteval bool isValidLayout()
+    {
+        auto attributes{ VertexLayout<VertexT>::attributes };
+        std::ranges::sort(attributes, {}, &VertexAttribute::offset);
+        for (std::size_t i{ 0 }; i < attributes.size(); ++i)
+        {
+            if (attributes[i].offset + attributes[i].size > sizeof(VertexT))
+            {
+                return false;
+            }
+            if (i > 0 && attributes[i - 1].offset + attributes[i - 1].size > attributes[i].offset)
+            {
+                return false;
+            }
+            for (std::size_t j{ 0 }; j < i; ++j)
+            {
+                if (attributes[j].location == attributes[i].location)
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // Sets up the attributes of VertexT for the bound vertex array and array buffer
+    template<typename VertexT>
+    void enableVertexAttributes()
+    {
+        static_assert(isValidLayout<VertexT>(), "Invalid vertex layout");
+        constexpr auto stride{ static_cast<GLsizei>(sizeof(VertexT)) };
+
+        for (const auto& attribute : VertexLayout<VertexT>::attributes)
+        {
+            glEnableVertexAttribArray(attribute.location);
+            if (attribute.integer)
+            {
+                glVertexAttribIPointer(attribute.location,
+                                       attribute.components,
+                                       attribute.type,
+                                       stride,
+                                       reinterpret_cast<const GLvoid*>(attribute.offset));
+            }
+            else
+            {
+                glVertexAttribPointer(attribute.location,
+                                      attribute.components,
+                                      attribute.type,
+                                      attribute.normalized,
+                                      stride,
+                                      reinterpret_cast<const GLvoid*>(attribute.offset));
+            }
+        }
+    }
+
+    // Sets up VertexLayout<InstanceT> from the bound GL_ARRAY_BUFFER, advancing once per instance
+    template<typename InstanceT>
+    void enableInstanceAttributes()
+    {
+        enableVertexAttributes<InstanceT>();
+        for (const auto& attribute : VertexLayout<InstanceT>::attributes)
+        {
+            glVertexAttribDivisor(attribute.location, 1);
+        }
+    }
+} // lgl
+
+#endif //LEARNOPENGL_APP_VERTEXLAYOUT_H
@@ -5,12 +5,29 @@
 #ifndef LEARNOPENGL_APP_UTILITIES_H
 #define LEARNOPENGL_APP_UTILITIES_H
 
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
+#include <span>
 #include <string>
+#include <string_view>
 
 namespace lgl
 {
     [[nodiscard]] std::string readAll(const std::filesystem::path& filepath);
+
+    /**
+     * Writes a whole file through a temporary next to it and a rename, so readers never see it partially written.
+     * Creates missing parent directories
+     *
+     * @return Whether the file was written; failures are logged
+     */
+    bool writeAllAtomically(const std::filesystem::path& filepath, std::span<const std::byte> bytes);
+
+    // Fast non-cryptographic 64-bit hash (XXH64) for content keys
+    [[nodiscard]] uint64_t hash64(std::span<const std::byte> bytes, uint64_t seed = 0) noexcept;
+
+    [[nodiscard]] uint64_t hash64(std::string_view text, uint64_t seed = 0) noexcept;
 } // lgl
 
 #endif //LEARNOPENGL_APP_UTILITIES_H
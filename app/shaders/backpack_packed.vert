@@ -0,0 +1,35 @@
+#version 330 core
+
+// Mesh vertices uploaded as lgl::PackedVertex or lgl::QuantizedVertex
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec2 aNormal;
+layout (location = 2) in vec2 aTexCoords;
+
+out vec3 FragPos;
+out vec3 Normal;
+out vec2 TexCoords;
+
+uniform mat3 normalMatrix;
+uniform mat4 projection;
+uniform mat4 view;
+uniform mat4 model;
+
+// Quantized positions are normalized to the mesh bounds; packed ones use the defaults
+uniform vec3 positionScale = vec3(1.0);
+uniform vec3 positionOffset = vec3(0.0);
+
+vec3 decodeOctahedral(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
+void main() {
+    FragPos = vec3(model * vec4(aPos * positionScale + positionOffset, 1.0));
+    Normal = normalMatrix * decodeOctahedral(aNormal);
+    TexCoords = aTexCoords;
+
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+}
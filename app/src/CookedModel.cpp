@@ -0,0 +1,456 @@
+//
+// Created by user on 10/17/26.
+//
+
+#include "app/CookedModel.h"
+
+#include <array>
+#include <cstring>
+#include <exception>
+#include <format>
+#include <print>
+#include <ranges>
+#include <string>
+#include <type_traits>
+#include "app/utilities.h"
+
+namespace
+{
+    constexpr std::array COOKED_MODEL_MAGIC{ 'L', 'G', 'L', 'M' };
+    // Bump whenever the mesh processing changes, so stale geometry is imported again
+    constexpr uint32_t COOKED_MODEL_VERSION{ 3 };
+    constexpr std::size_t BLOB_ALIGNMENT{ 16 };
+
+    struct FileHeader
+    {
+        std::array<char, 4> magic;
+        uint32_t version;
+        uint32_t vertexSize;
+        uint32_t dependencyCount;
+        uint32_t nodeCount;
+        uint32_t meshCount;
+        uint32_t lodCount;
+        uint32_t textureCount;
+        uint64_t stringsOffset;
+        uint64_t stringsSize;
+    };
+
+    struct DependencyRecord
+    {
+        uint64_t pathOffset;
+        uint64_t pathSize;
+        uint64_t size;
+        int64_t modificationTime;
+    };
+
+    struct MeshRecord
+    {
+        uint64_t vertexOffset;
+        uint64_t vertexCount;
+        uint64_t indexOffset;
+        uint64_t indexCount;
+        uint32_t firstLod;
+        uint32_t lodCount;
+        uint32_t firstTexture;
+        uint32_t textureCount;
+        uint32_t triangleList; // 0 or 1
+        uint32_t reserved;
+    };
+
+    struct LodRecord
+    {
+        uint64_t firstIndex;
+        uint64_t indexCount;
+        float error;
+        uint32_t reserved;
+    };
+
+    struct TextureRecord
+    {
+        uint64_t pathOffset;
+        uint64_t pathSize;
+        uint32_t type;
+        uint32_t reserved;
+    };
+
+    static_assert(std::is_trivially_copyable_v<FileHeader> && std::is_trivially_copyable_v<DependencyRecord> &&
+                  std::is_trivially_copyable_v<lgl::ModelNode> && std::is_trivially_copyable_v<MeshRecord> &&
+                  std::is_trivially_copyable_v<LodRecord> && std::is_trivially_copyable_v<TextureRecord> &&
+                  std::is_trivially_copyable_v<lgl::Vertex>);
+
+    constexpr std::size_t alignUp(const std::size_t value, const std::size_t alignment) noexcept
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    int64_t modificationTime(const std::filesystem::path& path)
+    {
+        return std::filesystem::last_write_time(path).time_since_epoch().count();
+    }
+
+    template<typename T>
+    T readAt(const std::span<const std::byte> bytes, const std::size_t offset) noexcept
+    {
+        T value{};
+        std::memcpy(&value, bytes.data() + offset, sizeof(T));
+        return value;
+    }
+
+    template<typename T>
+    void writeAt(std::vector<std::byte>& bytes, const std::size_t offset, const T& value) noexcept
+    {
+        std::memcpy(bytes.data() + offset, &value, sizeof(T));
+    }
+
+    // Whether [offset, offset + size) lies within bytes
+    bool contains(const std::span<const std::byte> bytes, const uint64_t offset, const uint64_t size) noexcept
+    {
+        return offset <= bytes.size() && size <= bytes.size() - offset;
+    }
+
+    // Table of fixed-size records following each other after the header
+    struct Tables
+    {
+        std::size_t dependencies;
+        std::size_t nodes;
+        std::size_t meshes;
+        std::size_t lods;
+        std::size_t textures;
+        std::size_t end;
+
+        static Tables of(const FileHeader& header) noexcept
+        {
+            Tables tables{};
+            tables.dependencies = sizeof(FileHeader);
+            tables.nodes = tables.dependencies + header.dependencyCount * sizeof(DependencyRecord);
+            tables.meshes = tables.nodes + header.nodeCount * sizeof(lgl::ModelNode);
+            tables.lods = tables.meshes + header.meshCount * sizeof(MeshRecord);
+            tables.textures = tables.lods + header.lodCount * sizeof(LodRecord);
+            tables.end = tables.textures + header.textureCount * sizeof(TextureRecord);
+            return tables;
+        }
+    };
+}
+
+namespace lgl
+{
+    std::filesystem::path CookedModel::s_cacheDirectory{ "cache/models" };
+
+    std::optional<CookedModel> CookedModel::load(const std::filesystem::path& sourcePath)
+    {
+        if (s_cacheDirectory.empty())
+        {
+            return std::nullopt;
+        }
+
+        const auto path{ cachePath(sourcePath) };
+        std::error_code error{};
+        if (!std::filesystem::is_regular_file(path, error))
+        {
+            return std::nullopt;
+        }
+
+        std::optional<CookedModel> model{};
+        try
+        {
+            model.emplace(CookedModel{ MappedFile::open(path) });
+        }
+        catch (const std::exception& e)
+        {
+            std::println(stderr, "Ignoring unreadable cooked model '{}': {}", path.string(), e.what());
+            return std::nullopt;
+        }
+        if (!model->parse())
+        {
+            std::println(stderr, "Ignoring outdated or corrupt cooked model '{}'", path.string());
+            return std::nullopt;
+        }
+
+        // Stale when any file the import read changed or disappeared
+        const auto bytes{ model->m_file.bytes() };
+        const auto header{ readAt<FileHeader>(bytes, 0) };
+        const auto tables{ Tables::of(header) };
+        for (std::size_t i{ 0 }; i < header.dependencyCount; ++i)
+        {
+            const auto dependency{ readAt<DependencyRecord>(bytes, tables.dependencies + i * sizeof(DependencyRecord)) };
+            const std::filesystem::path dependencyPath{
+                std::string_view{
+                    reinterpret_cast<const char*>(bytes.data() + header.stringsOffset + dependency.pathOffset),
+                    dependency.pathSize
+                }
+            };
+            if (!std::filesystem::is_regular_file(dependencyPath, error) ||
+                std::filesystem::file_size(dependencyPath, error) != dependency.size ||
+                modificationTime(dependencyPath) != dependency.modificationTime)
+            {
+                return std::nullopt;
+            }
+        }
+        return model;
+    }
+
+    void CookedModel::store(const std::filesystem::path& sourcePath,
+                            const std::span<const std::filesystem::path> dependencies,
+                            const std::span<const ModelNode> nodes,
+                            const std::span<const CookedMesh> meshes)
+    {
+        if (s_cacheDirectory.empty())
+        {
+            return;
+        }
+
+        std::string strings{};
+        const auto addString{
+            [&strings](const std::filesystem::path& path)
+            {
+                const auto offset{ strings.size() };
+                strings += path.string();
+                return std::pair<uint64_t, uint64_t>{ offset, strings.size() - offset };
+            }
+        };
+
+        FileHeader header{
+            .magic = COOKED_MODEL_MAGIC,
+            .version = COOKED_MODEL_VERSION,
+            .vertexSize = sizeof(Vertex),
+            .dependencyCount = static_cast<uint32_t>(dependencies.size()),
+            .nodeCount = static_cast<uint32_t>(nodes.size()),
+            .meshCount = static_cast<uint32_t>(meshes.size()),
+            .lodCount = 0,
+            .textureCount = 0,
+            .stringsOffset = 0,
+            .stringsSize = 0
+        };
+        for (const auto& mesh : meshes)
+        {
+            header.lodCount += static_cast<uint32_t>(mesh.lods.size());
+            header.textureCount += static_cast<uint32_t>(mesh.textures.size());
+        }
+
+        std::vector<DependencyRecord> dependencyRecords{};
+        for (const auto& dependency : dependencies)
+        {
+            const auto [pathOffset, pathSize]{ addString(dependency) };
+            dependencyRecords.push_back({
+                .pathOffset = pathOffset,
+                .pathSize = pathSize,
+                .size = std::filesystem::file_size(dependency),
+                .modificationTime = modificationTime(dependency)
+            });
+        }
+
+        std::vector<MeshRecord> meshRecords{};
+        std::vector<LodRecord> lodRecords{};
+        std::vector<TextureRecord> textureRecords{};
+        for (const auto& mesh : meshes)
+        {
+            meshRecords.push_back({
+                .vertexOffset = 0,
+                .vertexCount = mesh.vertices.size(),
+                .indexOffset = 0,
+                .indexCount = mesh.indices.size(),
+                .firstLod = static_cast<uint32_t>(lodRecords.size()),
+                .lodCount = static_cast<uint32_t>(mesh.lods.size()),
+                .firstTexture = static_cast<uint32_t>(textureRecords.size()),
+                .textureCount = static_cast<uint32_t>(mesh.textures.size()),
+                .triangleList = static_cast<uint32_t>(mesh.triangleList)
+            });
+            for (const auto& lod : mesh.lods)
+            {
+                lodRecords.push_back({ .firstIndex = lod.firstIndex, .indexCount = lod.indexCount, .error = lod.error });
+            }
+            for (const auto& texture : mesh.textures)
+            {
+                const auto [pathOffset, pathSize]{ addString(texture.path) };
+                textureRecords.push_back({
+                    .pathOffset = pathOffset,
+                    .pathSize = pathSize,
+                    .type = static_cast<uint32_t>(texture.type)
+                });
+            }
+        }
+
+        // Tables, strings, then every vertex and index array aligned for the mapping
+        const auto tables{ Tables::of(header) };
+        header.stringsOffset = tables.end;
+        header.stringsSize = strings.size();
+        auto offset{ alignUp(tables.end + strings.size(), BLOB_ALIGNMENT) };
+        for (auto&& [record, mesh] : std::views::zip(meshRecords, meshes))
+        {
+            record.vertexOffset = offset;
+            offset = alignUp(offset + mesh.vertices.size_bytes(), BLOB_ALIGNMENT);
+            record.indexOffset = offset;
+            offset = alignUp(offset + mesh.indices.size_bytes(), BLOB_ALIGNMENT);
+        }
+
+        std::vector<std::byte> bytes(offset);
+        writeAt(bytes, 0, header);
+        for (std::size_t i{ 0 }; i < dependencyRecords.size(); ++i)
+        {
+            writeAt(bytes, tables.dependencies + i * sizeof(DependencyRecord), dependencyRecords[i]);
+        }
+        for (std::size_t i{ 0 }; i < nodes.size(); ++i)
+        {
+            writeAt(bytes, tables.nodes + i * sizeof(ModelNode), nodes[i]);
+        }
+        for (std::size_t i{ 0 }; i < meshRecords.size(); ++i)
+        {
+            writeAt(bytes, tables.meshes + i * sizeof(MeshRecord), meshRecords[i]);
+            std::memcpy(bytes.data() + meshRecords[i].vertexOffset,
+                        meshes[i].vertices.data(),
+                        meshes[i].vertices.size_bytes());
+            std::memcpy(bytes.data() + meshRecords[i].indexOffset,
+                        meshes[i].indices.data(),
+                        meshes[i].indices.size_bytes());
+        }
+        for (std::size_t i{ 0 }; i < lodRecords.size(); ++i)
+        {
+            writeAt(bytes, tables.lods + i * sizeof(LodRecord), lodRecords[i]);
+        }
+        for (std::size_t i{ 0 }; i < textureRecords.size(); ++i)
+        {
+            writeAt(bytes, tables.textures + i * sizeof(TextureRecord), textureRecords[i]);
+        }
+        std::memcpy(bytes.data() + header.stringsOffset, strings.data(), strings.size());
+
+        writeAllAtomically(cachePath(sourcePath), bytes);
+    }
+
+    void CookedModel::setCacheDirectory(std::filesystem::path directory)
+    {
+        s_cacheDirectory = std::move(directory);
+    }
+
+    const std::filesystem::path& CookedModel::cacheDirectory() noexcept
+    {
+        return s_cacheDirectory;
+    }
+
+    std::filesystem::path CookedModel::cachePath(const std::filesystem::path& sourcePath)
+    {
+        const auto absolutePath{ std::filesystem::absolute(sourcePath).lexically_normal() };
+        return s_cacheDirectory / std::format("{:016x}.lglm", hash64(absolutePath.generic_string()));
+    }
+
+    std::span<const ModelNode> CookedModel::nodes() const noexcept
+    {
+        return m_nodes;
+    }
+
+    std::span<const CookedMesh> CookedModel::meshes() const noexcept
+    {
+        return m_meshes;
+    }
+
+    CookedModel::CookedModel(MappedFile file)
+        : m_file{ std::move(file) }
+    {
+    }
+
+    bool CookedModel::parse()
+    {
+        const auto bytes{ m_file.bytes() };
+        if (bytes.size() < sizeof(FileHeader))
+        {
+            return false;
+        }
+        const auto header{ readAt<FileHeader>(bytes, 0) };
+        const auto tables{ Tables::of(header) };
+        if (header.magic != COOKED_MODEL_MAGIC || header.version != COOKED_MODEL_VERSION ||
+            header.vertexSize != sizeof(Vertex) || header.stringsOffset < tables.end ||
+            !contains(bytes, 0, tables.end) || !contains(bytes, header.stringsOffset, header.stringsSize))
+        {
+            return false;
+        }
+
+        const auto string{
+            [&](const uint64_t offset, const uint64_t size) -> std::optional<std::string_view>
+            {
+                if (offset > header.stringsSize || size > header.stringsSize - offset)
+                {
+                    return std::nullopt;
+                }
+                return std::string_view{
+                    reinterpret_cast<const char*>(bytes.data() + header.stringsOffset + offset),
+                    size
+                };
+            }
+        };
+        for (std::size_t i{ 0 }; i < header.dependencyCount; ++i)
+        {
+            const auto dependency{ readAt<DependencyRecord>(bytes, tables.dependencies + i * sizeof(DependencyRecord)) };
+            if (!string(dependency.pathOffset, dependency.pathSize))
+            {
+                return false;
+            }
+        }
+
+        m_nodes.clear();
+        for (std::size_t i{ 0 }; i < header.nodeCount; ++i)
+        {
+            const auto node{ readAt<ModelNode>(bytes, tables.nodes + i * sizeof(ModelNode)) };
+            if (node.firstMesh > header.meshCount || node.meshCount > header.meshCount - node.firstMesh)
+            {
+                return false;
+            }
+            m_nodes.push_back(node);
+        }
+
+        m_meshes.clear();
+        m_meshes.reserve(header.meshCount);
+        for (std::size_t i{ 0 }; i < header.meshCount; ++i)
+        {
+            const auto mesh{ readAt<MeshRecord>(bytes, tables.meshes + i * sizeof(MeshRecord)) };
+            if (mesh.vertexOffset % alignof(Vertex) != 0 || mesh.indexOffset % alignof(uint32_t) != 0 ||
+                mesh.vertexCount > bytes.size() / sizeof(Vertex) || mesh.indexCount > bytes.size() / sizeof(uint32_t) ||
+                !contains(bytes, mesh.vertexOffset, mesh.vertexCount * sizeof(Vertex)) ||
+                !contains(bytes, mesh.indexOffset, mesh.indexCount * sizeof(uint32_t)) ||
+                mesh.firstLod > header.lodCount || mesh.lodCount > header.lodCount - mesh.firstLod ||
+                mesh.firstTexture > header.textureCount || mesh.textureCount > header.textureCount - mesh.firstTexture ||
+                mesh.triangleList > 1)
+            {
+                return false;
+            }
+
+            // Plain data written by store with the same layout; the mapping is page-aligned
+            CookedMesh cooked{
+                .vertices = {
+                    reinterpret_cast<const Vertex*>(bytes.data() + mesh.vertexOffset),
+                    static_cast<std::size_t>(mesh.vertexCount)
+                },
+                .indices = {
+                    reinterpret_cast<const uint32_t*>(bytes.data() + mesh.indexOffset),
+                    static_cast<std::size_t>(mesh.indexCount)
+                },
+                .lods = {},
+                .textures = {},
+                .triangleList = mesh.triangleList == 1
+            };
+            for (std::size_t j{ mesh.firstLod }; j < mesh.firstLod + mesh.lodCount; ++j)
+            {
+                const auto lod{ readAt<LodRecord>(bytes, tables.lods + j * sizeof(LodRecord)) };
+                if (lod.firstIndex > mesh.indexCount || lod.indexCount > mesh.indexCount - lod.firstIndex)
+                {
+                    return false;
+                }
+                cooked.lods.push_back({ .firstIndex = lod.firstIndex, .indexCount = lod.indexCount, .error = lod.error });
+            }
+            for (std::size_t j{ mesh.firstTexture }; j < mesh.firstTexture + mesh.textureCount; ++j)
+            {
+                const auto texture{ readAt<TextureRecord>(bytes, tables.textures + j * sizeof(TextureRecord)) };
+                const auto path{ string(texture.pathOffset, texture.pathSize) };
+                if (!path || texture.type >= static_cast<uint32_t>(Texture::Type::Size))
+                {
+                    return false;
+                }
+                cooked.textures.push_back({ .path = *path, .type = static_cast<Texture::Type>(texture.type) });
+            }
+            if (cooked.lods.empty())
+            {
+                return false;
+            }
+            m_meshes.push_back(std::move(cooked));
+        }
+        return true;
+    }
+} // lgl
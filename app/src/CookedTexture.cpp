@@ -0,0 +1,496 @@
+//
+// Created by user on 10/17/26.
+//
+
+#include "app/CookedTexture.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <print>
+#include <ranges>
+#include <type_traits>
+#include "app/Mipmap.h"
+#include "app/TextureCompression.h"
+#include "app/utilities.h"
+
+namespace
+{
+    constexpr std::array COOKED_TEXTURE_MAGIC{ 'L', 'G', 'L', 'T' };
+    constexpr uint32_t COOKED_TEXTURE_VERSION{ 3 };
+    constexpr std::size_t LEVEL_ALIGNMENT{ 16 };
+
+    struct FileHeader
+    {
+        std::array<char, 4> magic;
+        uint32_t version;
+        uint64_t sourceSize;
+        int64_t sourceModificationTime;
+        uint64_t contentHash;
+        uint32_t width;
+        uint32_t height;
+        uint32_t pixelFormat;
+        uint32_t levelCount;
+        uint32_t mipmapOptions;
+        uint32_t compressedFormat;
+    };
+
+    struct LevelHeader
+    {
+        uint64_t offset;
+        uint64_t size;
+        uint32_t width;
+        uint32_t height;
+    };
+
+    static_assert(std::is_trivially_copyable_v<FileHeader> && std::is_trivially_copyable_v<LevelHeader>);
+
+    constexpr std::size_t alignUp(const std::size_t value, const std::size_t alignment) noexcept
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    constexpr uint32_t pack(const lgl::MipmapOptions& options) noexcept
+    {
+        return static_cast<uint32_t>(options.filter) |
+               static_cast<uint32_t>(options.colorSpace) << 8 |
+               static_cast<uint32_t>(options.normalMap) << 16;
+    }
+
+    // std::nullopt unless every field holds an enumerator and no other bits are set
+    constexpr std::optional<lgl::MipmapOptions> unpack(const uint32_t options) noexcept
+    {
+        const auto filter{ options & 0xFF };
+        const auto colorSpace{ options >> 8 & 0xFF };
+        const auto normalMap{ options >> 16 };
+        if (filter > static_cast<uint32_t>(lgl::MipmapOptions::Filter::Kaiser) ||
+            colorSpace > static_cast<uint32_t>(lgl::MipmapOptions::ColorSpace::SRGB) || normalMap > 1)
+        {
+            return std::nullopt;
+        }
+        return lgl::MipmapOptions{
+            .filter = static_cast<lgl::MipmapOptions::Filter>(filter),
+            .colorSpace = static_cast<lgl::MipmapOptions::ColorSpace>(colorSpace),
+            .normalMap = normalMap != 0
+        };
+    }
+
+    // Bytes a level of raw pixels holds; rows are tightly packed
+    constexpr std::size_t rawLevelSize(const lgl::PixelFormat pixelFormat,
+                                       const uint32_t width,
+                                       const uint32_t height) noexcept
+    {
+        return static_cast<std::size_t>(width) * height * lgl::channelCount(pixelFormat);
+    }
+
+    // Reverses the order of height rows of rowSize bytes each
+    void flipRows(const std::span<std::byte> bytes, const std::size_t rowSize, const uint32_t height) noexcept
+    {
+        for (uint32_t y{ 0 }; y < height / 2; ++y)
+        {
+            std::swap_ranges(bytes.begin() + static_cast<std::ptrdiff_t>(y * rowSize),
+                             bytes.begin() + static_cast<std::ptrdiff_t>((y + 1) * rowSize),
+                             bytes.begin() + static_cast<std::ptrdiff_t>((height - 1 - y) * rowSize));
+        }
+    }
+
+    int64_t modificationTime(const std::filesystem::path& path)
+    {
+        return std::filesystem::last_write_time(path).time_since_epoch().count();
+    }
+
+    // Overwrites the source timestamp of a cooked file in place; a failure only costs hashing the source next time
+    void storeModificationTime(const std::filesystem::path& path, const int64_t sourceModificationTime)
+    {
+        std::fstream file{ path, std::ios::binary | std::ios::in | std::ios::out };
+        file.seekp(offsetof(FileHeader, sourceModificationTime));
+        if (!file.write(reinterpret_cast<const char*>(&sourceModificationTime), sizeof(sourceModificationTime)))
+        {
+            std::println(stderr, "Failed to update the source timestamp of '{}'", path.string());
+        }
+    }
+
+    template<typename T>
+    T readAt(const std::span<const std::byte> bytes, const std::size_t offset) noexcept
+    {
+        T value{};
+        std::memcpy(&value, bytes.data() + offset, sizeof(T));
+        return value;
+    }
+
+    template<typename T>
+    void writeAt(std::vector<std::byte>& bytes, const std::size_t offset, const T& value) noexcept
+    {
+        std::memcpy(bytes.data() + offset, &value, sizeof(T));
+    }
+
+    // Encodes every level, logging the quality of the base level and the encoder throughput
+    std::vector<std::vector<std::byte>> compressLevels(const std::filesystem::path& sourcePath,
+                                                       const std::span<const lgl::ImageData> chain,
+                                                       const lgl::CompressedFormat format)
+    {
+        const auto start{ std::chrono::steady_clock::now() };
+        std::vector<std::vector<std::byte>> blocks{};
+        blocks.reserve(chain.size());
+        std::size_t pixelCount{ 0 };
+        for (const auto& level : chain)
+        {
+            blocks.push_back(lgl::compress(level, format));
+            pixelCount += static_cast<std::size_t>(level.width) * level.height;
+        }
+        const std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+
+        const auto& base{ chain.front() };
+        std::println("[Texture] '{}': {} {}x{}, {:.1f} MPix/s, PSNR {:.2f} dB",
+                     sourcePath.filename().string(),
+                     format,
+                     base.width,
+                     base.height,
+                     static_cast<double>(pixelCount) / 1e6 / std::max(elapsed.count(), 1e-9),
+                     lgl::psnr(base, lgl::decompress(blocks.front(), base.width, base.height, format)));
+        return blocks;
+    }
+}
+
+namespace lgl
+{
+    std::filesystem::path CookedTexture::s_cacheDirectory{ "cache/textures" };
+
+    std::optional<CookedTexture> CookedTexture::load(const std::filesystem::path& sourcePath,
+                                                     const MipmapOptions& options,
+                                                     const std::optional<CompressedFormat> compression)
+    {
+        if (s_cacheDirectory.empty())
+        {
+            return std::nullopt;
+        }
+
+        const auto path{ cachePath(sourcePath, options, compression) };
+        std::error_code error{};
+        if (!std::filesystem::is_regular_file(path, error))
+        {
+            return std::nullopt;
+        }
+
+        CookedTexture texture{};
+        const auto map{
+            [&]
+            {
+                try
+                {
+                    texture.m_storage = MappedFile::open(path);
+                }
+                catch (const std::exception& e)
+                {
+                    std::println(stderr, "Ignoring unreadable cooked texture '{}': {}", path.string(), e.what());
+                    return false;
+                }
+                return texture.parse();
+            }
+        };
+        if (!map() || texture.m_mipmapOptions != options ||
+            texture.m_compressedFormat !=
+            compression.value_or(automaticCompressedFormat(texture.m_pixelFormat, options.normalMap)))
+        {
+            return std::nullopt;
+        }
+
+        const auto bytes{ std::get<MappedFile>(texture.m_storage).bytes() };
+        const auto header{ readAt<FileHeader>(bytes, 0) };
+        if (header.sourceSize != std::filesystem::file_size(sourcePath))
+        {
+            return std::nullopt;
+        }
+        if (const auto sourceModificationTime{ modificationTime(sourcePath) };
+            header.sourceModificationTime != sourceModificationTime)
+        {
+            // Same size and a new timestamp is still a hit when the content is unchanged
+            if (header.contentHash != hash64(MappedFile::open(sourcePath).bytes()))
+            {
+                return std::nullopt;
+            }
+            // Record the new timestamp so later loads skip hashing the source; the file is unmapped while it is
+            // patched, which some platforms require
+            texture.m_storage = std::vector<std::byte>{};
+            storeModificationTime(path, sourceModificationTime);
+            if (!map())
+            {
+                return std::nullopt;
+            }
+        }
+        return texture;
+    }
+
+    CookedTexture CookedTexture::cook(const std::filesystem::path& sourcePath,
+                                      ImageData image,
+                                      const MipmapOptions& options,
+                                      const std::optional<CompressedFormat> compression)
+    {
+        const auto pixelFormat{ image.pixelFormat };
+        const auto compressedFormat{
+            compression.value_or(automaticCompressedFormat(pixelFormat, options.normalMap))
+        };
+        const auto chain{ generateMipChain(std::move(image), options) };
+
+        // Level payloads: the pixels themselves, or their blocks
+        const auto blocks{
+            compressedFormat == CompressedFormat::None
+            ? std::vector<std::vector<std::byte>>{}
+            : compressLevels(sourcePath, chain, compressedFormat)
+        };
+        const auto payload{
+            [&](const std::size_t level) -> std::span<const std::byte>
+            {
+                return blocks.empty() ? chain[level].span() : blocks[level];
+            }
+        };
+
+        // Header, level table, then each level aligned for the upload
+        auto offset{ alignUp(sizeof(FileHeader) + chain.size() * sizeof(LevelHeader), LEVEL_ALIGNMENT) };
+        std::vector<LevelHeader> levelHeaders{};
+        levelHeaders.reserve(chain.size());
+        for (auto&& [index, level] : std::views::enumerate(chain))
+        {
+            const auto size{ payload(static_cast<std::size_t>(index)).size() };
+            levelHeaders.push_back({
+                .offset = offset,
+                .size = size,
+                .width = level.width,
+                .height = level.height
+            });
+            offset = alignUp(offset + size, LEVEL_ALIGNMENT);
+        }
+
+        const FileHeader header{
+            .magic = COOKED_TEXTURE_MAGIC,
+            .version = COOKED_TEXTURE_VERSION,
+            .sourceSize = std::filesystem::file_size(sourcePath),
+            .sourceModificationTime = modificationTime(sourcePath),
+            .contentHash = hash64(MappedFile::open(sourcePath).bytes()),
+            .width = chain.front().width,
+            .height = chain.front().height,
+            .pixelFormat = static_cast<uint32_t>(pixelFormat),
+            .levelCount = static_cast<uint32_t>(chain.size()),
+            .mipmapOptions = pack(options),
+            .compressedFormat = static_cast<uint32_t>(compressedFormat)
+        };
+
+        std::vector<std::byte> bytes(offset);
+        writeAt(bytes, 0, header);
+        for (std::size_t i{ 0 }; i < chain.size(); ++i)
+        {
+            writeAt(bytes, sizeof(FileHeader) + i * sizeof(LevelHeader), levelHeaders[i]);
+            std::memcpy(bytes.data() + levelHeaders[i].offset, payload(i).data(), payload(i).size());
+        }
+
+        if (!s_cacheDirectory.empty())
+        {
+            writeAllAtomically(cachePath(sourcePath, options, compression), bytes);
+        }
+
+        CookedTexture texture{};
+        texture.m_storage = std::move(bytes);
+        if (!texture.parse())
+        {
+            throw std::runtime_error("Failed to cook texture");
+        }
+        return texture;
+    }
+
+    CookedTexture CookedTexture::fromContainer(const std::filesystem::path& sourcePath, TextureContainer container)
+    {
+        CookedTexture texture{};
+        texture.m_pixelFormat = container.pixelFormat;
+        texture.m_compressedFormat = container.compressedFormat;
+        // Hashing the whole mapping would touch every page of a file that is otherwise uploaded straight from it
+        const std::array<uint64_t, 3> identity{
+            hash64(sourcePath.generic_string()),
+            static_cast<uint64_t>(container.file.size()),
+            static_cast<uint64_t>(modificationTime(sourcePath))
+        };
+        texture.m_contentHash = hash64(std::as_bytes(std::span{ identity }));
+        if (container.rowOrder == ImageData::RowOrder::BottomUp)
+        {
+            texture.m_storage = std::move(container.file);
+            texture.m_levels = std::move(container.levels);
+            return texture;
+        }
+
+        // Top-down levels are flipped in a copy; blocks that cannot be flipped as they are get decoded first
+        const auto format{ container.compressedFormat };
+        const auto flippable{
+            [format](const MipLevel& level)
+            {
+                return isVerticallyFlippable(format, level.height);
+            }
+        };
+        const auto decode{ format != CompressedFormat::None && !std::ranges::all_of(container.levels, flippable) };
+        if (decode)
+        {
+            texture.m_pixelFormat = ImageData::getPixelFormat(channelCount(format));
+            texture.m_compressedFormat = CompressedFormat::None;
+        }
+
+        std::vector<std::byte> bytes{};
+        std::vector<std::size_t> offsets{};
+        offsets.reserve(container.levels.size() + 1);
+        for (const auto& level : container.levels)
+        {
+            offsets.push_back(bytes.size());
+            if (decode)
+            {
+                auto image{ decompress(level.data, level.width, level.height, format) };
+                image.flipVerticallyInPlace();
+                bytes.insert(bytes.end(), image.data.begin(), image.data.end());
+                continue;
+            }
+
+            bytes.insert(bytes.end(), level.data.begin(), level.data.end());
+            const std::span levelBytes{ bytes.begin() + static_cast<std::ptrdiff_t>(offsets.back()), bytes.end() };
+            if (format == CompressedFormat::None)
+            {
+                flipRows(levelBytes, rawLevelSize(container.pixelFormat, level.width, 1), level.height);
+            }
+            else
+            {
+                flipVertically(levelBytes, level.width, level.height, format);
+            }
+        }
+        offsets.push_back(bytes.size());
+
+        texture.m_storage = std::move(bytes);
+        const std::span<const std::byte> storage{ std::get<std::vector<std::byte>>(texture.m_storage) };
+        for (auto&& [index, level] : std::views::enumerate(container.levels))
+        {
+            const auto i{ static_cast<std::size_t>(index) };
+            texture.m_levels.push_back({
+                .width = level.width,
+                .height = level.height,
+                .data = storage.subspan(offsets[i], offsets[i + 1] - offsets[i])
+            });
+        }
+        return texture;
+    }
+
+    void CookedTexture::setCacheDirectory(std::filesystem::path directory)
+    {
+        s_cacheDirectory = std::move(directory);
+    }
+
+    const std::filesystem::path& CookedTexture::cacheDirectory() noexcept
+    {
+        return s_cacheDirectory;
+    }
+
+    std::filesystem::path CookedTexture::cachePath(const std::filesystem::path& sourcePath,
+                                                   const MipmapOptions& options,
+                                                   const std::optional<CompressedFormat> compression)
+    {
+        const std::array<uint64_t, 3> key{
+            hash64(sourcePath.generic_string()),
+            pack(options),
+            compression.has_value() ? static_cast<uint64_t>(*compression) + 1 : 0
+        };
+        return s_cacheDirectory / std::format("{:016x}.lglt", hash64(std::as_bytes(std::span{ key })));
+    }
+
+    PixelFormat CookedTexture::pixelFormat() const noexcept
+    {
+        return m_pixelFormat;
+    }
+
+    CompressedFormat CookedTexture::compressedFormat() const noexcept
+    {
+        return m_compressedFormat;
+    }
+
+    std::span<const MipLevel> CookedTexture::levels() const noexcept
+    {
+        return m_levels;
+    }
+
+    uint64_t CookedTexture::contentHash() const noexcept
+    {
+        return m_contentHash;
+    }
+
+    const MipmapOptions& CookedTexture::mipmapOptions() const noexcept
+    {
+        return m_mipmapOptions;
+    }
+
+    bool CookedTexture::isMapped() const noexcept
+    {
+        return std::holds_alternative<MappedFile>(m_storage);
+    }
+
+    bool CookedTexture::parse()
+    {
+        const auto bytes{
+            std::visit([]<typename T>(const T& storage) -> std::span<const std::byte>
+            {
+                if constexpr (std::is_same_v<T, MappedFile>)
+                {
+                    return storage.bytes();
+                }
+                else
+                {
+                    return storage;
+                }
+            }, m_storage)
+        };
+
+        if (bytes.size() < sizeof(FileHeader))
+        {
+            return false;
+        }
+
+        // The upload trusts every level to hold exactly its pixels or blocks, so nothing is taken from a corrupt,
+        // truncated or edited file unless it describes a mip chain the driver can read without over-reading
+        const auto header{ readAt<FileHeader>(bytes, 0) };
+        const auto pixelFormat{ static_cast<PixelFormat>(header.pixelFormat) };
+        const auto compressedFormat{ static_cast<CompressedFormat>(header.compressedFormat) };
+        const auto mipmapOptions{ unpack(header.mipmapOptions) };
+        if (header.magic != COOKED_TEXTURE_MAGIC || header.version != COOKED_TEXTURE_VERSION ||
+            header.width == 0 || header.height == 0 || channelCount(pixelFormat) == 0 || !mipmapOptions ||
+            header.compressedFormat > static_cast<uint32_t>(CompressedFormat::BC7) ||
+            header.levelCount == 0 || header.levelCount > mipLevelCount(header.width, header.height) ||
+            bytes.size() < sizeof(FileHeader) + header.levelCount * sizeof(LevelHeader))
+        {
+            return false;
+        }
+
+        m_levels.clear();
+        m_levels.reserve(header.levelCount);
+        for (uint32_t i{ 0 }; i < header.levelCount; ++i)
+        {
+            const auto level{ readAt<LevelHeader>(bytes, sizeof(FileHeader) + i * sizeof(LevelHeader)) };
+            const auto width{ std::max(header.width >> i, 1u) };
+            const auto height{ std::max(header.height >> i, 1u) };
+            const auto size{
+                compressedFormat == CompressedFormat::None
+                ? rawLevelSize(pixelFormat, width, height)
+                : compressedSize(compressedFormat, width, height)
+            };
+            if (level.width != width || level.height != height || level.size != size ||
+                level.offset > bytes.size() || level.size > bytes.size() - level.offset)
+            {
+                return false;
+            }
+            m_levels.push_back({
+                .width = width,
+                .height = height,
+                .data = bytes.subspan(level.offset, level.size)
+            });
+        }
+        m_pixelFormat = pixelFormat;
+        m_compressedFormat = compressedFormat;
+        m_contentHash = header.contentHash;
+        m_mipmapOptions = *mipmapOptions;
+        return true;
+    }
+} // lgl
@@ -0,0 +1,43 @@
+//
+// Created by user on 10/17/26.
+//
+
+#include "app/Frustum.h"
+
+#include <glm/geometric.hpp>
+#include <glm/matrix.hpp>
+
+namespace lgl
+{
+    Frustum Frustum::fromMatrix(const glm::mat4& matrix) noexcept
+    {
+        const auto rows{ glm::transpose(matrix) };
+        Frustum frustum{
+            .planes = {
+                rows[3] + rows[0], // Left
+                rows[3] - rows[0], // Right
+                rows[3] + rows[1], // Bottom
+                rows[3] - rows[1], // Top
+                rows[3] + rows[2], // Near
+                rows[3] - rows[2] // Far
+            }
+        };
+        for (auto& plane : frustum.planes)
+        {
+            plane /= glm::length(glm::vec3{ plane });
+        }
+        return frustum;
+    }
+
+    bool Frustum::intersects(const BoundingSphere& sphere) const noexcept
+    {
+        for (const auto& plane : planes)
+        {
+            if (glm::dot(glm::vec3{ plane }, sphere.center) + plane.w < -sphere.radius)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+} // lgl
@@ -0,0 +1,72 @@
+//
+// Created by user on 10/17/26.
+//
+
+#include "app/GLCapabilities.h"
+
+#include <GLFW/glfw3.h>
+
+namespace lgl
+{
+    const GLCapabilities& GLCapabilities::current()
+    {
+        static const GLCapabilities capabilities{};
+        return capabilities;
+    }
+
+    GLCapabilities::GLCapabilities()
+    {
+        glGetIntegerv(GL_MAJOR_VERSION, &m_majorVersion);
+        glGetIntegerv(GL_MINOR_VERSION, &m_minorVersion);
+
+        GLint extensionCount{ 0 };
+        glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+        for (GLint i{ 0 }; i < extensionCount; ++i)
+        {
+            if (const auto* name{ glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)) }; name != nullptr)
+            {
+                m_extensions.emplace(reinterpret_cast<const char*>(name));
+            }
+        }
+
+        // The loader only covers OpenGL 3.3, so newer entry points are fetched here
+        if (isVersionAtLeast(4, 3) || hasExtension("GL_ARB_multi_draw_indirect"))
+        {
+            m_multiDrawElementsIndirect = reinterpret_cast<MultiDrawElementsIndirectFunction>(
+                glfwGetProcAddress("glMultiDrawElementsIndirect"));
+        }
+    }
+
+    bool GLCapabilities::hasExtension(const std::string_view name) const
+    {
+        return m_extensions.contains(std::string{ name });
+    }
+
+    bool GLCapabilities::isVersionAtLeast(const GLint major, const GLint minor) const noexcept
+    {
+        return m_majorVersion > major || (m_majorVersion == major && m_minorVersion >= minor);
+    }
+
+    bool GLCapabilities::supports(const CompressedFormat format) const
+    {
+        switch (format)
+        {
+            case CompressedFormat::BC1:
+            case CompressedFormat::BC3:
+                return hasExtension("GL_EXT_texture_compression_s3tc");
+            case CompressedFormat::BC4:
+            case CompressedFormat::BC5:
+                // RGTC is core since OpenGL 3.0
+                return true;
+            case CompressedFormat::BC7:
+                return isVersionAtLeast(4, 2) || hasExtension("GL_ARB_texture_compression_bptc");
+            default:
+                return false;
+        }
+    }
+
+    MultiDrawElementsIndirectFunction GLCapabilities::multiDrawElementsIndirect() const noexcept
+    {
+        return m_multiDrawElementsIndirect;
+    }
+} // lgl
@@ -0,0 +1,310 @@
+//
+// Created by user on 10/17/26.
+//
+
+#include "app/GeometryBuffer.h"
+
+#include <algorithm>
+#include <iterator>
+#include <print>
+#include <stdexcept>
+#include <utility>
+
+namespace
+{
+    // Elements the buffers start with, so small models do not grow them one mesh at a time
+    constexpr std::size_t INITIAL_CAPACITY{ 1 << 16 };
+
+    // Replaces buffer with a larger one holding the same contents; binds only the copy targets,
+    // so no vertex array is modified
+    void growBuffer(GLuint& buffer, const std::size_t oldSize, const std::size_t newSize)
+    {
+        GLuint grown{};
+        glGenBuffers(1, &grown);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, grown);
+        glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(newSize), nullptr, GL_STATIC_DRAW);
+        if (buffer != 0 && oldSize > 0)
+        {
+            glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, static_cast<GLsizeiptr>(oldSize));
+            glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        }
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        glDeleteBuffers(1, &buffer);
+        buffer = grown;
+    }
+
+    void uploadRange(const GLuint buffer, const std::size_t offset, const std::span<const std::byte> bytes)
+    {
+        if (bytes.empty())
+        {
+            return;
+        }
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glBufferSubData(GL_COPY_WRITE_BUFFER,
+                        static_cast<GLintptr>(offset),
+                        static_cast<GLsizeiptr>(bytes.size()),
+                        bytes.data());
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+}
+
+namespace lgl
+{
+    RangeAllocator::RangeAllocator(const std::size_t capacity)
+    {
+        grow(capacity);
+    }
+
+    std::optional<std::size_t> RangeAllocator::allocate(const std::size_t count, const std::size_t alignment)
+    {
+        if (count == 0)
+        {
+            return 0;
+        }
+        const auto alignedOffset{
+            [alignment](const std::size_t offset)
+            {
+                return (offset + alignment - 1) / alignment * alignment;
+            }
+        };
+        const auto range{
+            std::ranges::find_if(m_free,
+                                 [&](const auto& entry)
+                                 {
+                                     const auto& [offset, size]{ entry };
+                                     return alignedOffset(offset) + count <= offset + size;
+                                 })
+        };
+        if (range == m_free.end())
+        {
+            return std::nullopt;
+        }
+
+        const auto [offset, size]{ *range };
+        const auto allocated{ alignedOffset(offset) };
+        m_free.erase(range);
+        // Padding in front of an aligned range stays free
+        if (allocated > offset)
+        {
+            m_free.emplace(offset, allocated - offset);
+        }
+        if (offset + size > allocated + count)
+        {
+            m_free.emplace(allocated + count, offset + size - allocated - count);
+        }
+        m_used += count;
+        return allocated;
+    }
+
+    void RangeAllocator::free(const std::size_t offset, const std::size_t count)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+        insertFree(offset, count);
+        m_used -= count;
+    }
+
+    void RangeAllocator::grow(const std::size_t capacity)
+    {
+        if (capacity <= m_capacity)
+        {
+            return;
+        }
+        insertFree(m_capacity, capacity - m_capacity);
+        m_capacity = capacity;
+    }
+
+    std::size_t RangeAllocator::capacity() const noexcept
+    {
+        return m_capacity;
+    }
+
+    std::size_t RangeAllocator::used() const noexcept
+    {
+        return m_used;
+    }
+
+    void RangeAllocator::insertFree(std::size_t offset, std::size_t count)
+    {
+        auto next{ m_free.lower_bound(offset) };
+        if (next != m_free.begin())
+        {
+            if (const auto previous{ std::prev(next) }; previous->first + previous->second == offset)
+            {
+                offset = previous->first;
+                count += previous->second;
+                m_free.erase(previous);
+            }
+        }
+        if (next != m_free.end() && offset + count == next->first)
+        {
+            count += next->second;
+            m_free.erase(next);
+        }
+        m_free.emplace(offset, count);
+    }
+
+    GeometryBuffer::GeometryBuffer(const std::size_t vertexSize, void (*enableAttributes)())
+        : m_vertexSize{ vertexSize },
+          m_enableAttributes{ enableAttributes }
+    {
+        glGenVertexArrays(1, &m_vertexArrayObject);
+    }
+
+    GeometryBuffer::GeometryBuffer(GeometryBuffer&& other) noexcept
+        : m_vertexSize{ other.m_vertexSize },
+          m_enableAttributes{ other.m_enableAttributes },
+          m_vertices{ std::move(other.m_vertices) },
+          m_indices{ std::move(other.m_indices) },
+          m_vertexArrayObject{ std::exchange(other.m_vertexArrayObject, 0) },
+          m_vertexBufferObject{ std::exchange(other.m_vertexBufferObject, 0) },
+          m_elementBufferObject{ std::exchange(other.m_elementBufferObject, 0) }
+    {
+    }
+
+    GeometryBuffer& GeometryBuffer::operator=(GeometryBuffer&& other) noexcept
+    {
+        if (this == &other)
+            return *this;
+        release();
+        m_vertexSize = other.m_vertexSize;
+        m_enableAttributes = other.m_enableAttributes;
+        m_vertices = std::move(other.m_vertices);
+        m_indices = std::move(other.m_indices);
+        m_vertexArrayObject = std::exchange(other.m_vertexArrayObject, 0);
+        m_vertexBufferObject = std::exchange(other.m_vertexBufferObject, 0);
+        m_elementBufferObject = std::exchange(other.m_elementBufferObject, 0);
+        return *this;
+    }
+
+    GeometryBuffer::~GeometryBuffer()
+    {
+        release();
+    }
+
+    GeometryBuffer::Allocation GeometryBuffer::allocate(const std::size_t vertexCount,
+                                                        const std::size_t indexCount,
+                                                        const std::size_t indexSize)
+    {
+        auto grown{ false };
+        auto firstVertex{ m_vertices.allocate(vertexCount) };
+        if (!firstVertex)
+        {
+            const auto capacity{
+                std::max({ INITIAL_CAPACITY, m_vertices.capacity() * 2, m_vertices.capacity() + vertexCount })
+            };
+            growBuffer(m_vertexBufferObject, m_vertices.capacity() * m_vertexSize, capacity * m_vertexSize);
+            m_vertices.grow(capacity);
+            firstVertex = m_vertices.allocate(vertexCount);
+            grown = true;
+        }
+
+        const auto indexBytes{ indexCount * indexSize };
+        auto indexOffset{ m_indices.allocate(indexBytes, indexSize) };
+        if (!indexOffset)
+        {
+            // Room for the alignment padding too
+            const auto capacity{
+                std::max({
+                    INITIAL_CAPACITY * sizeof(GLuint),
+                    m_indices.capacity() * 2,
+                    m_indices.capacity() + indexBytes + indexSize
+                })
+            };
+            growBuffer(m_elementBufferObject, m_indices.capacity(), capacity);
+            m_indices.grow(capacity);
+            indexOffset = m_indices.allocate(indexBytes, indexSize);
+            grown = true;
+        }
+
+        if (grown)
+        {
+            attachBuffers();
+        }
+        return {
+            .firstVertex = *firstVertex,
+            .vertexCount = vertexCount,
+            .indexOffset = *indexOffset,
+            .indexBytes = indexBytes
+        };
+    }
+
+    void GeometryBuffer::free(const Allocation& allocation)
+    {
+        m_vertices.free(allocation.firstVertex, allocation.vertexCount);
+        m_indices.free(allocation.indexOffset, allocation.indexBytes);
+    }
+
+    GeometryBuffer::handle_type GeometryBuffer::vertexArray() const noexcept
+    {
+        return m_vertexArrayObject;
+    }
+
+    std::size_t GeometryBuffer::vertexCapacity() const noexcept
+    {
+        return m_vertices.capacity();
+    }
+
+    std::size_t GeometryBuffer::indexCapacity() const noexcept
+    {
+        return m_indices.capacity();
+    }
+
+    std::size_t GeometryBuffer::usedBytes() const noexcept
+    {
+        return m_vertices.used() * m_vertexSize + m_indices.used();
+    }
+
+    void GeometryBuffer::uploadVertexBytes(const Allocation& allocation,
+                                           const std::span<const std::byte> bytes,
+                                           const std::size_t vertexSize)
+    {
+        if (vertexSize != m_vertexSize)
+        {
+            std::println(stderr, "Vertex of {} bytes uploaded to a geometry buffer of {} byte vertices",
+                         vertexSize, m_vertexSize);
+            throw std::invalid_argument("Vertex layout mismatch");
+        }
+        if (bytes.size() > allocation.vertexCount * m_vertexSize)
+        {
+            throw std::out_of_range("More vertices than allocated");
+        }
+        uploadRange(m_vertexBufferObject, allocation.firstVertex * m_vertexSize, bytes);
+    }
+
+    void GeometryBuffer::uploadIndexBytes(const Allocation& allocation, const std::span<const std::byte> bytes)
+    {
+        if (bytes.size() > allocation.indexBytes)
+        {
+            throw std::out_of_range("More indices than allocated");
+        }
+        uploadRange(m_elementBufferObject, allocation.indexOffset, bytes);
+    }
+
+    void GeometryBuffer::attachBuffers() const
+    {
+        if (m_vertexBufferObject == 0 || m_elementBufferObject == 0)
+        {
+            return;
+        }
+        glBindVertexArray(m_vertexArrayObject);
+        glBindBuffer(GL_ARRAY_BUFFER, m_vertexBufferObject);
+        m_enableAttributes();
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_elementBufferObject);
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    void GeometryBuffer::release() noexcept
+    {
+        glDeleteVertexArrays(1, &m_vertexArrayObject);
+        glDeleteBuffers(1, &m_vertexBufferObject);
+        glDeleteBuffers(1, &m_elementBufferObject);
+        m_vertexArrayObject = 0;
+        m_vertexBufferObject = 0;
+        m_elementBufferObject = 0;
+    }
+} // lgl
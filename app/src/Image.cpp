@@ -4,7 +4,287 @@
 
 #include "app/Image.h"
 
-#include <ranges>
+#include <algorithm>
+#include <array>
+#include <csetjmp>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <print>
+#include <jpeglib.h>
+#include <png.h>
+#include "app/TextureContainer.h"
+
+namespace
+{
+    using FileHandle = std::unique_ptr<std::FILE, decltype(&std::fclose)>;
+
+    FileHandle openFile(const std::filesystem::path& path)
+    {
+        FileHandle file{ std::fopen(path.string().c_str(), "rb"), &std::fclose };
+        if (file == nullptr)
+        {
+            throw std::runtime_error("Failed to open file");
+        }
+        return file;
+    }
+
+    // Address of a decoded row inside the final buffer, flipping the row order if requested
+    std::byte* rowAddress(lgl::ImageData& image, const uint32_t row, const bool flipVertically) noexcept
+    {
+        const auto rowSize{ static_cast<std::size_t>(image.width) * image.channels };
+        const auto targetRow{ flipVertically ? image.height - 1 - row : row };
+        return image.data.data() + targetRow * rowSize;
+    }
+
+    // Copies every factor-th pixel of a full-width source row into the given row of the image
+    void decimateRow(lgl::ImageData& image,
+                     const std::byte* sourceRow,
+                     const uint32_t row,
+                     const uint32_t factor,
+                     const bool flipVertically) noexcept
+    {
+        auto* target{ rowAddress(image, row, flipVertically) };
+        const auto pixelStride{ static_cast<std::size_t>(factor) * image.channels };
+        for (uint32_t x{ 0 }; x < image.width; ++x)
+        {
+            std::memcpy(target + static_cast<std::size_t>(x) * image.channels,
+                        sourceRow + x * pixelStride,
+                        image.channels);
+        }
+    }
+
+    struct JpegErrorManager
+    {
+        jpeg_error_mgr base;
+        std::jmp_buf jumpBuffer;
+        char message[JMSG_LENGTH_MAX];
+    };
+
+    void onJpegError(const j_common_ptr info)
+    {
+        auto* errorManager{ reinterpret_cast<JpegErrorManager*>(info->err) };
+        (*info->err->format_message)(info, errorManager->message);
+        std::longjmp(errorManager->jumpBuffer, 1);
+    }
+
+    // libjpeg reports errors through longjmp, so this frame must not own anything with a destructor
+    bool decodeJpeg(std::FILE* file,
+                    JpegErrorManager& errorManager,
+                    lgl::ImageData& image,
+                    const lgl::ImageLoadOptions& options)
+    {
+        jpeg_decompress_struct info{};
+        info.err = jpeg_std_error(&errorManager.base);
+        errorManager.base.error_exit = onJpegError;
+
+        if (setjmp(errorManager.jumpBuffer))
+        {
+            jpeg_destroy_decompress(&info);
+            return false;
+        }
+
+        jpeg_create_decompress(&info);
+        jpeg_stdio_src(&info, file);
+        jpeg_read_header(&info, TRUE);
+
+        switch (info.jpeg_color_space)
+        {
+            case JCS_GRAYSCALE:
+                info.out_color_space = JCS_GRAYSCALE;
+                break;
+            case JCS_CMYK:
+            case JCS_YCCK:
+                std::strncpy(errorManager.message, "CMYK JPEG images are not supported", JMSG_LENGTH_MAX - 1);
+                jpeg_destroy_decompress(&info);
+                return false;
+            default:
+                info.out_color_space = JCS_RGB;
+                break;
+        }
+
+        // DCT scaling skips most of the inverse transform instead of downsampling a full decode
+        info.scale_num = 1;
+        info.scale_denom = lgl::scaleDenominator(info.image_width, info.image_height, options.maxDimension);
+
+        jpeg_start_decompress(&info);
+
+        image.width = info.output_width;
+        image.height = info.output_height;
+        image.channels = static_cast<uint8_t>(info.output_components);
+        image.pixelFormat = lgl::ImageData::getPixelFormat(image.channels);
+        image.rowOrder = options.flipVertically
+                         ? lgl::ImageData::RowOrder::BottomUp
+                         : lgl::ImageData::RowOrder::TopDown;
+        try
+        {
+            image.data.resize(static_cast<std::size_t>(image.width) * image.height * image.channels);
+        }
+        catch (...)
+        {
+            jpeg_destroy_decompress(&info);
+            throw;
+        }
+
+        // Let libjpeg emit as many scanlines per call as its output buffer holds
+        std::array<JSAMPROW, 8> rows{};
+        while (info.output_scanline < info.output_height)
+        {
+            const auto count{
+                std::min(static_cast<JDIMENSION>(rows.size()), info.output_height - info.output_scanline)
+            };
+            for (JDIMENSION i{ 0 }; i < count; ++i)
+            {
+                rows[i] = reinterpret_cast<JSAMPROW>(
+                    rowAddress(image, info.output_scanline + i, options.flipVertically));
+            }
+            jpeg_read_scanlines(&info, rows.data(), count);
+        }
+
+        jpeg_finish_decompress(&info);
+        jpeg_destroy_decompress(&info);
+        return true;
+    }
+
+    struct PngErrorState
+    {
+        char message[256];
+    };
+
+    void onPngError(const png_structp png, const png_const_charp message)
+    {
+        auto* errorState{ static_cast<PngErrorState*>(png_get_error_ptr(png)) };
+        std::strncpy(errorState->message, message, sizeof(errorState->message) - 1);
+        png_longjmp(png, 1);
+    }
+
+    void onPngWarning([[maybe_unused]] const png_structp png, [[maybe_unused]] const png_const_charp message)
+    {
+    }
+
+    // libpng reports errors through longjmp, so this frame must not own anything with a destructor
+    bool decodePng(std::FILE* file,
+                   PngErrorState& errorState,
+                   std::vector<png_bytep>& rows,
+                   std::vector<std::byte>& scratch,
+                   lgl::ImageData& image,
+                   const lgl::ImageLoadOptions& options)
+    {
+        auto png{ png_create_read_struct(PNG_LIBPNG_VER_STRING, &errorState, onPngError, onPngWarning) };
+        if (png == nullptr)
+        {
+            std::strncpy(errorState.message, "Failed to create PNG read struct", sizeof(errorState.message) - 1);
+            return false;
+        }
+        auto info{ png_create_info_struct(png) };
+        if (info == nullptr)
+        {
+            png_destroy_read_struct(&png, nullptr, nullptr);
+            std::strncpy(errorState.message, "Failed to create PNG info struct", sizeof(errorState.message) - 1);
+            return false;
+        }
+
+        if (setjmp(png_jmpbuf(png)))
+        {
+            png_destroy_read_struct(&png, &info, nullptr);
+            return false;
+        }
+
+        png_init_io(png, file);
+        png_read_info(png, info);
+
+        // Normalize every PNG flavor to 8-bit gray, gray + alpha, RGB or RGBA
+        const auto colorType{ png_get_color_type(png, info) };
+        const auto bitDepth{ png_get_bit_depth(png, info) };
+        if (colorType == PNG_COLOR_TYPE_PALETTE)
+        {
+            png_set_palette_to_rgb(png);
+        }
+        if (colorType == PNG_COLOR_TYPE_GRAY && bitDepth < 8)
+        {
+            png_set_expand_gray_1_2_4_to_8(png);
+        }
+        if (png_get_valid(png, info, PNG_INFO_tRNS) != 0)
+        {
+            png_set_tRNS_to_alpha(png);
+        }
+        if (bitDepth == 16)
+        {
+            png_set_strip_16(png);
+        }
+        const auto passes{ png_set_interlace_handling(png) };
+        png_read_update_info(png, info);
+
+        const auto sourceWidth{ png_get_image_width(png, info) };
+        const auto sourceHeight{ png_get_image_height(png, info) };
+        const auto factor{ lgl::scaleDenominator(sourceWidth, sourceHeight, options.maxDimension) };
+        image.width = (sourceWidth + factor - 1) / factor;
+        image.height = (sourceHeight + factor - 1) / factor;
+        image.channels = png_get_channels(png, info);
+        image.pixelFormat = lgl::ImageData::getPixelFormat(image.channels);
+        image.rowOrder = options.flipVertically
+                         ? lgl::ImageData::RowOrder::BottomUp
+                         : lgl::ImageData::RowOrder::TopDown;
+        // Interlaced passes refine every row, so decimating those needs the whole image; otherwise one row does
+        const auto sourceRowSize{ static_cast<std::size_t>(sourceWidth) * image.channels };
+        try
+        {
+            image.data.resize(static_cast<std::size_t>(image.width) * image.height * image.channels);
+            if (factor == 1)
+            {
+                rows.resize(image.height);
+            }
+            else
+            {
+                scratch.resize(passes > 1 ? sourceRowSize * sourceHeight : sourceRowSize);
+            }
+        }
+        catch (...)
+        {
+            png_destroy_read_struct(&png, &info, nullptr);
+            throw;
+        }
+
+        if (factor == 1)
+        {
+            for (uint32_t row{ 0 }; row < image.height; ++row)
+            {
+                rows[row] = reinterpret_cast<png_bytep>(rowAddress(image, row, options.flipVertically));
+            }
+            png_read_image(png, rows.data());
+        }
+        else if (passes > 1)
+        {
+            for (int pass{ 0 }; pass < passes; ++pass)
+            {
+                for (uint32_t row{ 0 }; row < sourceHeight; ++row)
+                {
+                    png_read_row(png, reinterpret_cast<png_bytep>(scratch.data() + row * sourceRowSize), nullptr);
+                }
+            }
+            for (uint32_t row{ 0 }; row < image.height; ++row)
+            {
+                decimateRow(image, scratch.data() + row * factor * sourceRowSize, row, factor,
+                            options.flipVertically);
+            }
+        }
+        else
+        {
+            for (uint32_t row{ 0 }; row < sourceHeight; ++row)
+            {
+                png_read_row(png, reinterpret_cast<png_bytep>(scratch.data()), nullptr);
+                if (row % factor == 0)
+                {
+                    decimateRow(image, scratch.data(), row / factor, factor, options.flipVertically);
+                }
+            }
+        }
+
+        png_read_end(png, nullptr);
+        png_destroy_read_struct(&png, &info, nullptr);
+        return true;
+    }
+}
 
 namespace lgl
 {
@@ -18,6 +298,17 @@ namespace lgl
         return data;
     }
 
+    std::size_t ImageData::rowSize() const noexcept
+    {
+        return static_cast<std::size_t>(width) * channels;
+    }
+
+    std::span<const std::byte> ImageData::row(const uint32_t index, const RowOrder order) const noexcept
+    {
+        const auto storedIndex{ order == rowOrder ? index : height - 1 - index };
+        return span().subspan(storedIndex * rowSize(), rowSize());
+    }
+
     ImageData ImageData::flipVertically() const
     {
         if (!isValid())
@@ -25,31 +316,95 @@ namespace lgl
             return *this; // Nothing to flip
         }
 
-        // Calculate row size in bytes
-        const auto row_size{ width * channels };
-
-        return {
-            .data = std::views::iota(0u, height)
-            | std::views::transform([this, row_size](const uint32_t row_idx)
-            {
-                // Original row index from bottom to top
-                const auto flipped_idx{ height - 1 - row_idx };
-                // Get the span for this row
-                return std::span<const std::byte>{
-                    data.data() + flipped_idx * row_size,
-                    row_size
-                };
-            })
-            | std::views::join
-            | std::ranges::to<std::vector<std::byte>>(),
+        ImageData flipped{
+            .data = std::vector<std::byte>(data.size()),
             .width = width,
             .height = height,
             .channels = channels,
-            .pixelFormat = pixelFormat
+            .pixelFormat = pixelFormat,
+            .rowOrder = rowOrder == RowOrder::TopDown ? RowOrder::BottomUp : RowOrder::TopDown
         };
+
+        const auto size{ rowSize() };
+        for (uint32_t rowIndex{ 0 }; rowIndex < height; ++rowIndex)
+        {
+            std::memcpy(flipped.data.data() + static_cast<std::size_t>(height - 1 - rowIndex) * size,
+                        data.data() + static_cast<std::size_t>(rowIndex) * size,
+                        size);
+        }
+        return flipped;
+    }
+
+    void ImageData::flipVerticallyInPlace() noexcept
+    {
+        if (!isValid())
+        {
+            return; // Nothing to flip
+        }
+
+        // Swap rows pairwise through a small stack buffer, one chunk of memcpy at a time
+        std::array<std::byte, 4096> scratch; // NOLINT(*-member-init)
+        const auto size{ rowSize() };
+        auto* top{ data.data() };
+        auto* bottom{ data.data() + static_cast<std::size_t>(height - 1) * size };
+        for (; top < bottom; top += size, bottom -= size)
+        {
+            for (std::size_t offset{ 0 }; offset < size; offset += scratch.size())
+            {
+                const auto count{ std::min(scratch.size(), size - offset) };
+                std::memcpy(scratch.data(), top + offset, count);
+                std::memcpy(top + offset, bottom + offset, count);
+                std::memcpy(bottom + offset, scratch.data(), count);
+            }
+        }
+
+        rowOrder = rowOrder == RowOrder::TopDown ? RowOrder::BottomUp : RowOrder::TopDown;
+    }
+
+    namespace detail
+    {
+        ImageData ImageReader<ImageFormat::JPEG>::read(const std::filesystem::path& file_path,
+                                                       const ImageLoadOptions& options)
+        {
+            const auto file{ openFile(file_path) };
+            JpegErrorManager errorManager{};
+            ImageData image{};
+            if (!decodeJpeg(file.get(), errorManager, image, options))
+            {
+                std::println(stderr, "Failed to read JPEG: {}", errorManager.message);
+                throw std::runtime_error("Failed to read JPEG");
+            }
+            return image;
+        }
+
+        ImageData ImageReader<ImageFormat::PNG>::read(const std::filesystem::path& file_path,
+                                                      const ImageLoadOptions& options)
+        {
+            const auto file{ openFile(file_path) };
+            PngErrorState errorState{};
+            std::vector<png_bytep> rows{};
+            std::vector<std::byte> scratch{};
+            ImageData image{};
+            if (!decodePng(file.get(), errorState, rows, scratch, image, options))
+            {
+                std::println(stderr, "Failed to read PNG: {}", errorState.message);
+                throw std::runtime_error("Failed to read PNG");
+            }
+            return image;
+        }
     }
 
     ImageData loadImage(const std::filesystem::path& filePath)
+    {
+        return loadImage(filePath, ImageLoadOptions{});
+    }
+
+    ImageData loadImagePreview(const std::filesystem::path& filePath, const uint32_t maxDimension)
+    {
+        return loadImage(filePath, ImageLoadOptions{ .maxDimension = maxDimension });
+    }
+
+    ImageData loadImage(const std::filesystem::path& filePath, const ImageLoadOptions& options)
     {
         // Check if file exists and is regular file
         if (!std::filesystem::exists(filePath) || !std::filesystem::is_regular_file(filePath))
@@ -64,19 +419,25 @@ namespace lgl
             throw std::runtime_error("Failed to open file");
         }
 
-        std::array<std::byte, 8> header{};
-        if (!file.read(reinterpret_cast<char*>(header.data()), header.size()))
+        // Long enough for the KTX2 identifier; shorter files can still carry a shorter signature
+        std::array<std::byte, 12> header{};
+        file.read(reinterpret_cast<char*>(header.data()), header.size());
+        if (file.gcount() == 0)
         {
             throw std::runtime_error("Failed to read file header");
         }
 
         // Detect format and read image
-        switch (detail::detectImageFormat(header))
+        switch (detail::detectImageFormat(std::span{ header }.first(static_cast<std::size_t>(file.gcount()))))
         {
             case ImageFormat::JPEG:
-                return detail::ImageReader<ImageFormat::JPEG>::read(filePath);
+                return detail::ImageReader<ImageFormat::JPEG>::read(filePath, options);
             case ImageFormat::PNG:
-                return detail::ImageReader<ImageFormat::PNG>::read(filePath);
+                return detail::ImageReader<ImageFormat::PNG>::read(filePath, options);
+            case ImageFormat::KTX2:
+                return detail::ImageReader<ImageFormat::KTX2>::read(filePath, options);
+            case ImageFormat::DDS:
+                return detail::ImageReader<ImageFormat::DDS>::read(filePath, options);
             default:
                 throw std::runtime_error("Unsupported or unknown image format");
         }
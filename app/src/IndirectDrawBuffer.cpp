@@ -0,0 +1,97 @@
+//
+// Created by user on 10/17/26.
+//
+
+#include "app/IndirectDrawBuffer.h"
+
+#include <cstdint>
+#include <utility>
+#include "app/GLCapabilities.h"
+
+namespace lgl
+{
+    IndirectDrawBuffer::IndirectDrawBuffer(IndirectDrawBuffer&& other) noexcept
+        : m_commands{ std::move(other.m_commands) },
+          m_bufferObject{ std::exchange(other.m_bufferObject, 0) }
+    {
+    }
+
+    IndirectDrawBuffer& IndirectDrawBuffer::operator=(IndirectDrawBuffer&& other) noexcept
+    {
+        if (this == &other)
+            return *this;
+        glDeleteBuffers(1, &m_bufferObject);
+        m_commands = std::move(other.m_commands);
+        m_bufferObject = std::exchange(other.m_bufferObject, 0);
+        return *this;
+    }
+
+    IndirectDrawBuffer::~IndirectDrawBuffer()
+    {
+        glDeleteBuffers(1, &m_bufferObject);
+    }
+
+    void IndirectDrawBuffer::push(const DrawElementsIndirectCommand& command)
+    {
+        if (command.count == 0 || command.instanceCount == 0)
+        {
+            return;
+        }
+        m_commands.push_back(command);
+    }
+
+    void IndirectDrawBuffer::clear() noexcept
+    {
+        m_commands.clear();
+    }
+
+    std::span<const DrawElementsIndirectCommand> IndirectDrawBuffer::commands() const noexcept
+    {
+        return m_commands;
+    }
+
+    void IndirectDrawBuffer::submit(const GLenum indexType)
+    {
+        if (m_commands.empty())
+        {
+            return;
+        }
+
+        if (const auto multiDrawElementsIndirect{ GLCapabilities::current().multiDrawElementsIndirect() })
+        {
+            if (m_bufferObject == 0)
+            {
+                glGenBuffers(1, &m_bufferObject);
+            }
+            const auto size{ static_cast<GLsizeiptr>(std::span{ m_commands }.size_bytes()) };
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_bufferObject);
+            // Orphan the previous commands, which earlier draws may still read
+            glBufferData(GL_DRAW_INDIRECT_BUFFER, size, nullptr, GL_STREAM_DRAW);
+            glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, size, m_commands.data());
+            multiDrawElementsIndirect(GL_TRIANGLES, indexType, nullptr, static_cast<GLsizei>(m_commands.size()), 0);
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        }
+        else
+        {
+            // Base instances need OpenGL 4.2, so the loop ignores them
+            const auto indexSize{ indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t) };
+            for (const auto& command : m_commands)
+            {
+                glDrawElementsInstancedBaseVertex(
+                    GL_TRIANGLES,
+                    static_cast<GLsizei>(command.count),
+                    indexType,
+                    reinterpret_cast<const GLvoid*>(static_cast<std::size_t>(command.firstIndex) * indexSize),
+                    static_cast<GLsizei>(command.instanceCount),
+                    command.baseVertex
+                );
+            }
+        }
+        m_commands.clear();
+    }
+
+    bool IndirectDrawBuffer::isMultiDrawSupported()
+    {
+        return GLCapabilities::current().multiDrawElementsIndirect() != nullptr;
+    }
+} // lgl
@@ -0,0 +1,71 @@
+//
+// Created by user on 10/17/26.
+//
+
+#include "app/InstanceBuffer.h"
+
+#include <utility>
+#include <glm/matrix.hpp>
+
+namespace lgl
+{
+    InstanceTransform InstanceTransform::from(const glm::mat4& model)
+    {
+        return { .model = model, .normalMatrix = glm::transpose(glm::inverse(glm::mat3{ model })) };
+    }
+
+    InstanceBuffer::InstanceBuffer()
+    {
+        glGenBuffers(1, &m_bufferObject);
+        // Non-instanced draws from attached vertex arrays still find one valid instance
+        constexpr InstanceTransform identity{};
+        upload(std::span{ &identity, 1 });
+    }
+
+    InstanceBuffer::InstanceBuffer(InstanceBuffer&& other) noexcept
+        : m_bufferObject{ std::exchange(other.m_bufferObject, 0) },
+          m_size{ std::exchange(other.m_size, 0) }
+    {
+    }
+
+    InstanceBuffer& InstanceBuffer::operator=(InstanceBuffer&& other) noexcept
+    {
+        if (this == &other)
+            return *this;
+        glDeleteBuffers(1, &m_bufferObject);
+        m_bufferObject = std::exchange(other.m_bufferObject, 0);
+        m_size = std::exchange(other.m_size, 0);
+        return *this;
+    }
+
+    InstanceBuffer::~InstanceBuffer()
+    {
+        glDeleteBuffers(1, &m_bufferObject);
+    }
+
+    void InstanceBuffer::upload(const std::span<const InstanceTransform> instances)
+    {
+        if (instances.empty())
+        {
+            return;
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, m_bufferObject);
+        // Orphan the previous storage, then fill the new one
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(instances.size_bytes()), nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(instances.size_bytes()), instances.data());
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        m_size = instances.size();
+    }
+
+    void InstanceBuffer::attach() const
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, m_bufferObject);
+        enableInstanceAttributes<InstanceTransform>();
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    std::size_t InstanceBuffer::size() const noexcept
+    {
+        return m_size;
+    }
+} // lgl
@@ -0,0 +1,142 @@
+//
+// Created by user on 10/17/26.
+//
+
+#include "app/MappedFile.h"
+
+#include <print>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace lgl
+{
+    MappedFile MappedFile::open(const std::filesystem::path& path)
+    {
+        MappedFile mappedFile{};
+        mappedFile.m_size = std::filesystem::file_size(path);
+        if (mappedFile.m_size == 0)
+        {
+            return mappedFile; // Nothing to map
+        }
+
+#ifdef _WIN32
+        mappedFile.m_fileHandle = CreateFileW(path.c_str(),
+                                              GENERIC_READ,
+                                              FILE_SHARE_READ,
+                                              nullptr,
+                                              OPEN_EXISTING,
+                                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                                              nullptr);
+        if (mappedFile.m_fileHandle == INVALID_HANDLE_VALUE)
+        {
+            mappedFile.m_fileHandle = nullptr;
+            std::println(stderr, "Failed to open '{}' for mapping", path.string());
+            throw std::runtime_error("Failed to open file");
+        }
+        mappedFile.m_mappingHandle = CreateFileMappingW(mappedFile.m_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mappedFile.m_mappingHandle == nullptr)
+        {
+            std::println(stderr, "Failed to map '{}'", path.string());
+            throw std::runtime_error("Failed to map file");
+        }
+        mappedFile.m_data = static_cast<const std::byte*>(
+            MapViewOfFile(mappedFile.m_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+#else
+        const auto descriptor{ ::open(path.c_str(), O_RDONLY | O_CLOEXEC) };
+        if (descriptor == -1)
+        {
+            std::println(stderr, "Failed to open '{}' for mapping", path.string());
+            throw std::runtime_error("Failed to open file");
+        }
+        auto* const address{ mmap(nullptr, mappedFile.m_size, PROT_READ, MAP_PRIVATE, descriptor, 0) };
+        // The mapping keeps its own reference to the file
+        close(descriptor);
+        if (address != MAP_FAILED)
+        {
+            mappedFile.m_data = static_cast<const std::byte*>(address);
+        }
+#endif
+        if (mappedFile.m_data == nullptr)
+        {
+            std::println(stderr, "Failed to map '{}'", path.string());
+            throw std::runtime_error("Failed to map file");
+        }
+        return mappedFile;
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+        : m_data{ std::exchange(other.m_data, nullptr) },
+          m_size{ std::exchange(other.m_size, 0) }
+#ifdef _WIN32
+          , m_fileHandle{ std::exchange(other.m_fileHandle, nullptr) },
+          m_mappingHandle{ std::exchange(other.m_mappingHandle, nullptr) }
+#endif
+    {
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+    {
+        if (this == &other)
+            return *this;
+        unmap();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+#ifdef _WIN32
+        m_fileHandle = std::exchange(other.m_fileHandle, nullptr);
+        m_mappingHandle = std::exchange(other.m_mappingHandle, nullptr);
+#endif
+        return *this;
+    }
+
+    MappedFile::~MappedFile()
+    {
+        unmap();
+    }
+
+    std::span<const std::byte> MappedFile::bytes() const noexcept
+    {
+        return { m_data, m_data == nullptr ? 0 : m_size };
+    }
+
+    std::size_t MappedFile::size() const noexcept
+    {
+        return m_size;
+    }
+
+    void MappedFile::unmap() noexcept
+    {
+#ifdef _WIN32
+        if (m_data != nullptr)
+        {
+            UnmapViewOfFile(m_data);
+        }
+        if (m_mappingHandle != nullptr)
+        {
+            CloseHandle(m_mappingHandle);
+        }
+        if (m_fileHandle != nullptr)
+        {
+            CloseHandle(m_fileHandle);
+        }
+        m_fileHandle = nullptr;
+        m_mappingHandle = nullptr;
+#else
+        if (m_data != nullptr)
+        {
+            munmap(const_cast<std::byte*>(m_data), m_size);
+        }
+#endif
+        m_data = nullptr;
+        m_size = 0;
+    }
+} // lgl
@@ -0,0 +1,66 @@
+//
+// Created by user on 10/17/26.
+//
+
+#include "app/MaterialBinding.h"
+
+#include <array>
+
+namespace lgl
+{
+    using namespace literals;
+
+    namespace
+    {
+        // Sampler arrays of the material struct, by Texture::Type
+        constexpr std::array SAMPLER_ARRAYS{
+            "material.diffuses[]"_u,
+            "material.speculars[]"_u,
+            "material.normals[]"_u,
+            "material.heights[]"_u
+        };
+
+        static_assert(SAMPLER_ARRAYS.size() == static_cast<std::size_t>(Texture::Type::Size));
+    }
+
+    MaterialBinding MaterialBinding::build(const ShaderProgram& shaderProgram, const std::span<const Texture> textures)
+    {
+        MaterialBinding binding{};
+        binding.m_program = shaderProgram.getId();
+        binding.m_slots.reserve(textures.size());
+        std::array<std::size_t, static_cast<std::size_t>(Texture::Type::Size)> offsets{};
+        for (std::size_t unit{ 0 }; unit < textures.size(); ++unit)
+        {
+            const auto& texture{ textures[unit] };
+            const auto type{ static_cast<std::size_t>(texture.type) };
+            binding.m_slots.push_back({
+                .location = shaderProgram.getUniformLocation(SAMPLER_ARRAYS[type][offsets[type]++]),
+                .unit = static_cast<GLuint>(unit),
+                .texture = texture.id
+            });
+        }
+        return binding;
+    }
+
+    void MaterialBinding::bind() const noexcept
+    {
+        for (const auto& [location, unit, texture] : m_slots)
+        {
+            glActiveTexture(GL_TEXTURE0 + unit);
+            // A location of -1 is ignored
+            glUniform1i(location, static_cast<GLint>(unit));
+            glBindTexture(GL_TEXTURE_2D, texture);
+        }
+        glActiveTexture(GL_TEXTURE0);
+    }
+
+    GLuint MaterialBinding::program() const noexcept
+    {
+        return m_program;
+    }
+
+    std::span<const MaterialBinding::Slot> MaterialBinding::slots() const noexcept
+    {
+        return m_slots;
+    }
+} // lgl
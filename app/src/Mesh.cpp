@@ -4,8 +4,57 @@
 
 #include "app/Mesh.h"
 
+#include <algorithm>
 #include <ranges>
-#include "app/Model.h"
+#include <tuple>
+#include <utility>
+#include "app/GLCapabilities.h"
+#include "app/MeshOptimization.h"
+#include "app/utilities.h"
+
+namespace
+{
+    // Identical source bytes processed the same way give identical GL textures
+    uint64_t contentKey(const lgl::CookedTexture& texture)
+    {
+        const auto& options{ texture.mipmapOptions() };
+        const std::array<uint64_t, 5> fields{
+            texture.contentHash(),
+            static_cast<uint64_t>(options.filter),
+            static_cast<uint64_t>(options.colorSpace),
+            static_cast<uint64_t>(options.normalMap),
+            static_cast<uint64_t>(texture.compressedFormat())
+        };
+        return lgl::hash64(std::as_bytes(std::span{ fields }));
+    }
+
+    /**
+     * Splits meshes too large for 16-bit indices when the index memory saved outweighs the vertices duplicated on
+     * the seams. Counts only the full mesh's indices; its LODs save more
+     */
+    std::vector<lgl::MeshPart> splitForShortIndices(std::vector<lgl::Vertex>& vertices, std::vector<uint32_t>& indices)
+    {
+        if (vertices.size() > lgl::MAX_SHORT_INDEX_VERTICES)
+        {
+            auto parts{ lgl::splitMesh(vertices, indices, lgl::MAX_SHORT_INDEX_VERTICES) };
+            std::size_t vertexCount{ 0 };
+            for (const auto& part : parts)
+            {
+                vertexCount += part.vertices.size();
+            }
+            const auto duplicatedBytes{ (vertexCount - vertices.size()) * sizeof(lgl::Vertex) };
+            const auto savedBytes{ indices.size() * (sizeof(uint32_t) - sizeof(uint16_t)) };
+            if (savedBytes > duplicatedBytes)
+            {
+                return parts;
+            }
+        }
+
+        std::vector<lgl::MeshPart> parts{};
+        parts.push_back({ .vertices = std::move(vertices), .indices = std::move(indices) });
+        return parts;
+    }
+}
 
 glm::vec3 from(const aiVector3D& vector)
 {
@@ -14,64 +63,130 @@ glm::vec3 from(const aiVector3D& vector)
 
 namespace lgl
 {
+    using namespace literals;
+
     Mesh::Mesh(vertex_container_type vertices, index_container_type indices, texture_container_type textures)
         : m_vertices{ std::move(vertices) },
           m_indices{ std::move(indices) },
-          m_textures{ std::move(textures) }
+          m_textures{ std::move(textures) },
+          m_triangleList{ m_indices.size() % 3 == 0 }
     {
-        setupMesh();
+        // Textures that came from the cache are shared; reference them like loaded ones
+        for (const auto& texture : m_textures)
+        {
+            std::ignore = s_textureCache.acquire({ .path = texture.path, .type = texture.type });
+        }
+        setupMesh(m_vertices, m_indices);
+    }
+
+    Mesh::Mesh(MeshData data)
+        : m_vertices{ std::move(data.vertices) },
+          m_indices{ std::move(data.indices) },
+          m_lods{ std::move(data.lods) },
+          m_triangleList{ data.triangleList }
+    {
+        loadTextures(data.textures);
+        setupMesh(m_vertices, m_indices);
+    }
+
+    Mesh::Mesh(const CookedMesh& mesh)
+        : m_lods{ mesh.lods },
+          m_triangleList{ mesh.triangleList }
+    {
+        loadTextures(mesh.textures);
+        setupMesh(mesh.vertices, mesh.indices);
     }
 
-    Mesh::Mesh(const Model& model, const aiMesh* mesh, const aiScene* scene)
-        : m_parent{ &model }
+    std::vector<MeshData> Mesh::process(const aiMesh* mesh,
+                                        const aiScene* scene,
+                                        const std::filesystem::path& directory)
     {
+        MeshData data{};
+        data.vertices.reserve(mesh->mNumVertices);
         for (std::size_t i{ 0 }; i < mesh->mNumVertices; ++i)
         {
-            m_vertices.emplace_back(from(mesh->mVertices[i]),
-                                    mesh->HasNormals()
-                                    ? from(mesh->mNormals[i])
-                                    : glm::vec3{ 0.0f, 0.0f, 0.0f },
-                                    mesh->mTextureCoords[0] != nullptr
-                                    ? from(mesh->mTextureCoords[0][i])
-                                    : glm::vec2{ 0.0f, 0.0f },
-                                    mesh->mTextureCoords[0] != nullptr && mesh->mTangents != nullptr
-                                    ? from(mesh->mTangents[i])
-                                    : glm::vec3{ 0.0f, 0.0f, 0.0f },
-                                    mesh->mTextureCoords[0] != nullptr && mesh->mBitangents != nullptr
-                                    ? from(mesh->mBitangents[i])
-                                    : glm::vec3{ 0.0f, 0.0f, 0.0f });
+            data.vertices.emplace_back(from(mesh->mVertices[i]),
+                                       mesh->HasNormals()
+                                       ? from(mesh->mNormals[i])
+                                       : glm::vec3{ 0.0f, 0.0f, 0.0f },
+                                       mesh->mTextureCoords[0] != nullptr
+                                       ? from(mesh->mTextureCoords[0][i])
+                                       : glm::vec2{ 0.0f, 0.0f },
+                                       mesh->mTextureCoords[0] != nullptr && mesh->mTangents != nullptr
+                                       ? from(mesh->mTangents[i])
+                                       : glm::vec3{ 0.0f, 0.0f, 0.0f },
+                                       mesh->mTextureCoords[0] != nullptr && mesh->mBitangents != nullptr
+                                       ? from(mesh->mBitangents[i])
+                                       : glm::vec3{ 0.0f, 0.0f, 0.0f });
         }
 
+        // Triangulated faces have three indices, which the reservation assumes
+        data.indices.reserve(static_cast<std::size_t>(mesh->mNumFaces) * 3);
         for (std::size_t i{ 0 }; i < mesh->mNumFaces; ++i)
         {
-            const auto face{ mesh->mFaces[i] };
-            for (std::size_t j{ 0 }; j < face.mNumIndices; ++j)
-            {
-                m_indices.emplace_back(face.mIndices[j]);
-            }
+            const auto& face{ mesh->mFaces[i] };
+            data.indices.insert(data.indices.end(), face.mIndices, face.mIndices + face.mNumIndices);
         }
 
-        const auto material{ scene->mMaterials[mesh->mMaterialIndex] };
-        m_textures.append_range(loadMaterialTextures(material, aiTextureType_DIFFUSE));
-        m_textures.append_range(loadMaterialTextures(material, aiTextureType_SPECULAR));
-        m_textures.append_range(loadMaterialTextures(material, aiTextureType_NORMALS));
-        m_textures.append_range(loadMaterialTextures(material, aiTextureType_HEIGHT));
+        data.textures = materialTextures(scene->mMaterials[mesh->mMaterialIndex], directory);
 
-        if (m_textures.empty())
+        // Triangulation leaves point and line meshes as they are; only triangle lists are reordered
+        if (mesh->mPrimitiveTypes != aiPrimitiveType_TRIANGLE)
         {
-            std::println(stderr, "No texture is loaded");
+            data.triangleList = false;
+            std::vector<MeshData> parts{};
+            parts.push_back(std::move(data));
+            return parts;
         }
 
-        setupMesh();
+        const auto optimization{ optimizeMesh(data.vertices, data.indices) };
+        auto split{ splitForShortIndices(data.vertices, data.indices) };
+        std::vector<MeshData> parts{};
+        parts.reserve(split.size());
+        for (auto& [vertices, indices] : split)
+        {
+            // A split part has its own vertices, so its cache behaviour is measured again
+            auto partOptimization{ optimization };
+            if (split.size() > 1)
+            {
+                partOptimization.vertexCountAfter = vertices.size();
+                partOptimization.after = analyzeVertexCache(indices, vertices.size());
+            }
+            parts.push_back({
+                .vertices = std::move(vertices),
+                .indices = std::move(indices),
+                .lods = {},
+                .textures = data.textures,
+                .triangleList = true,
+                .optimization = partOptimization
+            });
+        }
+        for (auto& part : parts)
+        {
+            part.lods = buildLodChain(part.vertices, part.indices);
+        }
+        return parts;
     }
 
     Mesh::Mesh(Mesh&& other) noexcept
         : m_vertices{ std::move(other.m_vertices) },
           m_indices{ std::move(other.m_indices) },
           m_textures{ std::move(other.m_textures) },
+          m_lods{ std::move(other.m_lods) },
+          m_bounds{ other.m_bounds },
+          m_triangleList{ other.m_triangleList },
+          m_meshlets{ std::move(other.m_meshlets) },
+          m_meshletCuller{ std::move(other.m_meshletCuller) },
+          m_materialBindings{ std::move(other.m_materialBindings) },
           m_vertexArrayObject{ other.m_vertexArrayObject },
           m_vertexBufferObject{ other.m_vertexBufferObject },
-          m_elementBufferObject{ other.m_elementBufferObject }
+          m_elementBufferObject{ other.m_elementBufferObject },
+          m_allocation{ std::exchange(other.m_allocation, std::nullopt) },
+          m_indexType{ other.m_indexType },
+          m_indexCount{ other.m_indexCount },
+          m_materialId{ other.m_materialId },
+          m_vertexFormat{ other.m_vertexFormat },
+          m_dequantization{ other.m_dequantization }
     {
         // Invalidate the moved-from object's handles
         other.m_vertexArrayObject = 0;
@@ -83,12 +198,26 @@ namespace lgl
     {
         if (this == &other)
             return *this;
+        releaseTextures();
+        releaseBuffers();
         m_vertices = std::move(other.m_vertices);
         m_indices = std::move(other.m_indices);
         m_textures = std::move(other.m_textures);
+        m_lods = std::move(other.m_lods);
+        m_bounds = other.m_bounds;
+        m_triangleList = other.m_triangleList;
+        m_meshlets = std::move(other.m_meshlets);
+        m_meshletCuller = std::move(other.m_meshletCuller);
+        m_materialBindings = std::move(other.m_materialBindings);
         m_vertexArrayObject = other.m_vertexArrayObject;
         m_vertexBufferObject = other.m_vertexBufferObject;
         m_elementBufferObject = other.m_elementBufferObject;
+        m_allocation = std::exchange(other.m_allocation, std::nullopt);
+        m_indexType = other.m_indexType;
+        m_indexCount = other.m_indexCount;
+        m_materialId = other.m_materialId;
+        m_vertexFormat = other.m_vertexFormat;
+        m_dequantization = other.m_dequantization;
 
         // Invalidate the moved-from object's handles
         other.m_vertexArrayObject = 0;
@@ -100,166 +229,478 @@ namespace lgl
 
     Mesh::~Mesh()
     {
-        glDeleteVertexArrays(1, &m_vertexArrayObject);
-        glDeleteBuffers(1, &m_vertexBufferObject);
-        glDeleteBuffers(1, &m_elementBufferObject);
+        releaseTextures();
+        releaseBuffers();
     }
 
-    void Mesh::draw(const ShaderProgram& shaderProgram) const
+    void Mesh::draw(const ShaderProgram& shaderProgram, const std::size_t lod) const
     {
-        std::array<std::size_t, static_cast<std::size_t>(Texture::Type::Size)> offsets{};
-        for (auto&& [index, texture] : std::views::enumerate(m_textures))
-        {
-            glActiveTexture(GL_TEXTURE0 + index);
+        bind(shaderProgram);
+        drawBound(lod);
+    }
 
-            shaderProgram.setUniform(std::format("material.{}s[{}]",
-                                                 texture.type,
-                                                 offsets[static_cast<std::size_t>(texture.type)]++),
-                                     static_cast<GLuint>(index)
-            );
-            glBindTexture(GL_TEXTURE_2D, texture.id);
-        }
-        glActiveTexture(GL_TEXTURE0);
+    void Mesh::drawBound(const std::size_t lod) const
+    {
+        const auto& range{ m_lods.at(lod) };
+        glDrawElementsBaseVertex(
+            GL_TRIANGLES,
+            static_cast<GLsizei>(range.indexCount),
+            m_indexType,
+            indexOffset(range.firstIndex),
+            baseVertex()
+        );
+    }
 
-        glBindVertexArray(m_vertexArrayObject);
-        glDrawElements(
+    void Mesh::drawInstanced(const ShaderProgram& shaderProgram,
+                             const std::size_t instanceCount,
+                             const std::size_t lod) const
+    {
+        bind(shaderProgram);
+        const auto& range{ m_lods.at(lod) };
+        glDrawElementsInstancedBaseVertex(
             GL_TRIANGLES,
-            static_cast<GLsizei>(m_indices.size()),
-            GL_UNSIGNED_INT,
-            nullptr
+            static_cast<GLsizei>(range.indexCount),
+            m_indexType,
+            indexOffset(range.firstIndex),
+            static_cast<GLsizei>(instanceCount),
+            baseVertex()
         );
-        glBindVertexArray(0);
     }
 
-    std::unordered_map<std::filesystem::path, Mesh::handle_type> Mesh::s_textureCache{};
+    std::size_t Mesh::drawCulled(const ShaderProgram& shaderProgram,
+                                 const Frustum& frustum,
+                                 const glm::vec3& cameraPosition) const
+    {
+        const auto triangleCount{ cullMeshlets(frustum, cameraPosition) };
+        if (m_drawCounts.empty())
+        {
+            return 0;
+        }
+
+        m_drawOffsets.clear();
+        for (const auto firstIndex : m_drawFirstIndices)
+        {
+            m_drawOffsets.push_back(indexOffset(firstIndex));
+        }
+        m_drawBaseVertices.assign(m_drawCounts.size(), baseVertex());
+        bind(shaderProgram);
+        glMultiDrawElementsBaseVertex(GL_TRIANGLES,
+                                      m_drawCounts.data(),
+                                      m_indexType,
+                                      m_drawOffsets.data(),
+                                      static_cast<GLsizei>(m_drawCounts.size()),
+                                      m_drawBaseVertices.data());
+        return triangleCount;
+    }
 
-    void Mesh::setupMesh()
+    void Mesh::drawIndirect(const ShaderProgram& shaderProgram, IndirectDrawBuffer& commands) const
     {
-        glGenVertexArrays(1, &m_vertexArrayObject);
-        glGenBuffers(1, &m_vertexBufferObject);
-        glGenBuffers(1, &m_elementBufferObject);
+        if (commands.commands().empty())
+        {
+            return;
+        }
+        bind(shaderProgram);
+        commands.submit(m_indexType);
+    }
 
-        glBindVertexArray(m_vertexArrayObject);
-        glBindBuffer(GL_ARRAY_BUFFER, m_vertexBufferObject);
+    DrawElementsIndirectCommand Mesh::drawCommand(const std::size_t lod) const noexcept
+    {
+        const auto& range{ m_lods[lod] };
+        return {
+            .count = static_cast<GLuint>(range.indexCount),
+            .instanceCount = 1,
+            .firstIndex = static_cast<GLuint>(bufferIndex(range.firstIndex)),
+            .baseVertex = baseVertex(),
+            .baseInstance = 0
+        };
+    }
 
-        glBufferData(GL_ARRAY_BUFFER,
-                     static_cast<GLsizeiptr>(sizeOf(m_vertices)),
-                     m_vertices.data(),
-                     GL_STATIC_DRAW);
+    std::size_t Mesh::pushCulledDrawCommands(const Frustum& frustum,
+                                             const glm::vec3& cameraPosition,
+                                             IndirectDrawBuffer& commands) const
+    {
+        const auto triangleCount{ cullMeshlets(frustum, cameraPosition) };
+        for (auto&& [count, firstIndex] : std::views::zip(m_drawCounts, m_drawFirstIndices))
+        {
+            commands.push({
+                .count = static_cast<GLuint>(count),
+                .instanceCount = 1,
+                .firstIndex = static_cast<GLuint>(bufferIndex(firstIndex)),
+                .baseVertex = baseVertex(),
+                .baseInstance = 0
+            });
+        }
+        return triangleCount;
+    }
 
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_elementBufferObject);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-                     static_cast<GLsizeiptr>(sizeOf(m_indices)),
-                     m_indices.data(),
-                     GL_STATIC_DRAW);
+    bool Mesh::sharesDrawState(const Mesh& other) const noexcept
+    {
+        // Separate meshes each have their own vertex array
+        if (!m_allocation.has_value() || !other.m_allocation.has_value())
+        {
+            return this == &other;
+        }
+        if (m_vertexFormat != other.m_vertexFormat || m_indexType != other.m_indexType)
+        {
+            return false;
+        }
+        if (m_vertexFormat != VertexFormat::Full
+            && (m_dequantization.scale != other.m_dequantization.scale
+                || m_dequantization.offset != other.m_dequantization.offset))
+        {
+            return false;
+        }
+        return m_materialId == other.m_materialId;
+    }
 
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(
-            0,
-            3,
-            GL_FLOAT,
-            GL_FALSE,
-            static_cast<GLsizei>(elementSizeOf(m_vertices)),
-            reinterpret_cast<const GLvoid*>(offsetof(vertex_type, position))
-        );
+    std::size_t Mesh::cullMeshlets(const Frustum& frustum, const glm::vec3& cameraPosition) const
+    {
+        m_drawCounts.clear();
+        m_drawFirstIndices.clear();
+        if (!m_triangleList)
+        {
+            const auto& full{ m_lods.front() };
+            if (full.indexCount > 0)
+            {
+                m_drawCounts.push_back(static_cast<GLsizei>(full.indexCount));
+                m_drawFirstIndices.push_back(full.firstIndex);
+            }
+            return full.indexCount / 3;
+        }
 
-        glEnableVertexAttribArray(1);
-        glVertexAttribPointer(
-            1,
-            3,
-            GL_FLOAT,
-            GL_FALSE,
-            static_cast<GLsizei>(elementSizeOf(m_vertices)),
-            reinterpret_cast<const GLvoid*>(offsetof(vertex_type, normal))
-        );
+        m_visibleMeshlets.resize(m_meshlets.size());
+        m_meshletCuller.cull(frustum, cameraPosition, m_visibleMeshlets);
 
-        glEnableVertexAttribArray(2);
-        glVertexAttribPointer(
-            2,
-            2,
-            GL_FLOAT,
-            GL_FALSE,
-            static_cast<GLsizei>(elementSizeOf(m_vertices)),
-            reinterpret_cast<const GLvoid*>(offsetof(vertex_type, textureCoordinates))
-        );
+        // Runs of visible meshlets are contiguous in the index buffer, so each run is one draw
+        std::size_t triangleCount{ 0 };
+        auto continuesRun{ false };
+        for (auto&& [meshlet, visible] : std::views::zip(m_meshlets, m_visibleMeshlets))
+        {
+            if (visible == 0)
+            {
+                continuesRun = false;
+                continue;
+            }
+            if (continuesRun)
+            {
+                m_drawCounts.back() += static_cast<GLsizei>(meshlet.indexCount);
+            }
+            else
+            {
+                m_drawCounts.push_back(static_cast<GLsizei>(meshlet.indexCount));
+                m_drawFirstIndices.push_back(meshlet.firstIndex);
+            }
+            continuesRun = true;
+            triangleCount += meshlet.indexCount / 3;
+        }
+        return triangleCount;
+    }
 
-        glEnableVertexAttribArray(3);
-        glVertexAttribPointer(
-            3,
-            3,
-            GL_FLOAT,
-            GL_FALSE,
-            static_cast<GLsizei>(elementSizeOf(m_vertices)),
-            reinterpret_cast<const GLvoid*>(offsetof(vertex_type, tangent))
-        );
+    void Mesh::bind(const ShaderProgram& shaderProgram) const
+    {
+        bindTextures(shaderProgram);
+        setGeometryUniforms(shaderProgram);
+        // Rebinding the vertex array every shared mesh is drawn from is no switch for the driver
+        glBindVertexArray(vertexArray());
+    }
 
-        glEnableVertexAttribArray(4);
-        glVertexAttribPointer(
-            4,
-            3,
-            GL_FLOAT,
-            GL_FALSE,
-            static_cast<GLsizei>(elementSizeOf(m_vertices)),
-            reinterpret_cast<const GLvoid*>(offsetof(vertex_type, bitangent))
-        );
+    void Mesh::bindTextures(const ShaderProgram& shaderProgram) const
+    {
+        materialBinding(shaderProgram).bind();
+    }
 
-        glEnableVertexAttribArray(5);
-        glVertexAttribIPointer(
-            5,
-            MAX_BONE_INFLUENCE,
-            GL_INT,
-            static_cast<GLsizei>(elementSizeOf(m_vertices)),
-            reinterpret_cast<const GLvoid*>(offsetof(vertex_type, boneIds))
-        );
+    const MaterialBinding& Mesh::materialBinding(const ShaderProgram& shaderProgram) const
+    {
+        if (const auto binding{
+                std::ranges::find(m_materialBindings, shaderProgram.getId(), &MaterialBinding::program)
+            };
+            binding != m_materialBindings.end())
+        {
+            return *binding;
+        }
+        return m_materialBindings.emplace_back(MaterialBinding::build(shaderProgram, m_textures));
+    }
 
-        glEnableVertexAttribArray(6);
-        glVertexAttribPointer(
-            6,
-            MAX_BONE_INFLUENCE,
-            GL_FLOAT,
-            GL_FALSE,
-            static_cast<GLsizei>(elementSizeOf(m_vertices)),
-            reinterpret_cast<const GLvoid*>(offsetof(vertex_type, weights))
-        );
+    void Mesh::setGeometryUniforms(const ShaderProgram& shaderProgram) const
+    {
+        if (m_vertexFormat != VertexFormat::Full)
+        {
+            shaderProgram.setUniform("positionScale"_u, m_dequantization.scale);
+            shaderProgram.setUniform("positionOffset"_u, m_dequantization.offset);
+        }
+    }
+
+    Mesh::handle_type Mesh::vertexArray() const
+    {
+        return m_allocation.has_value() ? sharedGeometryBuffer(m_vertexFormat).vertexArray() : m_vertexArrayObject;
+    }
+
+    uint32_t Mesh::materialId() const noexcept
+    {
+        return m_materialId;
+    }
+
+    const GLvoid* Mesh::indexOffset(const std::size_t index) const noexcept
+    {
+        const auto firstByte{ m_allocation.has_value() ? m_allocation->indexOffset : 0 };
+        return reinterpret_cast<const GLvoid*>(firstByte + index * indexSize());
+    }
+
+    std::size_t Mesh::bufferIndex(const std::size_t index) const noexcept
+    {
+        // Allocations are aligned to the index size
+        const auto firstIndex{ m_allocation.has_value() ? m_allocation->indexOffset / indexSize() : 0 };
+        return firstIndex + index;
+    }
+
+    std::size_t Mesh::indexSize() const noexcept
+    {
+        return m_indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+    }
+
+    GLint Mesh::baseVertex() const noexcept
+    {
+        return m_allocation.has_value() ? static_cast<GLint>(m_allocation->firstVertex) : 0;
+    }
+
+    void Mesh::releaseBuffers() noexcept
+    {
+        if (m_allocation.has_value())
+        {
+            sharedGeometryBuffer(m_vertexFormat).free(*m_allocation);
+            m_allocation.reset();
+        }
+        glDeleteVertexArrays(1, &m_vertexArrayObject);
+        glDeleteBuffers(1, &m_vertexBufferObject);
+        glDeleteBuffers(1, &m_elementBufferObject);
+        m_vertexArrayObject = 0;
+        m_vertexBufferObject = 0;
+        m_elementBufferObject = 0;
+    }
+
+    TextureCache Mesh::s_textureCache{};
+    VertexFormat Mesh::s_vertexFormat{ VertexFormat::Full };
+    BufferAllocation Mesh::s_bufferAllocation{ BufferAllocation::Separate };
+    std::array<std::optional<GeometryBuffer>, 3> Mesh::s_geometryBuffers{};
+    std::optional<InstanceBuffer> Mesh::s_instanceBuffer{};
+    std::map<std::vector<GLuint>, uint32_t> Mesh::s_materialIds{};
+    std::array<std::optional<CompressedFormat>, static_cast<std::size_t>(Texture::Type::Size)>
+    Mesh::s_compressedFormats{};
+
+    std::span<const MeshLod> Mesh::lods() const noexcept
+    {
+        return m_lods;
+    }
+
+    const BoundingSphere& Mesh::bounds() const noexcept
+    {
+        return m_bounds;
+    }
+
+    GLenum Mesh::indexType() const noexcept
+    {
+        return m_indexType;
+    }
+
+    std::size_t Mesh::indexBufferSize() const noexcept
+    {
+        return m_indexCount * indexSize();
+    }
+
+    CookedMesh Mesh::cookedMesh() const
+    {
+        return {
+            .vertices = m_vertices,
+            .indices = m_indices,
+            .lods = m_lods,
+            .textures = m_textures
+                        | std::views::transform([](const texture_type& texture)
+                        {
+                            return TextureReference{ .path = texture.path, .type = texture.type };
+                        })
+                        | std::ranges::to<std::vector>(),
+            .triangleList = m_triangleList
+        };
+    }
+
+    void Mesh::setupMesh(const std::span<const vertex_type> vertices, const std::span<const index_type> indices)
+    {
+        if (m_lods.empty())
+        {
+            m_lods.push_back({ .firstIndex = 0, .indexCount = indices.size(), .error = 0.0f });
+        }
+        m_bounds = boundingSphere(vertices);
+
+        // Meshlets group triangles, so anything else is only ever drawn whole
+        const auto& full{ m_lods.front() };
+        m_meshlets = m_triangleList
+                     ? buildMeshlets(indices.subspan(full.firstIndex, full.indexCount),
+                                     full.firstIndex,
+                                     vertices.size())
+                     : std::vector<Meshlet>{};
+        const auto meshletBounds{
+            m_meshlets
+            | std::views::transform([vertices, indices](const Meshlet& meshlet)
+            {
+                return computeMeshletBounds(vertices, indices.subspan(meshlet.firstIndex, meshlet.indexCount));
+            })
+            | std::ranges::to<std::vector>()
+        };
+        m_meshletCuller = MeshletCuller{ meshletBounds };
+
+        const auto textureHandles{
+            m_textures | std::views::transform(&texture_type::id) | std::ranges::to<std::vector>()
+        };
+        m_materialId = s_materialIds.try_emplace(textureHandles, static_cast<uint32_t>(s_materialIds.size()))
+                       .first->second;
+
+        m_vertexFormat = s_vertexFormat;
+        // Indices are 32-bit on the CPU, where the LOD chain and meshlets are built; the GPU gets the narrowest
+        m_indexCount = indices.size();
+        m_indexType = vertices.size() <= MAX_SHORT_INDEX_VERTICES ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+        const auto shortIndices{
+            m_indexType == GL_UNSIGNED_SHORT
+            ? indices
+              | std::views::transform([](const index_type index) { return static_cast<uint16_t>(index); })
+              | std::ranges::to<std::vector>()
+            : std::vector<uint16_t>{}
+        };
+        const auto indexBytes{
+            m_indexType == GL_UNSIGNED_SHORT ? std::as_bytes(std::span{ shortIndices }) : std::as_bytes(indices)
+        };
+
+        if (s_bufferAllocation == BufferAllocation::Shared)
+        {
+            auto& geometryBuffer{ sharedGeometryBuffer(m_vertexFormat) };
+            m_allocation = geometryBuffer.allocate(vertices.size(), indices.size(), indexSize());
+            geometryBuffer.uploadIndices(*m_allocation, indexBytes);
+        }
+        else
+        {
+            glGenVertexArrays(1, &m_vertexArrayObject);
+            glGenBuffers(1, &m_vertexBufferObject);
+            glGenBuffers(1, &m_elementBufferObject);
+
+            glBindVertexArray(m_vertexArrayObject);
+            instanceBuffer().attach();
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_elementBufferObject);
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+                         static_cast<GLsizeiptr>(indexBytes.size()),
+                         indexBytes.data(),
+                         GL_STATIC_DRAW);
+        }
+
+        switch (m_vertexFormat)
+        {
+            case VertexFormat::Full:
+                uploadVertices(vertices);
+                break;
+            case VertexFormat::Packed:
+                uploadVertices<PackedVertex>(vertices | std::views::transform(pack) | std::ranges::to<std::vector>());
+                break;
+            case VertexFormat::Quantized:
+                m_dequantization = dequantization(vertices);
+                uploadVertices<QuantizedVertex>(vertices
+                                                | std::views::transform([this](const auto& vertex)
+                                                {
+                                                    return quantize(vertex, m_dequantization);
+                                                })
+                                                | std::ranges::to<std::vector>());
+                break;
+        }
 
         glBindVertexArray(0);
     }
 
-    std::vector<Mesh::texture_type> Mesh::loadMaterialTextures(const aiMaterial* material,
-                                                               const aiTextureType assimpTextureType) const
+    void Mesh::loadTextures(const std::span<const TextureReference> textures)
+    {
+        for (const auto& [path, type] : textures)
+        {
+            m_textures.emplace_back(loadTextureFromFile(path, type), type, path);
+        }
+
+        if (m_textures.empty())
+        {
+            std::println(stderr, "No texture is loaded");
+        }
+    }
+
+    std::vector<TextureReference> Mesh::materialTextures(const aiMaterial* material,
+                                                         const std::filesystem::path& directory)
     {
-        std::vector<texture_type> textures{};
-        for (std::size_t i{ 0 }; i < material->GetTextureCount(assimpTextureType); ++i)
+        std::vector<TextureReference> textures{};
+        for (const auto textureType : supportedTextureTypes)
         {
-            aiString textureFilename{};
-            material->GetTexture(assimpTextureType, i, &textureFilename);
-            std::string texturePath{ textureFilename.C_Str() };
+            for (std::size_t i{ 0 }; i < material->GetTextureCount(textureType); ++i)
+            {
+                aiString textureFilename{};
+                material->GetTexture(textureType, i, &textureFilename);
+                textures.push_back({
+                    .path = resolveTexturePath(directory, textureFilename),
+                    .type = from(textureType)
+                });
+            }
+        }
+        return textures;
+    }
+
+    std::filesystem::path Mesh::resolveTexturePath(const std::filesystem::path& directory,
+                                                   const aiString& textureFilename)
+    {
+        std::string texturePath{ textureFilename.C_Str() };
 #ifndef _WIN32
-            std::ranges::replace(texturePath, '\\', '/');
+        std::ranges::replace(texturePath, '\\', '/');
 #endif
-            const auto path{
-                std::filesystem::canonical(m_parent->directory() / texturePath)
+        return std::filesystem::canonical(directory / texturePath)
                .make_preferred()
-               .lexically_normal()
-            };
-            textures.emplace_back(loadTextureFromFile(path),
-                                  from(assimpTextureType),
-                                  path);
-        }
-        return textures;
+               .lexically_normal();
     }
 
+    bool Mesh::isTextureCached(const TextureReference& texture)
+    {
+        return s_textureCache.contains(texture);
+    }
 
-    Mesh::handle_type Mesh::loadTextureFromFile(const std::filesystem::path& path)
+    CookedTexture Mesh::decodeTexture(const std::filesystem::path& path, const Texture::Type type)
     {
-        // Check if the texture is already in the cache
-        if (s_textureCache.contains(path))
+        // GPU-ready containers are uploaded as stored, straight from the mapping unless their rows need flipping
+        if (auto container{ mapTextureContainer(path) })
         {
-            return s_textureCache.at(path);
+            const auto storedFormat{ container->compressedFormat };
+            auto texture{ CookedTexture::fromContainer(path, std::move(*container)) };
+            if (texture.compressedFormat() != storedFormat)
+            {
+                std::println(stderr,
+                             "'{}' stores {} blocks top-down, which cannot be flipped without decoding; uploading it "
+                             "uncompressed",
+                             path.string(),
+                             storedFormat);
+            }
+            return texture;
         }
 
-        // Texture not in cache, load it
-        const auto image{ loadImage(path).flipVertically() };
+        const auto options{ mipmapOptions(type) };
+        const auto compression{ compressedFormat(type) };
+        if (auto cooked{ CookedTexture::load(path, options, compression) })
+        {
+            return std::move(*cooked);
+        }
+
+        auto image{ loadImage(path, { .flipVertically = true }) };
+        if (image.rowOrder != ImageData::RowOrder::BottomUp)
+        {
+            image.flipVerticallyInPlace();
+        }
+        return CookedTexture::cook(path, std::move(image), options, compression);
+    }
+
+    void Mesh::uploadTexture(const TextureReference& reference, const CookedTexture& texture)
+    {
+        const auto key{ contentKey(texture) };
+        if (s_textureCache.alias(reference, key))
+        {
+            return;
+        }
 
         GLuint mapId{};
         glGenTextures(1, &mapId);
@@ -270,35 +711,157 @@ namespace lgl
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-        const auto format{ gl_cast(image.pixelFormat) };
-
-        glTexImage2D(
-            GL_TEXTURE_2D,
-            0,
-            format,
-            static_cast<GLsizei>(image.width),
-            static_cast<GLsizei>(image.height),
-            0,
-            format,
-            GL_UNSIGNED_BYTE,
-            image.span().data()
-        );
-        glGenerateMipmap(GL_TEXTURE_2D);
+        const auto compressed{ texture.compressedFormat() };
+        const auto levels{ texture.levels() };
+        std::size_t size{ 0 };
+        const auto uploadCompressed{
+            compressed != CompressedFormat::None && GLCapabilities::current().supports(compressed)
+        };
+
+        // Rows of the smaller mip levels are not 4-byte aligned
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        for (auto&& [level, mipLevel] : std::views::enumerate(levels))
+        {
+            if (uploadCompressed)
+            {
+                glCompressedTexImage2D(
+                    GL_TEXTURE_2D,
+                    static_cast<GLint>(level),
+                    gl_cast(compressed),
+                    static_cast<GLsizei>(mipLevel.width),
+                    static_cast<GLsizei>(mipLevel.height),
+                    0,
+                    static_cast<GLsizei>(mipLevel.data.size()),
+                    mipLevel.data.data()
+                );
+                size += mipLevel.data.size();
+                continue;
+            }
+
+            const auto decompressed{
+                compressed == CompressedFormat::None
+                ? ImageData{}
+                : decompress(mipLevel.data, mipLevel.width, mipLevel.height, compressed)
+            };
+            const auto format{
+                gl_cast(compressed == CompressedFormat::None ? texture.pixelFormat() : decompressed.pixelFormat)
+            };
+            glTexImage2D(
+                GL_TEXTURE_2D,
+                static_cast<GLint>(level),
+                format,
+                static_cast<GLsizei>(mipLevel.width),
+                static_cast<GLsizei>(mipLevel.height),
+                0,
+                format,
+                GL_UNSIGNED_BYTE,
+                compressed == CompressedFormat::None ? mipLevel.data.data() : decompressed.data.data()
+            );
+            size += compressed == CompressedFormat::None ? mipLevel.data.size() : decompressed.data.size();
+        }
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(levels.size()) - 1);
 
         glBindTexture(GL_TEXTURE_2D, 0);
 
         // Store the texture in the cache
-        s_textureCache.emplace(path, mapId);
+        s_textureCache.insert(reference, key, mapId, size);
+    }
+
+    Mesh::handle_type Mesh::loadTextureFromFile(const std::filesystem::path& path, const Texture::Type type)
+    {
+        // Check if the texture is already in the cache
+        const TextureReference reference{ .path = path, .type = type };
+        if (const auto handle{ s_textureCache.acquire(reference) })
+        {
+            return *handle;
+        }
 
-        return mapId;
+        // Texture not in cache, load it
+        uploadTexture(reference, decodeTexture(path, type));
+        return *s_textureCache.acquire(reference);
     }
 
-    void Mesh::clearTextureCache()
+    void Mesh::setCompressedFormat(const Texture::Type type, const std::optional<CompressedFormat> format)
+    {
+        s_compressedFormats.at(static_cast<std::size_t>(type)) = format;
+    }
+
+    std::optional<CompressedFormat> Mesh::compressedFormat(const Texture::Type type)
+    {
+        return s_compressedFormats.at(static_cast<std::size_t>(type));
+    }
+
+    TextureCache& Mesh::textureCache() noexcept
     {
-        for (auto textureId : s_textureCache | std::views::values)
+        return s_textureCache;
+    }
+
+    void Mesh::setVertexFormat(const VertexFormat format) noexcept
+    {
+        s_vertexFormat = format;
+    }
+
+    VertexFormat Mesh::vertexFormat() noexcept
+    {
+        return s_vertexFormat;
+    }
+
+    void Mesh::setBufferAllocation(const BufferAllocation allocation) noexcept
+    {
+        s_bufferAllocation = allocation;
+    }
+
+    BufferAllocation Mesh::bufferAllocation() noexcept
+    {
+        return s_bufferAllocation;
+    }
+
+    GeometryBuffer& Mesh::sharedGeometryBuffer(const VertexFormat format)
+    {
+        auto& geometryBuffer{ s_geometryBuffers.at(static_cast<std::size_t>(format)) };
+        if (!geometryBuffer.has_value())
         {
-            glDeleteTextures(1, &textureId);
+            switch (format)
+            {
+                case VertexFormat::Full:
+                    geometryBuffer.emplace(GeometryBuffer::create<Vertex>());
+                    break;
+                case VertexFormat::Packed:
+                    geometryBuffer.emplace(GeometryBuffer::create<PackedVertex>());
+                    break;
+                case VertexFormat::Quantized:
+                    geometryBuffer.emplace(GeometryBuffer::create<QuantizedVertex>());
+                    break;
+            }
+            // Growing replaces the buffers but keeps the vertex array, so this holds for good
+            glBindVertexArray(geometryBuffer->vertexArray());
+            instanceBuffer().attach();
+            glBindVertexArray(0);
+        }
+        return *geometryBuffer;
+    }
+
+    InstanceBuffer& Mesh::instanceBuffer()
+    {
+        if (!s_instanceBuffer.has_value())
+        {
+            s_instanceBuffer.emplace();
         }
+        return *s_instanceBuffer;
+    }
+
+    void Mesh::releaseTextures() noexcept
+    {
+        for (const auto& texture : m_textures)
+        {
+            s_textureCache.release({ .path = texture.path, .type = texture.type });
+        }
+        m_textures.clear();
+    }
+
+    void Mesh::clearTextureCache()
+    {
         s_textureCache.clear();
     }
 } // lgl
@@ -0,0 +1,460 @@
+//
+// Created by user on 10/17/26.
+//
+
+#include "app/MeshOptimization.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <unordered_set>
+#include <glm/geometric.hpp>
+#include "app/utilities.h"
+
+namespace
+{
+    constexpr auto UNUSED{ std::numeric_limits<uint32_t>::max() };
+
+    // Triangles around each vertex, in compressed rows
+    struct Adjacency
+    {
+        std::vector<uint32_t> offsets;
+        std::vector<uint32_t> triangles;
+
+        [[nodiscard]] std::span<const uint32_t> of(const uint32_t vertex) const noexcept
+        {
+            return std::span{ triangles }.subspan(offsets[vertex], offsets[vertex + 1] - offsets[vertex]);
+        }
+    };
+
+    Adjacency buildAdjacency(const std::span<const uint32_t> indices, const std::size_t vertexCount)
+    {
+        Adjacency adjacency{ .offsets = std::vector<uint32_t>(vertexCount + 1, 0), .triangles = {} };
+        for (const auto index : indices)
+        {
+            ++adjacency.offsets[index + 1];
+        }
+        std::inclusive_scan(adjacency.offsets.begin(), adjacency.offsets.end(), adjacency.offsets.begin());
+
+        adjacency.triangles.resize(indices.size());
+        auto fill{ adjacency.offsets };
+        for (std::size_t i{ 0 }; i < indices.size(); ++i)
+        {
+            adjacency.triangles[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+        return adjacency;
+    }
+
+    /**
+     * Timestamp-based FIFO cache: a vertex is resident while fewer than cacheSize misses happened since it entered.
+     * Advancing the timestamp past cacheSize flushes the cache in O(1)
+     */
+    class CacheSimulation
+    {
+    public:
+        CacheSimulation(const std::size_t vertexCount, const std::size_t cacheSize)
+            : m_entryTimes(vertexCount, 0),
+              m_cacheSize{ static_cast<uint32_t>(cacheSize) },
+              m_time{ static_cast<uint32_t>(cacheSize) + 1 }
+        {
+        }
+
+        [[nodiscard]] bool contains(const uint32_t vertex) const noexcept
+        {
+            return m_time - m_entryTimes[vertex] <= m_cacheSize;
+        }
+
+        // Age of a resident vertex, 1 for the most recently transformed
+        [[nodiscard]] uint32_t age(const uint32_t vertex) const noexcept
+        {
+            return m_time - m_entryTimes[vertex];
+        }
+
+        // Returns whether the vertex had to be transformed
+        bool access(const uint32_t vertex) noexcept
+        {
+            if (contains(vertex))
+            {
+                return false;
+            }
+            m_entryTimes[vertex] = m_time++;
+            return true;
+        }
+
+        std::size_t access(const std::span<const uint32_t, 3> triangle) noexcept
+        {
+            return static_cast<std::size_t>(access(triangle[0])) + access(triangle[1]) + access(triangle[2]);
+        }
+
+        void flush() noexcept
+        {
+            m_time += m_cacheSize + 1;
+        }
+
+    private:
+        std::vector<uint32_t> m_entryTimes;
+        uint32_t m_cacheSize;
+        uint32_t m_time;
+    };
+
+    std::span<const uint32_t, 3> triangleAt(const std::span<const uint32_t> indices, const std::size_t triangle)
+    {
+        return indices.subspan(triangle * 3).first<3>();
+    }
+
+    // Transformed vertices per triangle of [first, last) with a cold cache
+    float clusterAcmr(const std::span<const uint32_t> indices,
+                      const std::size_t first,
+                      const std::size_t last,
+                      CacheSimulation& cache)
+    {
+        cache.flush();
+        std::size_t misses{ 0 };
+        for (auto triangle{ first }; triangle < last; ++triangle)
+        {
+            misses += cache.access(triangleAt(indices, triangle));
+        }
+        return static_cast<float>(misses) / static_cast<float>(last - first);
+    }
+}
+
+namespace lgl
+{
+    VertexCacheStatistics analyzeVertexCache(const std::span<const uint32_t> indices,
+                                             const std::size_t vertexCount,
+                                             const std::size_t cacheSize)
+    {
+        if (indices.empty())
+        {
+            return {};
+        }
+
+        CacheSimulation cache{ vertexCount, cacheSize };
+        std::vector<bool> used(vertexCount, false);
+        std::size_t misses{ 0 };
+        std::size_t usedCount{ 0 };
+        for (const auto index : indices)
+        {
+            misses += cache.access(index);
+            if (!used[index])
+            {
+                used[index] = true;
+                ++usedCount;
+            }
+        }
+        return {
+            .acmr = static_cast<float>(misses) / static_cast<float>(indices.size() / 3),
+            .atvr = static_cast<float>(misses) / static_cast<float>(usedCount)
+        };
+    }
+
+    void weldVertices(std::vector<Vertex>& vertices, const std::span<uint32_t> indices)
+    {
+        const auto bytesOf{
+            [&vertices](const uint32_t index)
+            {
+                return std::as_bytes(std::span{ &vertices[index], 1 });
+            }
+        };
+        const auto hash{
+            [&bytesOf](const uint32_t index)
+            {
+                return static_cast<std::size_t>(hash64(bytesOf(index)));
+            }
+        };
+        const auto equal{
+            [&bytesOf](const uint32_t lhs, const uint32_t rhs)
+            {
+                return std::memcmp(bytesOf(lhs).data(), bytesOf(rhs).data(), sizeof(Vertex)) == 0;
+            }
+        };
+
+        // Every vertex maps to the first one with the same bytes
+        std::unordered_set<uint32_t, decltype(hash), decltype(equal)> unique{ vertices.size(), hash, equal };
+        std::vector<uint32_t> remap(vertices.size());
+        for (uint32_t i{ 0 }; i < vertices.size(); ++i)
+        {
+            remap[i] = *unique.insert(i).first;
+        }
+        for (auto& index : indices)
+        {
+            index = remap[index];
+        }
+        // Duplicates stay in place unreferenced until optimizeVertexFetch drops them
+    }
+
+    std::vector<std::size_t> optimizeVertexCache(const std::span<uint32_t> indices,
+                                                 const std::size_t vertexCount,
+                                                 const std::size_t cacheSize)
+    {
+        const auto triangleCount{ indices.size() / 3 };
+        if (triangleCount == 0)
+        {
+            return {};
+        }
+
+        const auto adjacency{ buildAdjacency(indices, vertexCount) };
+        std::vector<uint32_t> liveTriangles(vertexCount);
+        for (uint32_t vertex{ 0 }; vertex < vertexCount; ++vertex)
+        {
+            liveTriangles[vertex] = static_cast<uint32_t>(adjacency.of(vertex).size());
+        }
+
+        CacheSimulation cache{ vertexCount, cacheSize };
+        std::vector<bool> emitted(triangleCount, false);
+        std::vector<uint32_t> deadEnds{};
+        std::vector<uint32_t> candidates{};
+        std::vector<uint32_t> result{};
+        result.reserve(indices.size());
+        std::vector<std::size_t> clusters{ 0 };
+        uint32_t nextVertex{ 0 };
+
+        auto fanning{ indices[0] };
+        while (fanning != UNUSED)
+        {
+            // Emit every remaining triangle around the fanning vertex
+            candidates.clear();
+            for (const auto triangle : adjacency.of(fanning))
+            {
+                if (emitted[triangle])
+                {
+                    continue;
+                }
+                emitted[triangle] = true;
+                for (const auto vertex : triangleAt(indices, triangle))
+                {
+                    result.push_back(vertex);
+                    deadEnds.push_back(vertex);
+                    candidates.push_back(vertex);
+                    --liveTriangles[vertex];
+                    cache.access(vertex);
+                }
+            }
+
+            // Prefer the oldest candidate that stays resident while its remaining triangles are emitted
+            auto best{ UNUSED };
+            auto bestPriority{ -1 };
+            for (const auto vertex : candidates)
+            {
+                if (liveTriangles[vertex] == 0)
+                {
+                    continue;
+                }
+                auto priority{ 0 };
+                if (cache.age(vertex) + 2 * liveTriangles[vertex] <= cacheSize)
+                {
+                    priority = static_cast<int>(cache.age(vertex));
+                }
+                if (priority > bestPriority)
+                {
+                    best = vertex;
+                    bestPriority = priority;
+                }
+            }
+
+            if (best == UNUSED)
+            {
+                // Dead end: back up to a recent vertex with triangles left, else take the next one in order
+                while (!deadEnds.empty() && best == UNUSED)
+                {
+                    if (liveTriangles[deadEnds.back()] > 0)
+                    {
+                        best = deadEnds.back();
+                    }
+                    deadEnds.pop_back();
+                }
+                while (best == UNUSED && nextVertex < vertexCount)
+                {
+                    if (liveTriangles[nextVertex] > 0)
+                    {
+                        best = nextVertex;
+                    }
+                    ++nextVertex;
+                }
+                if (best != UNUSED && !cache.contains(best))
+                {
+                    clusters.push_back(result.size() / 3);
+                }
+            }
+            fanning = best;
+        }
+
+        std::ranges::copy(result, indices.begin());
+        return clusters;
+    }
+
+    void optimizeOverdraw(const std::span<uint32_t> indices,
+                          const std::span<const Vertex> vertices,
+                          const std::span<const std::size_t> clusters,
+                          const float threshold,
+                          const std::size_t cacheSize)
+    {
+        const auto triangleCount{ indices.size() / 3 };
+        if (triangleCount == 0 || clusters.empty())
+        {
+            return;
+        }
+
+        // Split hard clusters wherever the running ACMR is already as good as the whole cluster's
+        CacheSimulation cache{ vertices.size(), cacheSize };
+        std::vector<std::size_t> softClusters{};
+        for (std::size_t i{ 0 }; i < clusters.size(); ++i)
+        {
+            const auto first{ clusters[i] };
+            const auto last{ i + 1 < clusters.size() ? clusters[i + 1] : triangleCount };
+            const auto limit{ clusterAcmr(indices, first, last, cache) * threshold };
+
+            softClusters.push_back(first);
+            cache.flush();
+            std::size_t misses{ 0 };
+            std::size_t triangles{ 0 };
+            for (auto triangle{ first }; triangle < last; ++triangle)
+            {
+                misses += cache.access(triangleAt(indices, triangle));
+                ++triangles;
+                if (triangle + 1 < last && static_cast<float>(misses) <= limit * static_cast<float>(triangles))
+                {
+                    softClusters.push_back(triangle + 1);
+                    cache.flush();
+                    misses = 0;
+                    triangles = 0;
+                }
+            }
+        }
+
+        // Occlusion potential: clusters far out along their own normal are likely in front of the rest
+        glm::vec3 meshCentroid{ 0.0f };
+        for (std::size_t triangle{ 0 }; triangle < triangleCount; ++triangle)
+        {
+            for (const auto vertex : triangleAt(indices, triangle))
+            {
+                meshCentroid += vertices[vertex].position;
+            }
+        }
+        meshCentroid /= static_cast<float>(indices.size());
+
+        struct Cluster
+        {
+            std::size_t first;
+            std::size_t last;
+            float sortKey;
+        };
+        std::vector<Cluster> sorted{};
+        sorted.reserve(softClusters.size());
+        for (std::size_t i{ 0 }; i < softClusters.size(); ++i)
+        {
+            const auto first{ softClusters[i] };
+            const auto last{ i + 1 < softClusters.size() ? softClusters[i + 1] : triangleCount };
+
+            glm::vec3 centroid{ 0.0f };
+            glm::vec3 normal{ 0.0f };
+            float area{ 0.0f };
+            for (auto triangle{ first }; triangle < last; ++triangle)
+            {
+                const auto corners{ triangleAt(indices, triangle) };
+                const auto& a{ vertices[corners[0]].position };
+                const auto& b{ vertices[corners[1]].position };
+                const auto& c{ vertices[corners[2]].position };
+                // Twice the area, along the face normal
+                const auto weightedNormal{ glm::cross(b - a, c - a) };
+                const auto triangleArea{ glm::length(weightedNormal) };
+                centroid += (a + b + c) * (triangleArea / 3.0f);
+                normal += weightedNormal;
+                area += triangleArea;
+            }
+
+            const auto normalLength{ glm::length(normal) };
+            const auto sortKey{
+                area > 0.0f && normalLength > 0.0f
+                ? glm::dot(centroid / area - meshCentroid, normal / normalLength)
+                : std::numeric_limits<float>::lowest()
+            };
+            sorted.push_back({ .first = first, .last = last, .sortKey = sortKey });
+        }
+        std::ranges::stable_sort(sorted, std::ranges::greater{}, &Cluster::sortKey);
+
+        std::vector<uint32_t> result{};
+        result.reserve(indices.size());
+        for (const auto& cluster : sorted)
+        {
+            result.append_range(indices.subspan(cluster.first * 3, (cluster.last - cluster.first) * 3));
+        }
+        std::ranges::copy(result, indices.begin());
+    }
+
+    void optimizeVertexFetch(std::vector<Vertex>& vertices, const std::span<uint32_t> indices)
+    {
+        std::vector<uint32_t> remap(vertices.size(), UNUSED);
+        std::vector<Vertex> reordered{};
+        reordered.reserve(vertices.size());
+        for (auto& index : indices)
+        {
+            if (remap[index] == UNUSED)
+            {
+                remap[index] = static_cast<uint32_t>(reordered.size());
+                reordered.push_back(vertices[index]);
+            }
+            index = remap[index];
+        }
+        vertices = std::move(reordered);
+    }
+
+    MeshOptimizationResult optimizeMesh(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+    {
+        MeshOptimizationResult result{
+            .vertexCountBefore = vertices.size(),
+            .before = analyzeVertexCache(indices, vertices.size())
+        };
+
+        weldVertices(vertices, indices);
+        const auto clusters{ optimizeVertexCache(indices, vertices.size()) };
+        optimizeOverdraw(indices, vertices, clusters);
+        optimizeVertexFetch(vertices, indices);
+
+        result.vertexCountAfter = vertices.size();
+        result.after = analyzeVertexCache(indices, vertices.size());
+        return result;
+    }
+
+    std::vector<MeshPart> splitMesh(const std::span<const Vertex> vertices,
+                                    const std::span<const uint32_t> indices,
+                                    const std::size_t maxVertexCount)
+    {
+        std::vector<MeshPart> parts{};
+        // Index of each source vertex within the current part, valid while its generation matches
+        std::vector<uint32_t> remap(vertices.size(), UNUSED);
+        std::vector<uint32_t> generations(vertices.size(), 0);
+        uint32_t generation{ 0 };
+
+        for (std::size_t i{ 0 }; i < indices.size(); i += 3)
+        {
+            const auto triangle{ triangleAt(indices, i / 3) };
+            const auto newVertices{
+                std::ranges::count_if(triangle,
+                                      [&](const uint32_t vertex)
+                                      {
+                                          return generations[vertex] != generation;
+                                      })
+            };
+            if (parts.empty() || parts.back().vertices.size() + static_cast<std::size_t>(newVertices) > maxVertexCount)
+            {
+                parts.emplace_back();
+                ++generation;
+            }
+
+            auto& part{ parts.back() };
+            for (const auto vertex : triangle)
+            {
+                if (generations[vertex] != generation)
+                {
+                    generations[vertex] = generation;
+                    remap[vertex] = static_cast<uint32_t>(part.vertices.size());
+                    part.vertices.push_back(vertices[vertex]);
+                }
+                part.indices.push_back(remap[vertex]);
+            }
+        }
+        return parts;
+    }
+} // lgl
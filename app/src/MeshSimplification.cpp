@@ -0,0 +1,315 @@
+//
+// Created by user on 10/17/26.
+//
+
+#include "app/MeshSimplification.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numeric>
+#include <tuple>
+#include <unordered_map>
+#include <glm/geometric.hpp>
+#include "app/MeshOptimization.h"
+#include "app/utilities.h"
+
+namespace
+{
+    // Symmetric 4x4 matrix of the squared distance to a set of planes
+    struct Quadric
+    {
+        double a00{ 0 }, a01{ 0 }, a02{ 0 }, a11{ 0 }, a12{ 0 }, a22{ 0 };
+        double b0{ 0 }, b1{ 0 }, b2{ 0 };
+        double c{ 0 };
+
+        static Quadric fromPlane(const glm::vec3& normal, const float distance) noexcept
+        {
+            const double x{ normal.x }, y{ normal.y }, z{ normal.z }, d{ distance };
+            return {
+                .a00 = x * x, .a01 = x * y, .a02 = x * z, .a11 = y * y, .a12 = y * z, .a22 = z * z,
+                .b0 = x * d, .b1 = y * d, .b2 = z * d,
+                .c = d * d
+            };
+        }
+
+        Quadric& operator+=(const Quadric& other) noexcept
+        {
+            a00 += other.a00;
+            a01 += other.a01;
+            a02 += other.a02;
+            a11 += other.a11;
+            a12 += other.a12;
+            a22 += other.a22;
+            b0 += other.b0;
+            b1 += other.b1;
+            b2 += other.b2;
+            c += other.c;
+            return *this;
+        }
+
+        [[nodiscard]] double evaluate(const glm::vec3& point) const noexcept
+        {
+            const double x{ point.x }, y{ point.y }, z{ point.z };
+            const auto error{
+                a00 * x * x + 2 * a01 * x * y + 2 * a02 * x * z + a11 * y * y + 2 * a12 * y * z + a22 * z * z
+                + 2 * (b0 * x + b1 * y + b2 * z) + c
+            };
+            return std::max(error, 0.0);
+        }
+    };
+
+    struct Collapse
+    {
+        uint32_t from;
+        uint32_t to;
+        double cost;
+    };
+
+    [[nodiscard]] uint64_t edgeKey(const uint32_t from, const uint32_t to) noexcept
+    {
+        return static_cast<uint64_t>(from) << 32 | to;
+    }
+
+    // Vertices that must not move: on a border, on a non-manifold edge or sharing their position with another vertex
+    std::vector<bool> lockedVertices(const std::span<const lgl::Vertex> vertices,
+                                     const std::span<const uint32_t> indices)
+    {
+        std::vector<bool> locked(vertices.size(), false);
+
+        const auto hash{
+            [&vertices](const uint32_t index)
+            {
+                return static_cast<std::size_t>(lgl::hash64(std::as_bytes(std::span{ &vertices[index].position, 1 })));
+            }
+        };
+        const auto equal{
+            [&vertices](const uint32_t lhs, const uint32_t rhs)
+            {
+                return vertices[lhs].position == vertices[rhs].position;
+            }
+        };
+        std::unordered_map<uint32_t, uint32_t, decltype(hash), decltype(equal)> positions{ vertices.size(), hash, equal };
+        for (uint32_t i{ 0 }; i < vertices.size(); ++i)
+        {
+            if (const auto [first, inserted]{ positions.emplace(i, i) }; !inserted)
+            {
+                locked[first->second] = true;
+                locked[i] = true;
+            }
+        }
+
+        std::unordered_map<uint64_t, uint32_t> edges{};
+        for (std::size_t i{ 0 }; i < indices.size(); i += 3)
+        {
+            for (std::size_t corner{ 0 }; corner < 3; ++corner)
+            {
+                ++edges[edgeKey(indices[i + corner], indices[i + (corner + 1) % 3])];
+            }
+        }
+        for (const auto& [key, count] : edges)
+        {
+            const auto from{ static_cast<uint32_t>(key >> 32) };
+            const auto to{ static_cast<uint32_t>(key) };
+            const auto reverse{ edges.find(edgeKey(to, from)) };
+            if (count != 1 || reverse == edges.end() || reverse->second != 1)
+            {
+                locked[from] = true;
+                locked[to] = true;
+            }
+        }
+        return locked;
+    }
+
+    [[nodiscard]] glm::vec3 faceNormal(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) noexcept
+    {
+        return glm::cross(b - a, c - a);
+    }
+
+    // Whether moving from onto to turns any triangle around from that does not contain to (nearly) upside down
+    bool flipsTriangles(const std::span<const lgl::Vertex> vertices,
+                        const std::span<const uint32_t> indices,
+                        const std::span<const uint32_t> triangles,
+                        const uint32_t from,
+                        const uint32_t to)
+    {
+        for (const auto triangle : triangles)
+        {
+            const auto corners{ indices.subspan(triangle * 3).first<3>() };
+            if (std::ranges::contains(corners, to))
+            {
+                continue;
+            }
+            std::array<glm::vec3, 3> moved{};
+            std::array<glm::vec3, 3> original{};
+            for (std::size_t corner{ 0 }; corner < 3; ++corner)
+            {
+                original[corner] = vertices[corners[corner]].position;
+                moved[corner] = corners[corner] == from ? vertices[to].position : original[corner];
+            }
+            // Rotating by more than about 75 degrees counts too; slivers standing up are as bad as flips
+            const auto before{ faceNormal(original[0], original[1], original[2]) };
+            const auto after{ faceNormal(moved[0], moved[1], moved[2]) };
+            if (glm::dot(before, after) <= 0.25f * glm::length(before) * glm::length(after))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+namespace lgl
+{
+    SimplifiedMesh simplify(const std::span<const Vertex> vertices,
+                            const std::span<const uint32_t> indices,
+                            const std::size_t targetIndexCount)
+    {
+        SimplifiedMesh result{ .indices = { indices.begin(), indices.end() }, .error = 0.0f };
+        const auto locked{ lockedVertices(vertices, indices) };
+
+        std::vector<Quadric> quadrics(vertices.size());
+        for (std::size_t i{ 0 }; i < indices.size(); i += 3)
+        {
+            const auto& a{ vertices[indices[i]].position };
+            const auto normal{ faceNormal(a, vertices[indices[i + 1]].position, vertices[indices[i + 2]].position) };
+            const auto length{ glm::length(normal) };
+            if (length <= 0.0f)
+            {
+                continue;
+            }
+            const auto unitNormal{ normal / length };
+            const auto plane{ Quadric::fromPlane(unitNormal, -glm::dot(unitNormal, a)) };
+            for (std::size_t corner{ 0 }; corner < 3; ++corner)
+            {
+                quadrics[indices[i + corner]] += plane;
+            }
+        }
+
+        std::vector<uint32_t> remap(vertices.size());
+        std::vector<bool> touched(vertices.size());
+        std::vector<Collapse> collapses{};
+        std::vector<std::vector<uint32_t>> triangles(vertices.size());
+        double maxCost{ 0.0 };
+        while (result.indices.size() > targetIndexCount)
+        {
+            // Each pass collapses independent edges, cheapest first, then rebuilds the triangles
+            for (auto& around : triangles)
+            {
+                around.clear();
+            }
+            collapses.clear();
+            for (uint32_t triangle{ 0 }; triangle < result.indices.size() / 3; ++triangle)
+            {
+                for (std::size_t corner{ 0 }; corner < 3; ++corner)
+                {
+                    const auto from{ result.indices[triangle * 3 + corner] };
+                    triangles[from].push_back(triangle);
+                    if (locked[from])
+                    {
+                        continue;
+                    }
+                    for (const auto to : { result.indices[triangle * 3 + (corner + 1) % 3],
+                                           result.indices[triangle * 3 + (corner + 2) % 3] })
+                    {
+                        auto quadric{ quadrics[from] };
+                        quadric += quadrics[to];
+                        collapses.push_back({ .from = from, .to = to, .cost = quadric.evaluate(vertices[to].position) });
+                    }
+                }
+            }
+            std::ranges::sort(collapses, {}, &Collapse::cost);
+
+            std::iota(remap.begin(), remap.end(), 0u);
+            touched.assign(touched.size(), false);
+            auto indexCount{ result.indices.size() };
+            std::size_t collapsed{ 0 };
+            for (const auto& [from, to, cost] : collapses)
+            {
+                if (indexCount <= targetIndexCount)
+                {
+                    break;
+                }
+                if (touched[from] || touched[to] || flipsTriangles(vertices, result.indices, triangles[from], from, to))
+                {
+                    continue;
+                }
+
+                remap[from] = to;
+                quadrics[to] += quadrics[from];
+                maxCost = std::max(maxCost, cost);
+                ++collapsed;
+                // Neighbors' triangles change shape, so they wait for the next pass
+                for (const auto triangle : triangles[from])
+                {
+                    const auto corners{ std::span{ result.indices }.subspan(triangle * 3).first<3>() };
+                    for (const auto vertex : corners)
+                    {
+                        touched[vertex] = true;
+                    }
+                    if (std::ranges::contains(corners, to))
+                    {
+                        indexCount -= 3;
+                    }
+                }
+            }
+            if (collapsed == 0)
+            {
+                break;
+            }
+
+            std::size_t kept{ 0 };
+            for (std::size_t i{ 0 }; i < result.indices.size(); i += 3)
+            {
+                const auto a{ remap[result.indices[i]] };
+                const auto b{ remap[result.indices[i + 1]] };
+                const auto c{ remap[result.indices[i + 2]] };
+                if (a == b || b == c || a == c)
+                {
+                    continue;
+                }
+                result.indices[kept++] = a;
+                result.indices[kept++] = b;
+                result.indices[kept++] = c;
+            }
+            result.indices.resize(kept);
+        }
+
+        result.error = static_cast<float>(std::sqrt(maxCost));
+        return result;
+    }
+
+    std::vector<MeshLod> buildLodChain(const std::span<const Vertex> vertices,
+                                       std::vector<uint32_t>& indices,
+                                       const LodOptions& options)
+    {
+        std::vector<MeshLod> lods{ { .firstIndex = 0, .indexCount = indices.size(), .error = 0.0f } };
+        const auto fullIndexCount{ indices.size() };
+
+        auto targetIndexCount{ fullIndexCount };
+        while (lods.size() < options.maxLevels)
+        {
+            targetIndexCount = static_cast<std::size_t>(static_cast<float>(targetIndexCount) * options.reduction) / 3 * 3;
+            if (targetIndexCount < options.minTriangleCount * 3)
+            {
+                break;
+            }
+
+            auto simplified{ simplify(vertices, std::span{ indices }.first(fullIndexCount), targetIndexCount) };
+            // Locked vertices can stall the reduction; a level saving little is not worth its memory
+            if (static_cast<float>(simplified.indices.size()) > 0.9f * static_cast<float>(lods.back().indexCount))
+            {
+                break;
+            }
+
+            std::ignore = optimizeVertexCache(simplified.indices, vertices.size());
+            lods.push_back({
+                .firstIndex = indices.size(),
+                .indexCount = simplified.indices.size(),
+                .error = std::max(simplified.error, lods.back().error)
+            });
+            indices.append_range(simplified.indices);
+        }
+        return lods;
+    }
+} // lgl
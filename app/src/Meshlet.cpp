@@ -0,0 +1,173 @@
+//
+// Created by user on 10/17/26.
+//
+
+#include "app/Meshlet.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+namespace lgl
+{
+    std::vector<Meshlet> buildMeshlets(const std::span<const uint32_t> indices,
+                                       const std::size_t firstIndex,
+                                       const std::size_t vertexCount)
+    {
+        std::vector<Meshlet> meshlets{};
+        // Vertices used by the current meshlet carry its generation
+        std::vector<uint32_t> generations(vertexCount, 0);
+        uint32_t generation{ 1 };
+        std::size_t meshletVertices{ 0 };
+        Meshlet current{ .firstIndex = firstIndex, .indexCount = 0 };
+
+        for (std::size_t i{ 0 }; i < indices.size(); i += 3)
+        {
+            const auto triangle{ indices.subspan(i, 3) };
+            const auto isNew{
+                [&](const std::size_t corner)
+                {
+                    return generations[triangle[corner]] != generation
+                           && std::ranges::find(triangle.first(corner), triangle[corner]) == triangle.begin() + corner;
+                }
+            };
+            auto newVertices{ static_cast<std::size_t>(isNew(0)) + isNew(1) + isNew(2) };
+
+            if (meshletVertices + newVertices > MAX_MESHLET_VERTICES
+                || current.indexCount / 3 + 1 > MAX_MESHLET_TRIANGLES)
+            {
+                meshlets.push_back(current);
+                current = { .firstIndex = firstIndex + i, .indexCount = 0 };
+                ++generation;
+                meshletVertices = 0;
+                newVertices = static_cast<std::size_t>(isNew(0)) + isNew(1) + isNew(2);
+            }
+
+            for (const auto vertex : triangle)
+            {
+                generations[vertex] = generation;
+            }
+            meshletVertices += newVertices;
+            current.indexCount += 3;
+        }
+        if (current.indexCount > 0)
+        {
+            meshlets.push_back(current);
+        }
+        return meshlets;
+    }
+
+    MeshletBounds computeMeshletBounds(const std::span<const Vertex> vertices, const std::span<const uint32_t> indices)
+    {
+        if (indices.empty())
+        {
+            return {};
+        }
+
+        auto minimum{ vertices[indices[0]].position };
+        auto maximum{ minimum };
+        for (const auto index : indices)
+        {
+            minimum = glm::min(minimum, vertices[index].position);
+            maximum = glm::max(maximum, vertices[index].position);
+        }
+        const auto center{ (minimum + maximum) * 0.5f };
+        float radius{ 0.0f };
+        for (const auto index : indices)
+        {
+            radius = std::max(radius, glm::distance(center, vertices[index].position));
+        }
+        MeshletBounds bounds{ .sphere = { .center = center, .radius = radius } };
+
+        // Normal cone: the average facing, widened to cover every triangle
+        std::vector<glm::vec3> normals{};
+        normals.reserve(indices.size() / 3);
+        glm::vec3 normalSum{ 0.0f };
+        for (std::size_t i{ 0 }; i < indices.size(); i += 3)
+        {
+            const auto& a{ vertices[indices[i]].position };
+            const auto normal{
+                glm::cross(vertices[indices[i + 1]].position - a, vertices[indices[i + 2]].position - a)
+            };
+            const auto length{ glm::length(normal) };
+            if (length > 0.0f)
+            {
+                normals.push_back(normal / length);
+                normalSum += normals.back();
+            }
+        }
+        const auto sumLength{ glm::length(normalSum) };
+        if (normals.empty() || sumLength <= std::numeric_limits<float>::epsilon())
+        {
+            return bounds;
+        }
+
+        bounds.coneAxis = normalSum / sumLength;
+        auto minimumDot{ 1.0f };
+        for (const auto& normal : normals)
+        {
+            minimumDot = std::min(minimumDot, glm::dot(bounds.coneAxis, normal));
+        }
+        // A cone of 90 degrees or more has a front face from every direction
+        bounds.coneCutoff = minimumDot <= 0.0f ? 1.0f : std::sqrt(1.0f - minimumDot * minimumDot);
+        return bounds;
+    }
+
+    MeshletCuller::MeshletCuller(const std::span<const MeshletBounds> bounds)
+    {
+        for (const auto& meshlet : bounds)
+        {
+            m_centerX.push_back(meshlet.sphere.center.x);
+            m_centerY.push_back(meshlet.sphere.center.y);
+            m_centerZ.push_back(meshlet.sphere.center.z);
+            m_radius.push_back(meshlet.sphere.radius);
+            m_axisX.push_back(meshlet.coneAxis.x);
+            m_axisY.push_back(meshlet.coneAxis.y);
+            m_axisZ.push_back(meshlet.coneAxis.z);
+            m_cutoff.push_back(meshlet.coneCutoff);
+        }
+    }
+
+    void MeshletCuller::cull(const Frustum& frustum,
+                             const glm::vec3& cameraPosition,
+                             const std::span<uint8_t> visible) const
+    {
+        const auto count{ std::min(size(), visible.size()) };
+        const auto* centerX{ m_centerX.data() };
+        const auto* centerY{ m_centerY.data() };
+        const auto* centerZ{ m_centerZ.data() };
+        const auto* radius{ m_radius.data() };
+        const auto* axisX{ m_axisX.data() };
+        const auto* axisY{ m_axisY.data() };
+        const auto* axisZ{ m_axisZ.data() };
+        const auto* cutoff{ m_cutoff.data() };
+
+        for (std::size_t i{ 0 }; i < count; ++i)
+        {
+            auto inside{ true };
+            for (const auto& plane : frustum.planes)
+            {
+                const auto distance{ plane.x * centerX[i] + plane.y * centerY[i] + plane.z * centerZ[i] + plane.w };
+                inside &= distance >= -radius[i];
+            }
+
+            // Every triangle faces away when the view direction is within the complement of the normal cone,
+            // widened by the sphere's angular size: dot(view, axis) >= cutoff * distance + radius
+            const auto viewX{ centerX[i] - cameraPosition.x };
+            const auto viewY{ centerY[i] - cameraPosition.y };
+            const auto viewZ{ centerZ[i] - cameraPosition.z };
+            const auto viewDistance{ std::sqrt(viewX * viewX + viewY * viewY + viewZ * viewZ) };
+            const auto facing{ viewX * axisX[i] + viewY * axisY[i] + viewZ * axisZ[i] };
+            const auto backFacing{ facing >= cutoff[i] * viewDistance + radius[i] };
+
+            visible[i] = static_cast<uint8_t>(inside & !backFacing);
+        }
+    }
+
+    std::size_t MeshletCuller::size() const noexcept
+    {
+        return m_centerX.size();
+    }
+} // lgl
@@ -0,0 +1,331 @@
+//
+// Created by user on 10/17/26.
+//
+
+#include "app/Mipmap.h"
+
+#include <array>
+#include <cmath>
+#include <numbers>
+
+namespace
+{
+    using Filter = lgl::MipmapOptions::Filter;
+    using ColorSpace = lgl::MipmapOptions::ColorSpace;
+
+    // Kaiser filter width in destination texels and its window shape
+    constexpr float KAISER_WIDTH{ 3.0f };
+    constexpr float KAISER_ALPHA{ 4.0f };
+
+    struct FloatImage
+    {
+        uint32_t width{ 0 };
+        uint32_t height{ 0 };
+        uint32_t channels{ 0 };
+        std::vector<float> data;
+    };
+
+    // Per destination texel: index of the first source texel and tapCount weights, zero-padded
+    struct FilterTaps
+    {
+        std::size_t tapCount{ 0 };
+        std::vector<int64_t> first;
+        std::vector<float> weights;
+    };
+
+    bool isAlphaChannel(const uint32_t channel, const uint32_t channels) noexcept
+    {
+        return (channels == 2 && channel == 1) || (channels == 4 && channel == 3);
+    }
+
+    // Whether a channel is stored sRGB-encoded; normal maps always hold linear vectors
+    bool isSrgbChannel(const uint32_t channel, const uint32_t channels, const lgl::MipmapOptions& options) noexcept
+    {
+        return options.colorSpace == ColorSpace::SRGB && !options.normalMap && !isAlphaChannel(channel, channels);
+    }
+
+    const std::array<float, 256>& srgbToLinearTable()
+    {
+        static const auto table{
+            []
+            {
+                std::array<float, 256> values{};
+                for (std::size_t i{ 0 }; i < values.size(); ++i)
+                {
+                    const auto encoded{ static_cast<float>(i) / 255.0f };
+                    values[i] = encoded <= 0.04045f
+                                ? encoded / 12.92f
+                                : std::pow((encoded + 0.055f) / 1.055f, 2.4f);
+                }
+                return values;
+            }()
+        };
+        return table;
+    }
+
+    uint8_t linearToSrgb(const float linear)
+    {
+        static const auto table{
+            []
+            {
+                std::array<uint8_t, 4096> values{};
+                for (std::size_t i{ 0 }; i < values.size(); ++i)
+                {
+                    const auto value{ static_cast<float>(i) / static_cast<float>(values.size() - 1) };
+                    const auto encoded{
+                        value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f
+                    };
+                    values[i] = static_cast<uint8_t>(std::lround(encoded * 255.0f));
+                }
+                return values;
+            }()
+        };
+        const auto index{ std::lround(std::clamp(linear, 0.0f, 1.0f) * static_cast<float>(table.size() - 1)) };
+        return table[static_cast<std::size_t>(index)];
+    }
+
+    FloatImage toFloat(const lgl::ImageData& image, const lgl::MipmapOptions& options)
+    {
+        FloatImage result{
+            .width = image.width,
+            .height = image.height,
+            .channels = image.channels,
+            .data = std::vector<float>(image.data.size())
+        };
+
+        const auto& linearTable{ srgbToLinearTable() };
+        for (std::size_t i{ 0 }; i < image.data.size(); ++i)
+        {
+            const auto value{ static_cast<uint8_t>(image.data[i]) };
+            const auto channel{ static_cast<uint32_t>(i % image.channels) };
+            result.data[i] = isSrgbChannel(channel, image.channels, options)
+                             ? linearTable[value]
+                             : static_cast<float>(value) / 255.0f;
+        }
+        return result;
+    }
+
+    lgl::ImageData toImage(const FloatImage& image, const lgl::ImageData& prototype, const lgl::MipmapOptions& options)
+    {
+        lgl::ImageData result{
+            .data = std::vector<std::byte>(image.data.size()),
+            .width = image.width,
+            .height = image.height,
+            .channels = prototype.channels,
+            .pixelFormat = prototype.pixelFormat,
+            .rowOrder = prototype.rowOrder
+        };
+
+        for (std::size_t i{ 0 }; i < image.data.size(); ++i)
+        {
+            const auto channel{ static_cast<uint32_t>(i % image.channels) };
+            result.data[i] = static_cast<std::byte>(
+                isSrgbChannel(channel, image.channels, options)
+                ? linearToSrgb(image.data[i])
+                : static_cast<uint8_t>(std::lround(std::clamp(image.data[i], 0.0f, 1.0f) * 255.0f)));
+        }
+        return result;
+    }
+
+    float sinc(const float x) noexcept
+    {
+        if (std::abs(x) < 1e-6f)
+        {
+            return 1.0f;
+        }
+        const auto angle{ std::numbers::pi_v<float> * x };
+        return std::sin(angle) / angle;
+    }
+
+    // Modified Bessel function of the first kind of order 0, by its power series; std::cyl_bessel_i is missing
+    // from libc++. Twelve terms are exact to float precision for arguments up to KAISER_ALPHA
+    constexpr float besselI0(const float x) noexcept
+    {
+        const auto half{ x * 0.5f };
+        auto term{ 1.0f };
+        auto sum{ 1.0f };
+        for (auto k{ 1 }; k < 12; ++k)
+        {
+            term *= half / static_cast<float>(k);
+            sum += term * term;
+        }
+        return sum;
+    }
+
+    float kaiserWindow(const float x) noexcept
+    {
+        if (std::abs(x) > 1.0f)
+        {
+            return 0.0f;
+        }
+        return besselI0(KAISER_ALPHA * std::sqrt(1.0f - x * x)) / besselI0(KAISER_ALPHA);
+    }
+
+    FilterTaps computeTaps(const uint32_t sourceSize, const uint32_t destinationSize, const Filter filter)
+    {
+        const auto scale{ static_cast<float>(sourceSize) / static_cast<float>(destinationSize) };
+        const auto radius{ filter == Filter::Box ? scale * 0.5f : KAISER_WIDTH * 0.5f * scale };
+
+        FilterTaps taps{};
+        taps.tapCount = static_cast<std::size_t>(std::ceil(radius * 2.0f)) + 1;
+        taps.first.resize(destinationSize);
+        taps.weights.resize(destinationSize * taps.tapCount);
+
+        for (uint32_t i{ 0 }; i < destinationSize; ++i)
+        {
+            const auto center{ (static_cast<float>(i) + 0.5f) * scale };
+            const auto first{ static_cast<int64_t>(std::floor(center - radius)) };
+            auto* weights{ taps.weights.data() + i * taps.tapCount };
+            auto sum{ 0.0f };
+            for (std::size_t t{ 0 }; t < taps.tapCount; ++t)
+            {
+                const auto texel{ static_cast<float>(first + static_cast<int64_t>(t)) };
+                float weight{};
+                if (filter == Filter::Box)
+                {
+                    // Overlap of the source texel with the destination footprint
+                    const auto low{ std::max(texel, center - radius) };
+                    const auto high{ std::min(texel + 1.0f, center + radius) };
+                    weight = std::max(high - low, 0.0f);
+                }
+                else
+                {
+                    const auto distance{ (texel + 0.5f - center) / scale };
+                    weight = sinc(distance) * kaiserWindow(distance / (KAISER_WIDTH * 0.5f));
+                }
+                weights[t] = weight;
+                sum += weight;
+            }
+            for (std::size_t t{ 0 }; t < taps.tapCount; ++t)
+            {
+                weights[t] /= sum;
+            }
+            taps.first[i] = first;
+        }
+        return taps;
+    }
+
+    std::size_t clampIndex(const int64_t index, const uint32_t size) noexcept
+    {
+        return static_cast<std::size_t>(std::clamp<int64_t>(index, 0, static_cast<int64_t>(size) - 1));
+    }
+
+    // Separable resampling: a vertical pass over whole rows, then a horizontal pass over the accumulated row.
+    // Both inner loops run over contiguous floats so the compiler can vectorize them.
+    FloatImage resample(const FloatImage& source, const uint32_t width, const uint32_t height, const Filter filter)
+    {
+        const auto channels{ source.channels };
+        const auto sourceRowLength{ static_cast<std::size_t>(source.width) * channels };
+        const auto destinationRowLength{ static_cast<std::size_t>(width) * channels };
+        const auto vertical{ computeTaps(source.height, height, filter) };
+        const auto horizontal{ computeTaps(source.width, width, filter) };
+
+        FloatImage result{
+            .width = width,
+            .height = height,
+            .channels = channels,
+            .data = std::vector<float>(destinationRowLength * height)
+        };
+        std::vector<float> row(sourceRowLength);
+
+        for (uint32_t y{ 0 }; y < height; ++y)
+        {
+            std::ranges::fill(row, 0.0f);
+            const auto* weights{ vertical.weights.data() + y * vertical.tapCount };
+            for (std::size_t t{ 0 }; t < vertical.tapCount; ++t)
+            {
+                const auto weight{ weights[t] };
+                if (weight == 0.0f)
+                {
+                    continue;
+                }
+                const auto* sourceRow{
+                    source.data.data() +
+                    clampIndex(vertical.first[y] + static_cast<int64_t>(t), source.height) * sourceRowLength
+                };
+                for (std::size_t i{ 0 }; i < sourceRowLength; ++i)
+                {
+                    row[i] += weight * sourceRow[i];
+                }
+            }
+
+            auto* destinationRow{ result.data.data() + y * destinationRowLength };
+            for (uint32_t x{ 0 }; x < width; ++x)
+            {
+                const auto* xWeights{ horizontal.weights.data() + x * horizontal.tapCount };
+                auto* destination{ destinationRow + static_cast<std::size_t>(x) * channels };
+                for (std::size_t t{ 0 }; t < horizontal.tapCount; ++t)
+                {
+                    const auto weight{ xWeights[t] };
+                    const auto* texel{
+                        row.data() +
+                        clampIndex(horizontal.first[x] + static_cast<int64_t>(t), source.width) * channels
+                    };
+                    for (uint32_t c{ 0 }; c < channels; ++c)
+                    {
+                        destination[c] += weight * texel[c];
+                    }
+                }
+            }
+        }
+        return result;
+    }
+
+    // Texels hold unit vectors remapped to [0, 1]; filtering shortens them
+    void renormalize(FloatImage& image) noexcept
+    {
+        if (image.channels < 3)
+        {
+            return;
+        }
+        for (std::size_t i{ 0 }; i < image.data.size(); i += image.channels)
+        {
+            auto* texel{ image.data.data() + i };
+            const auto x{ texel[0] * 2.0f - 1.0f };
+            const auto y{ texel[1] * 2.0f - 1.0f };
+            const auto z{ texel[2] * 2.0f - 1.0f };
+            const auto length{ std::sqrt(x * x + y * y + z * z) };
+            if (length > 1e-6f)
+            {
+                texel[0] = x / length * 0.5f + 0.5f;
+                texel[1] = y / length * 0.5f + 0.5f;
+                texel[2] = z / length * 0.5f + 0.5f;
+            }
+        }
+    }
+
+    FloatImage nextLevel(const FloatImage& image, const lgl::MipmapOptions& options)
+    {
+        auto result{
+            resample(image, std::max(image.width / 2, 1u), std::max(image.height / 2, 1u), options.filter)
+        };
+        if (options.normalMap)
+        {
+            renormalize(result);
+        }
+        return result;
+    }
+}
+
+namespace lgl
+{
+    ImageData downsample(const ImageData& image, const MipmapOptions& options)
+    {
+        return toImage(nextLevel(toFloat(image, options), options), image, options);
+    }
+
+    std::vector<ImageData> generateMipChain(ImageData image, const MipmapOptions& options)
+    {
+        std::vector<ImageData> levels{};
+        levels.reserve(mipLevelCount(image.width, image.height));
+
+        auto current{ toFloat(image, options) };
+        levels.push_back(std::move(image));
+        while (current.width > 1 || current.height > 1)
+        {
+            current = nextLevel(current, options);
+            levels.push_back(toImage(current, levels.front(), options));
+        }
+        return levels;
+    }
+} // lgl
@@ -5,14 +5,86 @@
 #include "app/Model.h"
 
 #include <algorithm>
+#include <exception>
+#include <expected>
+#include <format>
+#include <iterator>
 #include <print>
+#include <ranges>
+#include <tuple>
 #include <utility>
+#include <assimp/DefaultIOSystem.h>
 #include <assimp/postprocess.h>
+#include <glm/geometric.hpp>
+#include <glm/matrix.hpp>
+#include <glm/trigonometric.hpp>
+#include "app/ConcurrentQueue.h"
+#include "app/ThreadPool.h"
+
+namespace
+{
+    // Largest screen-space error a level of detail may have, in pixels
+    constexpr auto LOD_ERROR_PIXELS{ 1.0f };
+    // Fraction of that error a coarser level must stay under before it replaces the current one
+    constexpr auto LOD_HYSTERESIS{ 0.5f };
+
+    std::size_t selectLod(const std::span<const lgl::MeshLod> lods,
+                          std::size_t current,
+                          const float pixelsPerUnit)
+    {
+        const auto pixels{
+            [&](const std::size_t lod)
+            {
+                return lods[lod].error * pixelsPerUnit;
+            }
+        };
+
+        current = std::min(current, lods.size() - 1);
+        while (current > 0 && pixels(current) > LOD_ERROR_PIXELS)
+        {
+            --current;
+        }
+        while (current + 1 < lods.size() && pixels(current + 1) < LOD_ERROR_PIXELS * LOD_HYSTERESIS)
+        {
+            ++current;
+        }
+        return current;
+    }
+
+    // Remembers every file an import opens, so a cooked model can tell when its source changed
+    class RecordingIOSystem final : public Assimp::DefaultIOSystem
+    {
+    public:
+        Assimp::IOStream* Open(const char* file, const char* mode) override
+        {
+            const auto stream{ DefaultIOSystem::Open(file, mode) };
+            if (stream != nullptr)
+            {
+                auto path{ std::filesystem::absolute(file).lexically_normal() };
+                if (!std::ranges::contains(m_openedFiles, path))
+                {
+                    m_openedFiles.push_back(std::move(path));
+                }
+            }
+            return stream;
+        }
+
+        [[nodiscard]] std::span<const std::filesystem::path> openedFiles() const noexcept
+        {
+            return m_openedFiles;
+        }
+
+    private:
+        std::vector<std::filesystem::path> m_openedFiles;
+    };
+}
 
 namespace lgl
 {
     Model Model::load(const std::filesystem::path& path)
     {
+        const auto startTime{ std::chrono::steady_clock::now() };
+
         if (!std::filesystem::exists(path))
         {
             std::println(stderr, "'{}' not exist", path.string());
@@ -25,35 +97,271 @@ namespace lgl
             throw std::runtime_error("Not a regular file");
         }
 
-        Assimp::Importer importer{};
-        const auto scene{
-            importer.ReadFile(std::filesystem::absolute(path).c_str(),
-                              aiProcess_Triangulate | aiProcess_FlipUVs)
-        };
+        Model model{ std::filesystem::absolute(path.parent_path()) };
+        const auto savedBytes{ Mesh::textureCache().savedBytes() };
+        if (const auto cooked{ CookedModel::load(path) })
+        {
+            std::vector<TextureReference> textures{};
+            for (const auto& mesh : cooked->meshes())
+            {
+                textures.append_range(mesh.textures);
+            }
+            model.loadTextures(textures);
+            model.m_nodes.assign(cooked->nodes().begin(), cooked->nodes().end());
+            model.m_meshes.reserve(cooked->meshes().size());
+            for (const auto& mesh : cooked->meshes())
+            {
+                model.m_meshes.emplace_back(mesh);
+            }
+            model.m_statistics.cookedModelHit = true;
+        }
+        else
+        {
+            model.importScene(path);
+        }
 
-        if (scene == nullptr || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || scene->mRootNode == nullptr)
+        model.groupMeshes();
+        for (const auto& mesh : model.m_meshes)
         {
-            std::println(stderr, "[Assimp::Importer] {}", importer.GetErrorString());
-            throw std::runtime_error("Failed to load model");
+            if (mesh.indexType() == GL_UNSIGNED_SHORT)
+            {
+                ++model.m_statistics.shortIndexMeshCount;
+                // The same indices at 32 bits would take twice the size
+                model.m_statistics.savedIndexBytes += mesh.indexBufferSize();
+            }
         }
 
-        Model model{ std::filesystem::absolute(path.parent_path()) };
-        model.processNodes(scene->mRootNode, scene);
+        // Textures uploaded for this model are referenced by its meshes now; anything else may go
+        Mesh::textureCache().trim();
+        model.m_statistics.deduplicatedTextureBytes = Mesh::textureCache().savedBytes() - savedBytes;
+        model.m_statistics.totalTime = std::chrono::steady_clock::now() - startTime;
+
+        std::println("[Model] '{}': {} in {:.2f} ms; {} of {} meshes with 16-bit indices ({} KiB saved, {} split), "
+                     "{} draw groups; {} textures ({} cooked, {} KiB deduplicated), decode {:.2f} ms, upload {:.2f} ms",
+                     path.filename().string(),
+                     model.m_statistics.cookedModelHit ? "mapped from the cache" : "imported",
+                     model.m_statistics.totalTime.count(),
+                     model.m_statistics.shortIndexMeshCount,
+                     model.m_meshes.size(),
+                     model.m_statistics.savedIndexBytes / 1024,
+                     model.m_statistics.splitMeshCount,
+                     model.m_drawGroups.size(),
+                     model.m_statistics.textureCount,
+                     model.m_statistics.cookedTextureHits,
+                     model.m_statistics.deduplicatedTextureBytes / 1024,
+                     model.m_statistics.textureDecodeTime.count(),
+                     model.m_statistics.textureUploadTime.count());
         return model;
     }
 
     void Model::draw(const ShaderProgram& shaderProgram) const
     {
+        m_drawnTriangleCount = 0;
+        if (s_drawSubmission == DrawSubmission::Indirect)
+        {
+            for (const auto& group : m_drawGroups)
+            {
+                for (const auto index : group)
+                {
+                    m_drawCommands.push(m_meshes[index].drawCommand());
+                    m_drawnTriangleCount += m_meshes[index].lods().front().indexCount / 3;
+                }
+                m_meshes[group.front()].drawIndirect(shaderProgram, m_drawCommands);
+            }
+            glBindVertexArray(0);
+            return;
+        }
+
         std::ranges::for_each(m_meshes,
-                              [&shaderProgram](auto&& mesh)
+                              [this, &shaderProgram](auto&& mesh)
                               {
                                   mesh.draw(shaderProgram);
+                                  m_drawnTriangleCount += mesh.lods().front().indexCount / 3;
                               });
+        glBindVertexArray(0);
+    }
+
+    void Model::draw(const ShaderProgram& shaderProgram,
+                     const PerspectiveCamera& camera,
+                     const glm::mat4& modelMatrix,
+                     const float viewportHeight) const
+    {
+        const auto view{ drawView(camera, modelMatrix, viewportHeight) };
+        m_selectedLods.resize(m_meshes.size(), 0);
+        m_drawnTriangleCount = 0;
+        const auto indirect{ s_drawSubmission == DrawSubmission::Indirect };
+        const auto drawMesh{
+            [&](const std::size_t index)
+            {
+                if (!selectVisibleLod(index, view).has_value())
+                {
+                    return;
+                }
+                const auto& mesh{ m_meshes[index] };
+                const auto selectedLod{ m_selectedLods[index] };
+                // Coarser levels are small on screen; culling their few triangles is not worth it
+                if (selectedLod == 0)
+                {
+                    m_drawnTriangleCount += indirect
+                                            ? mesh.pushCulledDrawCommands(view.frustum,
+                                                                          view.cameraPosition,
+                                                                          m_drawCommands)
+                                            : mesh.drawCulled(shaderProgram, view.frustum, view.cameraPosition);
+                    return;
+                }
+                if (indirect)
+                {
+                    m_drawCommands.push(mesh.drawCommand(selectedLod));
+                }
+                else
+                {
+                    mesh.draw(shaderProgram, selectedLod);
+                }
+                m_drawnTriangleCount += mesh.lods()[selectedLod].indexCount / 3;
+            }
+        };
+
+        if (indirect)
+        {
+            for (const auto& group : m_drawGroups)
+            {
+                std::ranges::for_each(group, drawMesh);
+                m_meshes[group.front()].drawIndirect(shaderProgram, m_drawCommands);
+            }
+        }
+        else
+        {
+            for (std::size_t i{ 0 }; i < m_meshes.size(); ++i)
+            {
+                drawMesh(i);
+            }
+        }
+        glBindVertexArray(0);
+    }
+
+    void Model::enqueue(RenderQueue& queue,
+                        const ShaderProgram& shaderProgram,
+                        const PerspectiveCamera& camera,
+                        const glm::mat4& modelMatrix,
+                        const float viewportHeight) const
+    {
+        const auto view{ drawView(camera, modelMatrix, viewportHeight) };
+        const auto transform{ queue.pushTransform(modelMatrix) };
+        m_selectedLods.resize(m_meshes.size(), 0);
+        m_drawnTriangleCount = 0;
+        for (std::size_t i{ 0 }; i < m_meshes.size(); ++i)
+        {
+            const auto distance{ selectVisibleLod(i, view) };
+            if (!distance.has_value())
+            {
+                continue;
+            }
+            const auto& mesh{ m_meshes[i] };
+            const auto selectedLod{ m_selectedLods[i] };
+            // Like draw, only the full level is worth culling meshlet by meshlet
+            if (selectedLod == 0)
+            {
+                m_drawnTriangleCount += queue.submitCulled(RenderPass::Opaque,
+                                                           shaderProgram,
+                                                           mesh,
+                                                           view.frustum,
+                                                           view.cameraPosition,
+                                                           transform,
+                                                           *distance);
+                continue;
+            }
+            queue.submit(RenderPass::Opaque, shaderProgram, mesh, selectedLod, transform, *distance);
+            m_drawnTriangleCount += mesh.lods()[selectedLod].indexCount / 3;
+        }
+    }
+
+    Model::DrawView Model::drawView(const PerspectiveCamera& camera,
+                                    const glm::mat4& modelMatrix,
+                                    const float viewportHeight)
+    {
+        const auto scale{
+            std::max({
+                glm::length(glm::vec3{ modelMatrix[0] }),
+                glm::length(glm::vec3{ modelMatrix[1] }),
+                glm::length(glm::vec3{ modelMatrix[2] })
+            })
+        };
+        return {
+            // Culling happens in model space, which leaves the camera and frustum to transform
+            .frustum = Frustum::fromMatrix(camera.getProjectionMatrix() * camera.getViewMatrix() * modelMatrix),
+            .cameraPosition = glm::vec3{ glm::inverse(modelMatrix) * glm::vec4{ camera.getPosition(), 1.0f } },
+            .eye = camera.getPosition(),
+            .modelMatrix = modelMatrix,
+            .scale = scale,
+            .projectionScale = viewportHeight / (2.0f * glm::tan(glm::radians(camera.getFov()) * 0.5f)) * scale,
+            .nearPlane = camera.getNearPlane()
+        };
+    }
+
+    std::optional<float> Model::selectVisibleLod(const std::size_t index, const DrawView& view) const
+    {
+        const auto& mesh{ m_meshes[index] };
+        auto& selectedLod{ m_selectedLods[index] };
+        const auto& bounds{ mesh.bounds() };
+        const auto center{ glm::vec3{ view.modelMatrix * glm::vec4{ bounds.center, 1.0f } } };
+        // Distance to the nearest point of the bounding sphere, so nothing inside it is underestimated
+        const auto distance{ std::max(glm::distance(center, view.eye) - bounds.radius * view.scale, view.nearPlane) };
+
+        selectedLod = selectLod(mesh.lods(), selectedLod, view.projectionScale / distance);
+        if (!view.frustum.intersects(bounds))
+        {
+            return std::nullopt;
+        }
+        return distance;
+    }
+
+    void Model::drawInstanced(const ShaderProgram& shaderProgram, const std::span<const glm::mat4> modelMatrices) const
+    {
+        m_drawnTriangleCount = 0;
+        if (modelMatrices.empty())
+        {
+            return;
+        }
+
+        m_instanceTransforms.clear();
+        std::ranges::transform(modelMatrices, std::back_inserter(m_instanceTransforms), &InstanceTransform::from);
+        Mesh::instanceBuffer().upload(m_instanceTransforms);
+
+        for (const auto& mesh : m_meshes)
+        {
+            mesh.drawInstanced(shaderProgram, modelMatrices.size());
+            m_drawnTriangleCount += mesh.lods().front().indexCount / 3 * modelMatrices.size();
+        }
+        glBindVertexArray(0);
+    }
+
+    std::size_t Model::drawnTriangleCount() const noexcept
+    {
+        return m_drawnTriangleCount;
+    }
+
+    DrawSubmission Model::s_drawSubmission{ DrawSubmission::Direct };
+
+    void Model::setDrawSubmission(const DrawSubmission submission) noexcept
+    {
+        s_drawSubmission = submission;
+    }
+
+    DrawSubmission Model::drawSubmission() noexcept
+    {
+        return s_drawSubmission;
     }
 
     Model::Model(Model&& other) noexcept
         : m_meshes{ std::move(other.m_meshes) },
-          m_directory{ std::move(other.m_directory) }
+          m_nodes{ std::move(other.m_nodes) },
+          m_drawGroups{ std::move(other.m_drawGroups) },
+          m_directory{ std::move(other.m_directory) },
+          m_statistics{ other.m_statistics },
+          m_selectedLods{ std::move(other.m_selectedLods) },
+          m_drawnTriangleCount{ other.m_drawnTriangleCount },
+          m_instanceTransforms{ std::move(other.m_instanceTransforms) },
+          m_drawCommands{ std::move(other.m_drawCommands) }
     {
     }
 
@@ -62,7 +370,14 @@ namespace lgl
         if (this == &other)
             return *this;
         m_meshes = std::move(other.m_meshes);
+        m_nodes = std::move(other.m_nodes);
+        m_drawGroups = std::move(other.m_drawGroups);
         m_directory = std::move(other.m_directory);
+        m_statistics = other.m_statistics;
+        m_selectedLods = std::move(other.m_selectedLods);
+        m_drawnTriangleCount = other.m_drawnTriangleCount;
+        m_instanceTransforms = std::move(other.m_instanceTransforms);
+        m_drawCommands = std::move(other.m_drawCommands);
         return *this;
     }
 
@@ -71,21 +386,233 @@ namespace lgl
         return m_directory;
     }
 
+    std::span<const ModelNode> Model::nodes() const noexcept
+    {
+        return m_nodes;
+    }
+
+    const Model::LoadStatistics& Model::statistics() const noexcept
+    {
+        return m_statistics;
+    }
+
     Model::Model(std::filesystem::path directory)
         : m_directory{ std::move(directory) }
     {
     }
 
-    void Model::processNodes(const aiNode* node, const aiScene* scene) // NOLINT(*-no-recursion)
+    void Model::importScene(const std::filesystem::path& path)
+    {
+        Assimp::Importer importer{};
+        // The importer owns the IO system
+        const auto ioSystem{ new RecordingIOSystem{} };
+        importer.SetIOHandler(ioSystem);
+        const auto scene{
+            importer.ReadFile(std::filesystem::absolute(path).c_str(),
+                              aiProcess_Triangulate | aiProcess_FlipUVs)
+        };
+
+        if (scene == nullptr || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || scene->mRootNode == nullptr)
+        {
+            std::println(stderr, "[Assimp::Importer] {}", importer.GetErrorString());
+            throw std::runtime_error("Failed to load model");
+        }
+
+        loadTextures(collectTextures(scene));
+
+        // Meshes are processed in parallel and uploaded in node order on this thread
+        std::vector<const aiMesh*> sceneMeshes{};
+        processNodes(scene->mRootNode, scene, -1, sceneMeshes);
+        std::vector<std::vector<MeshData>> meshData(sceneMeshes.size());
+        ThreadPool::shared().parallelFor(sceneMeshes.size(), [&](const std::size_t i)
+        {
+            meshData[i] = Mesh::process(sceneMeshes[i], scene, m_directory);
+        });
+
+        // Meshes split for 16-bit indices take several slots; nodes refer to the slots
+        std::vector<uint32_t> firstMeshes{ 0 };
+        for (auto&& [sceneMesh, parts] : std::views::zip(sceneMeshes, meshData))
+        {
+            firstMeshes.push_back(firstMeshes.back() + static_cast<uint32_t>(parts.size()));
+            m_statistics.splitMeshCount += parts.size() > 1;
+            for (auto&& [index, part] : std::views::enumerate(parts))
+            {
+                // Reported here rather than by the workers, so the lines come out whole and in mesh order
+                if (const auto& optimization{ part.optimization })
+                {
+                    std::println("[Mesh] '{}'{}: {} -> {} vertices, ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}, "
+                                 "{} LODs down to {} triangles",
+                                 sceneMesh->mName.C_Str(),
+                                 parts.size() > 1 ? std::format(" part {} of {}", index + 1, parts.size()) : "",
+                                 optimization->vertexCountBefore,
+                                 optimization->vertexCountAfter,
+                                 optimization->before.acmr,
+                                 optimization->after.acmr,
+                                 optimization->before.atvr,
+                                 optimization->after.atvr,
+                                 part.lods.size(),
+                                 part.lods.back().indexCount / 3);
+                }
+                m_meshes.emplace_back(std::move(part));
+            }
+        }
+        for (auto& node : m_nodes)
+        {
+            const auto lastMesh{ firstMeshes[node.firstMesh + node.meshCount] };
+            node.firstMesh = firstMeshes[node.firstMesh];
+            node.meshCount = lastMesh - node.firstMesh;
+        }
+
+        const auto meshes{
+            m_meshes
+            | std::views::transform([](const Mesh& mesh) { return mesh.cookedMesh(); })
+            | std::ranges::to<std::vector>()
+        };
+        CookedModel::store(path, ioSystem->openedFiles(), m_nodes, meshes);
+    }
+
+    std::vector<TextureReference> Model::collectTextures(const aiScene* scene) const
+    {
+        std::vector<TextureReference> textures{};
+        for (std::size_t i{ 0 }; i < scene->mNumMaterials; ++i)
+        {
+            textures.append_range(Mesh::materialTextures(scene->mMaterials[i], m_directory));
+        }
+        return textures;
+    }
+
+    void Model::loadTextures(const std::span<const TextureReference> textures)
+    {
+        // Only textures that are not resident yet are decoded, each path once per type it is processed as
+        std::vector<TextureReference> pending{};
+        for (const auto& texture : textures)
+        {
+            if (!Mesh::isTextureCached(texture) && !std::ranges::contains(pending, texture))
+            {
+                pending.push_back(texture);
+            }
+        }
+
+        using Clock = std::chrono::steady_clock;
+        struct DecodedTexture
+        {
+            std::size_t index;
+            std::expected<CookedTexture, std::exception_ptr> texture;
+            Clock::time_point finishTime;
+        };
+
+        const auto startTime{ Clock::now() };
+        ConcurrentQueue<DecodedTexture> decoded{};
+        for (std::size_t i{ 0 }; i < pending.size(); ++i)
+        {
+            // Results are delivered through the queue, so the futures are not needed
+            std::ignore = ThreadPool::shared().submit([i, &pending, &decoded]
+            {
+                auto texture{
+                    [&reference = pending[i]]() -> std::expected<CookedTexture, std::exception_ptr>
+                    {
+                        try
+                        {
+                            return Mesh::decodeTexture(reference.path, reference.type);
+                        }
+                        catch (...)
+                        {
+                            return std::unexpected{ std::current_exception() };
+                        }
+                    }()
+                };
+                decoded.push({ i, std::move(texture), Clock::now() });
+            });
+        }
+
+        // Upload in completion order; keep draining after a failure so no worker outlives the queue
+        std::exception_ptr failure{};
+        std::size_t cookedTextureHits{ 0 };
+        auto lastDecodeTime{ startTime };
+        Clock::duration uploadTime{};
+        for (std::size_t i{ 0 }; i < pending.size(); ++i)
+        {
+            const auto [index, texture, finishTime]{ decoded.pop() };
+            lastDecodeTime = std::max(lastDecodeTime, finishTime);
+            if (failure != nullptr)
+            {
+                continue;
+            }
+            if (!texture.has_value())
+            {
+                std::println(stderr, "Failed to decode texture '{}'", pending[index].path.string());
+                failure = texture.error();
+                continue;
+            }
+            if (texture->isMapped())
+            {
+                ++cookedTextureHits;
+            }
+
+            const auto uploadStart{ Clock::now() };
+            try
+            {
+                Mesh::uploadTexture(pending[index], *texture);
+            }
+            catch (...)
+            {
+                failure = std::current_exception();
+            }
+            uploadTime += Clock::now() - uploadStart;
+        }
+
+        if (failure != nullptr)
+        {
+            std::rethrow_exception(failure);
+        }
+
+        m_statistics.textureCount = pending.size();
+        m_statistics.cookedTextureHits = cookedTextureHits;
+        m_statistics.textureDecodeTime = lastDecodeTime - startTime;
+        m_statistics.textureUploadTime = uploadTime;
+    }
+
+    void Model::groupMeshes()
+    {
+        m_drawGroups.clear();
+        for (std::size_t i{ 0 }; i < m_meshes.size(); ++i)
+        {
+            const auto group{
+                std::ranges::find_if(m_drawGroups,
+                                     [&](const std::vector<std::size_t>& indices)
+                                     {
+                                         return m_meshes[indices.front()].sharesDrawState(m_meshes[i]);
+                                     })
+            };
+            if (group != m_drawGroups.end())
+            {
+                group->push_back(i);
+            }
+            else
+            {
+                m_drawGroups.push_back({ i });
+            }
+        }
+    }
+
+    void Model::processNodes(const aiNode* node, // NOLINT(*-no-recursion)
+                             const aiScene* scene,
+                             const int32_t parent,
+                             std::vector<const aiMesh*>& meshes)
     {
+        const auto index{ static_cast<int32_t>(m_nodes.size()) };
+        m_nodes.push_back({
+            .parent = parent,
+            .firstMesh = static_cast<uint32_t>(meshes.size()),
+            .meshCount = node->mNumMeshes
+        });
         for (std::size_t i{ 0 }; i < node->mNumMeshes; ++i)
         {
-            const auto mesh{ scene->mMeshes[node->mMeshes[i]] };
-            m_meshes.emplace_back(*this, mesh, scene);
+            meshes.push_back(scene->mMeshes[node->mMeshes[i]]);
         }
         for (std::size_t i{ 0 }; i < node->mNumChildren; ++i)
         {
-            processNodes(node->mChildren[i], scene);
+            processNodes(node->mChildren[i], scene, index, meshes);
         }
     }
 } // lgl
@@ -0,0 +1,251 @@
+//
+// Created by user on 10/17/26.
+//
+
+#include "app/RenderQueue.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <utility>
+#include <glm/matrix.hpp>
+#include "app/Mesh.h"
+#include "app/ShaderProgram.h"
+
+namespace
+{
+    constexpr uint64_t field(const uint64_t value, const unsigned bits) noexcept
+    {
+        return value & ((uint64_t{ 1 } << bits) - 1);
+    }
+}
+
+namespace lgl
+{
+    using namespace literals;
+
+    uint64_t renderKey(const RenderPass pass,
+                       const uint32_t program,
+                       const uint32_t material,
+                       const uint32_t vertexArray,
+                       const float depth) noexcept
+    {
+        // Non-negative floats order like their bits; the sign is always clear, the next 20 bits remain
+        const uint64_t depthBits{ std::bit_cast<uint32_t>(std::max(depth, 0.0f)) >> 11 };
+        const auto passBits{ field(static_cast<uint64_t>(pass), 4) << 60 };
+        if (pass == RenderPass::Transparent)
+        {
+            return passBits
+                   | field(~depthBits, 20) << 40
+                   | field(program, 12) << 28
+                   | field(material, 16) << 12
+                   | field(vertexArray, 12);
+        }
+        return passBits
+               | field(program, 12) << 48
+               | field(material, 16) << 32
+               | field(vertexArray, 12) << 20
+               | field(depthBits, 20);
+    }
+
+    void radixSort(std::vector<SortEntry>& entries, std::vector<SortEntry>& scratch)
+    {
+        scratch.resize(entries.size());
+        for (unsigned shift{ 0 }; shift < 64; shift += 8)
+        {
+            std::array<std::size_t, 256> offsets{};
+            for (const auto& entry : entries)
+            {
+                ++offsets[entry.key >> shift & 0xFF];
+            }
+            if (std::ranges::contains(offsets, entries.size()))
+            {
+                continue;
+            }
+
+            std::size_t offset{ 0 };
+            for (auto& count : offsets)
+            {
+                offset += std::exchange(count, offset);
+            }
+            for (const auto& entry : entries)
+            {
+                scratch[offsets[entry.key >> shift & 0xFF]++] = entry;
+            }
+            entries.swap(scratch);
+        }
+    }
+
+    uint32_t RenderQueue::pushTransform(const glm::mat4& modelMatrix)
+    {
+        m_transforms.push_back(modelMatrix);
+        return static_cast<uint32_t>(m_transforms.size() - 1);
+    }
+
+    void RenderQueue::submit(const RenderPass pass,
+                             const ShaderProgram& shaderProgram,
+                             const Mesh& mesh,
+                             const std::size_t lod,
+                             const uint32_t transform,
+                             const float depth)
+    {
+        const auto firstCommand{ m_commands.commands().size() };
+        m_commands.push(mesh.drawCommand(lod));
+        addSubmission(pass, shaderProgram, mesh, firstCommand, transform, depth);
+    }
+
+    std::size_t RenderQueue::submitCulled(const RenderPass pass,
+                                          const ShaderProgram& shaderProgram,
+                                          const Mesh& mesh,
+                                          const Frustum& frustum,
+                                          const glm::vec3& cameraPosition,
+                                          const uint32_t transform,
+                                          const float depth)
+    {
+        const auto firstCommand{ m_commands.commands().size() };
+        const auto triangleCount{ mesh.pushCulledDrawCommands(frustum, cameraPosition, m_commands) };
+        addSubmission(pass, shaderProgram, mesh, firstCommand, transform, depth);
+        return triangleCount;
+    }
+
+    void RenderQueue::flush()
+    {
+        const auto unsorted{ countStateChanges(m_order) };
+        radixSort(m_order, m_scratch);
+        const auto sorted{ countStateChanges(m_order) };
+
+        const Submission* previous{ nullptr };
+        std::size_t indirectSubmissions{ 0 };
+        for (const auto& entry : m_order)
+        {
+            const auto& submission{ m_submissions[entry.index] };
+            // Submissions needing no state change are drawn with the previous ones
+            const auto continuesBatch{
+                previous != nullptr && previous->program == submission.program
+                && previous->transform == submission.transform && previous->mesh->sharesDrawState(*submission.mesh)
+            };
+            if (!continuesBatch)
+            {
+                if (previous != nullptr)
+                {
+                    m_batch.submit(previous->mesh->indexType());
+                    ++indirectSubmissions;
+                }
+                bind(submission, previous);
+            }
+            for (const auto& command : m_commands.commands().subspan(submission.firstCommand, submission.commandCount))
+            {
+                m_batch.push(command);
+            }
+            previous = &submission;
+        }
+        if (previous != nullptr)
+        {
+            m_batch.submit(previous->mesh->indexType());
+            ++indirectSubmissions;
+        }
+        glBindVertexArray(0);
+
+        // The submission order may keep a vertex array bound across materials, where sorting switches it more often
+        const auto avoided{
+            [](const std::size_t before, const std::size_t after)
+            {
+                return before > after ? before - after : 0;
+            }
+        };
+        m_statistics = {
+            .submissionCount = m_submissions.size(),
+            .commandCount = m_commands.commands().size(),
+            .indirectSubmissions = indirectSubmissions,
+            .programChanges = sorted.program,
+            .materialChanges = sorted.material,
+            .vertexArrayChanges = sorted.vertexArray,
+            .programChangesAvoided = avoided(unsorted.program, sorted.program),
+            .materialChangesAvoided = avoided(unsorted.material, sorted.material),
+            .vertexArrayChangesAvoided = avoided(unsorted.vertexArray, sorted.vertexArray)
+        };
+
+        m_submissions.clear();
+        m_commands.clear();
+        m_transforms.clear();
+        m_order.clear();
+    }
+
+    const RenderQueue::Statistics& RenderQueue::statistics() const noexcept
+    {
+        return m_statistics;
+    }
+
+    RenderQueue::StateChanges RenderQueue::countStateChanges(const std::span<const SortEntry> order) const
+    {
+        StateChanges changes{};
+        const Submission* previous{ nullptr };
+        for (const auto& entry : order)
+        {
+            const auto& submission{ m_submissions[entry.index] };
+            // A new program needs its material uniforms set again
+            const auto programChanged{ previous == nullptr || previous->program != submission.program };
+            changes.program += programChanged;
+            changes.material += programChanged || previous->mesh->materialId() != submission.mesh->materialId();
+            changes.vertexArray += previous == nullptr
+                                   || previous->mesh->vertexArray() != submission.mesh->vertexArray();
+            previous = &submission;
+        }
+        return changes;
+    }
+
+    void RenderQueue::addSubmission(const RenderPass pass,
+                                    const ShaderProgram& shaderProgram,
+                                    const Mesh& mesh,
+                                    const std::size_t firstCommand,
+                                    const uint32_t transform,
+                                    const float depth)
+    {
+        // Meshes culled entirely push no commands and need no state
+        const auto commandCount{ m_commands.commands().size() - firstCommand };
+        if (commandCount == 0)
+        {
+            return;
+        }
+        m_order.push_back({
+            .key = renderKey(pass, shaderProgram.getId(), mesh.materialId(), mesh.vertexArray(), depth),
+            .index = static_cast<uint32_t>(m_submissions.size())
+        });
+        m_submissions.push_back({
+            .program = &shaderProgram,
+            .mesh = &mesh,
+            .firstCommand = static_cast<uint32_t>(firstCommand),
+            .commandCount = static_cast<uint32_t>(commandCount),
+            .transform = transform
+        });
+    }
+
+    void RenderQueue::bind(const Submission& submission, const Submission* previous) const
+    {
+        const auto& shaderProgram{ *submission.program };
+        const auto& mesh{ *submission.mesh };
+        const auto programChanged{ previous == nullptr || previous->program != submission.program };
+        if (programChanged)
+        {
+            shaderProgram.use();
+        }
+        if (programChanged || previous->transform != submission.transform)
+        {
+            const auto& modelMatrix{ m_transforms[submission.transform] };
+            shaderProgram.setUniform("model"_u, modelMatrix);
+            shaderProgram.setUniform("normalMatrix"_u, glm::transpose(glm::inverse(glm::mat3{ modelMatrix })));
+        }
+        if (programChanged || previous->mesh->materialId() != mesh.materialId())
+        {
+            mesh.bindTextures(shaderProgram);
+        }
+        if (programChanged || previous->mesh != submission.mesh)
+        {
+            mesh.setGeometryUniforms(shaderProgram);
+        }
+        if (previous == nullptr || previous->mesh->vertexArray() != mesh.vertexArray())
+        {
+            glBindVertexArray(mesh.vertexArray());
+        }
+    }
+} // lgl
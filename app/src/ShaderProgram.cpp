@@ -4,6 +4,9 @@
 
 #include "app/ShaderProgram.h"
 
+#include <algorithm>
+#include <charconv>
+#include <format>
 #include <fstream>
 #include <print>
 #include <glm/gtc/type_ptr.hpp>
@@ -30,6 +33,12 @@ namespace lgl
     ShaderProgram::ShaderProgram(const GLuint program)
         : m_programId{ program }
     {
+        GLint linked{ GL_FALSE };
+        glGetProgramiv(m_programId, GL_LINK_STATUS, &linked);
+        if (linked == GL_TRUE)
+        {
+            reflectUniforms();
+        }
     }
 
     ShaderProgram::ShaderProgram()
@@ -55,7 +64,14 @@ namespace lgl
 
     GLint ShaderProgram::getUniformLocation(const std::string_view name) const
     {
-        return glGetUniformLocation(m_programId, name.data());
+        const auto uniform{ m_uniforms.find(name) };
+        return uniform != m_uniforms.end() ? uniform->second.location : -1;
+    }
+
+    GLint ShaderProgram::getUniformLocation(const UniformId id) const
+    {
+        const auto uniform{ m_uniformIds.find(id.hash) };
+        return uniform != m_uniformIds.end() ? uniform->second : -1;
     }
 
     void ShaderProgram::use() const
@@ -312,9 +328,96 @@ namespace lgl
         glLinkProgram(m_programId);
     }
 
-    void ShaderProgram::linkAndValidate() const
+    void ShaderProgram::linkAndValidate()
     {
         link();
         validate();
+        reflectUniforms();
+    }
+
+    void ShaderProgram::reflectUniforms()
+    {
+        m_uniforms.clear();
+        GLint count{ 0 };
+        glGetProgramiv(m_programId, GL_ACTIVE_UNIFORMS, &count);
+        GLint maxLength{ 0 };
+        glGetProgramiv(m_programId, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+        std::string buffer(static_cast<std::size_t>(std::max(maxLength, 1)), '\0');
+        for (GLint i{ 0 }; i < count; ++i)
+        {
+            GLsizei length{ 0 };
+            GLint size{ 0 };
+            GLenum type{ 0 };
+            glGetActiveUniform(m_programId,
+                               static_cast<GLuint>(i),
+                               static_cast<GLsizei>(buffer.size()),
+                               &length,
+                               &size,
+                               &type,
+                               buffer.data());
+            // Members of uniform blocks have no location
+            const auto location{ glGetUniformLocation(m_programId, buffer.c_str()) };
+            if (location == -1)
+            {
+                continue;
+            }
+            const std::string_view name{ buffer.data(), static_cast<std::size_t>(length) };
+            m_uniforms.try_emplace(std::string{ name }, UniformInfo{ .location = location, .type = type });
+
+            // Arrays are reported once, by their first element
+            if (!name.ends_with("[0]"))
+            {
+                continue;
+            }
+            const auto arrayName{ name.substr(0, name.size() - 3) };
+            m_uniforms.try_emplace(std::string{ arrayName }, UniformInfo{ .location = location, .type = type });
+            for (GLint element{ 1 }; element < size; ++element)
+            {
+                auto elementName{ std::format("{}[{}]", arrayName, element) };
+                const auto elementLocation{ glGetUniformLocation(m_programId, elementName.c_str()) };
+                m_uniforms.try_emplace(std::move(elementName),
+                                       UniformInfo{ .location = elementLocation, .type = type });
+            }
+        }
+
+        m_uniformIds.clear();
+        for (const auto& [name, uniform] : m_uniforms)
+        {
+            addUniformId(name, uniform.location);
+        }
+    }
+
+    void ShaderProgram::addUniformId(const std::string_view name, const GLint location)
+    {
+        const auto insert{
+            [&](const UniformId id)
+            {
+                if (const auto [entry, inserted]{ m_uniformIds.try_emplace(id.hash, location) };
+                    !inserted && entry->second != location)
+                {
+                    std::println(stderr, "Uniform '{}' collides with another uniform's id", name);
+                    throw std::runtime_error("Uniform id collision");
+                }
+            }
+        };
+        insert(UniformId::of(name));
+
+        // pointLights[2].position is also pointLights[].position indexed by 2
+        const auto open{ name.find('[') };
+        const auto close{ name.find(']', open) };
+        if (open == std::string_view::npos || close == std::string_view::npos
+            || name.find('[', close) != std::string_view::npos)
+        {
+            return;
+        }
+        std::size_t index{ 0 };
+        if (const auto [end, error]{ std::from_chars(name.data() + open + 1, name.data() + close, index) };
+            error != std::errc{} || end != name.data() + close)
+        {
+            return;
+        }
+        const auto unindexed{ std::format("{}{}", name.substr(0, open + 1), name.substr(close)) };
+        insert(UniformId::of(unindexed)[index]);
     }
 } // lgl
@@ -0,0 +1,164 @@
+//
+// Created by user on 10/17/26.
+//
+
+#include "app/TextureCache.h"
+
+#include <algorithm>
+#include <iterator>
+#include <ranges>
+
+namespace lgl
+{
+    std::optional<TextureCache::handle_type> TextureCache::acquire(const TextureReference& texture)
+    {
+        auto* entry{ find(texture) };
+        if (entry == nullptr)
+        {
+            return std::nullopt;
+        }
+        if (entry->references++ == 0)
+        {
+            m_unreferenced.erase(entry->unreferencedPosition);
+        }
+        return entry->handle;
+    }
+
+    bool TextureCache::alias(const TextureReference& texture, const uint64_t contentKey)
+    {
+        const auto entry{ m_entries.find(contentKey) };
+        if (entry == m_entries.end())
+        {
+            return false;
+        }
+        if (m_contentKeys.emplace(texture, contentKey).second)
+        {
+            entry->second.aliases.push_back(texture);
+            m_savedBytes += entry->second.size;
+        }
+        return true;
+    }
+
+    void TextureCache::insert(const TextureReference& texture,
+                              const uint64_t contentKey,
+                              const handle_type handle,
+                              const std::size_t size)
+    {
+        if (auto* existing{ find(texture) }; existing != nullptr)
+        {
+            // Uploaded again while still resident; keep the references, replace the texture
+            glDeleteTextures(1, &existing->handle);
+            m_usage -= existing->size;
+            existing->handle = handle;
+            existing->size = size;
+        }
+        else if (alias(texture, contentKey))
+        {
+            // Same content uploaded under a new path or type; keep the resident copy
+            glDeleteTextures(1, &handle);
+            return;
+        }
+        else
+        {
+            m_unreferenced.push_back(contentKey);
+            m_entries.emplace(contentKey, Entry{
+                                  .handle = handle,
+                                  .size = size,
+                                  .references = 0,
+                                  .aliases = { texture },
+                                  .unreferencedPosition = std::prev(m_unreferenced.end())
+                              });
+            m_contentKeys.emplace(texture, contentKey);
+        }
+        m_usage += size;
+        m_peakUsage = std::max(m_peakUsage, m_usage);
+    }
+
+    void TextureCache::release(const TextureReference& texture)
+    {
+        auto* entry{ find(texture) };
+        if (entry == nullptr || entry->references == 0)
+        {
+            return;
+        }
+        if (--entry->references == 0)
+        {
+            entry->unreferencedPosition = m_unreferenced.insert(m_unreferenced.end(), m_contentKeys.at(texture));
+            trim();
+        }
+    }
+
+    bool TextureCache::contains(const TextureReference& texture) const
+    {
+        return m_contentKeys.contains(texture);
+    }
+
+    void TextureCache::trim()
+    {
+        while (m_usage > m_budget && !m_unreferenced.empty())
+        {
+            const auto entry{ m_entries.find(m_unreferenced.front()) };
+            glDeleteTextures(1, &entry->second.handle);
+            m_usage -= entry->second.size;
+            for (const auto& alias : entry->second.aliases)
+            {
+                m_contentKeys.erase(alias);
+            }
+            m_entries.erase(entry);
+            m_unreferenced.pop_front();
+        }
+    }
+
+    void TextureCache::clear()
+    {
+        for (auto& entry : m_entries | std::views::values)
+        {
+            glDeleteTextures(1, &entry.handle);
+        }
+        m_entries.clear();
+        m_contentKeys.clear();
+        m_unreferenced.clear();
+        m_usage = 0;
+    }
+
+    void TextureCache::setBudget(const std::size_t bytes)
+    {
+        m_budget = bytes;
+        trim();
+    }
+
+    std::size_t TextureCache::budget() const noexcept
+    {
+        return m_budget;
+    }
+
+    std::size_t TextureCache::usage() const noexcept
+    {
+        return m_usage;
+    }
+
+    std::size_t TextureCache::peakUsage() const noexcept
+    {
+        return m_peakUsage;
+    }
+
+    std::size_t TextureCache::residentCount() const noexcept
+    {
+        return m_entries.size();
+    }
+
+    std::size_t TextureCache::savedBytes() const noexcept
+    {
+        return m_savedBytes;
+    }
+
+    TextureCache::Entry* TextureCache::find(const TextureReference& texture)
+    {
+        const auto contentKey{ m_contentKeys.find(texture) };
+        if (contentKey == m_contentKeys.end())
+        {
+            return nullptr;
+        }
+        return &m_entries.at(contentKey->second);
+    }
+} // lgl
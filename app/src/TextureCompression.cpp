@@ -0,0 +1,1071 @@
+//
+// Created by user on 10/17/26.
+//
+
+#include "app/TextureCompression.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <format>
+#include <limits>
+#include <utility>
+#include "app/ThreadPool.h"
+
+namespace
+{
+    using Texel = std::array<uint8_t, 4>;
+    using Block = std::array<Texel, 16>;
+    using Palette4 = std::array<std::array<int, 4>, 16>;
+
+    constexpr std::array BC7_WEIGHTS{ 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    // Reads a 4x4 block, clamping at the image edge, as OpenGL would sample the uncompressed format
+    Block fetchBlock(const lgl::ImageData& image, const uint32_t blockX, const uint32_t blockY) noexcept
+    {
+        Block block{};
+        const auto* data{ reinterpret_cast<const uint8_t*>(image.data.data()) };
+        for (uint32_t y{ 0 }; y < 4; ++y)
+        {
+            const auto sourceY{ std::min(blockY * 4 + y, image.height - 1) };
+            for (uint32_t x{ 0 }; x < 4; ++x)
+            {
+                const auto sourceX{ std::min(blockX * 4 + x, image.width - 1) };
+                const auto* texel{ data + (static_cast<std::size_t>(sourceY) * image.width + sourceX) * image.channels };
+                auto& target{ block[y * 4 + x] };
+                target = { texel[0], 0, 0, 255 };
+                for (uint8_t c{ 1 }; c < image.channels; ++c)
+                {
+                    target[c] = texel[c];
+                }
+            }
+        }
+        return block;
+    }
+
+    void storeBlock(lgl::ImageData& image, const uint32_t blockX, const uint32_t blockY, const Block& block) noexcept
+    {
+        auto* data{ reinterpret_cast<uint8_t*>(image.data.data()) };
+        for (uint32_t y{ 0 }; y < 4 && blockY * 4 + y < image.height; ++y)
+        {
+            for (uint32_t x{ 0 }; x < 4 && blockX * 4 + x < image.width; ++x)
+            {
+                auto* texel{
+                    data + (static_cast<std::size_t>(blockY * 4 + y) * image.width + blockX * 4 + x) * image.channels
+                };
+                for (uint8_t c{ 0 }; c < image.channels; ++c)
+                {
+                    texel[c] = block[y * 4 + x][c];
+                }
+            }
+        }
+    }
+
+    template<typename T>
+    void storeLittleEndian(std::byte* destination, T value) noexcept
+    {
+        for (std::size_t i{ 0 }; i < sizeof(T); ++i)
+        {
+            destination[i] = static_cast<std::byte>(value >> (8 * i) & 0xFF);
+        }
+    }
+
+    template<typename T>
+    T loadLittleEndian(const std::byte* source) noexcept
+    {
+        T value{ 0 };
+        for (std::size_t i{ 0 }; i < sizeof(T); ++i)
+        {
+            value |= static_cast<T>(static_cast<uint8_t>(source[i])) << (8 * i);
+        }
+        return value;
+    }
+
+    // Principal axis of the block in the first Channels channels, through the block mean
+    template<std::size_t Channels>
+    std::pair<std::array<float, Channels>, std::array<float, Channels>> principalExtent(const Block& block)
+    {
+        std::array<float, Channels> mean{};
+        for (const auto& texel : block)
+        {
+            for (std::size_t c{ 0 }; c < Channels; ++c)
+            {
+                mean[c] += texel[c] / 16.0f;
+            }
+        }
+
+        std::array<std::array<float, Channels>, Channels> covariance{};
+        for (const auto& texel : block)
+        {
+            for (std::size_t i{ 0 }; i < Channels; ++i)
+            {
+                for (std::size_t j{ 0 }; j < Channels; ++j)
+                {
+                    covariance[i][j] += (texel[i] - mean[i]) * (texel[j] - mean[j]);
+                }
+            }
+        }
+
+        // Power iteration converges quickly for the dominant eigenvector of a 3x3 or 4x4 matrix
+        std::array<float, Channels> axis{};
+        axis.fill(1.0f);
+        for (int iteration{ 0 }; iteration < 8; ++iteration)
+        {
+            std::array<float, Channels> next{};
+            for (std::size_t i{ 0 }; i < Channels; ++i)
+            {
+                for (std::size_t j{ 0 }; j < Channels; ++j)
+                {
+                    next[i] += covariance[i][j] * axis[j];
+                }
+            }
+            auto length{ 0.0f };
+            for (const auto value : next)
+            {
+                length = std::max(length, std::abs(value));
+            }
+            if (length < 1e-6f)
+            {
+                break;
+            }
+            for (std::size_t i{ 0 }; i < Channels; ++i)
+            {
+                axis[i] = next[i] / length;
+            }
+        }
+
+        auto axisLengthSquared{ 0.0f };
+        for (const auto value : axis)
+        {
+            axisLengthSquared += value * value;
+        }
+
+        auto minimum{ std::numeric_limits<float>::max() };
+        auto maximum{ std::numeric_limits<float>::lowest() };
+        for (const auto& texel : block)
+        {
+            auto projection{ 0.0f };
+            for (std::size_t c{ 0 }; c < Channels; ++c)
+            {
+                projection += (texel[c] - mean[c]) * axis[c];
+            }
+            minimum = std::min(minimum, projection / axisLengthSquared);
+            maximum = std::max(maximum, projection / axisLengthSquared);
+        }
+
+        std::pair<std::array<float, Channels>, std::array<float, Channels>> extent{};
+        for (std::size_t c{ 0 }; c < Channels; ++c)
+        {
+            extent.first[c] = std::clamp(mean[c] + axis[c] * maximum, 0.0f, 255.0f);
+            extent.second[c] = std::clamp(mean[c] + axis[c] * minimum, 0.0f, 255.0f);
+        }
+        return extent;
+    }
+
+    // Least-squares endpoints for fixed interpolation weights; false when the weights are degenerate
+    template<std::size_t Channels>
+    bool refitEndpoints(const Block& block,
+                        const std::array<float, 16>& weights,
+                        std::array<float, Channels>& endpoint0,
+                        std::array<float, Channels>& endpoint1)
+    {
+        auto aa{ 0.0f };
+        auto ab{ 0.0f };
+        auto bb{ 0.0f };
+        std::array<float, Channels> ax{};
+        std::array<float, Channels> bx{};
+        for (std::size_t i{ 0 }; i < block.size(); ++i)
+        {
+            const auto b{ weights[i] };
+            const auto a{ 1.0f - b };
+            aa += a * a;
+            ab += a * b;
+            bb += b * b;
+            for (std::size_t c{ 0 }; c < Channels; ++c)
+            {
+                ax[c] += a * block[i][c];
+                bx[c] += b * block[i][c];
+            }
+        }
+        const auto determinant{ aa * bb - ab * ab };
+        if (std::abs(determinant) < 1e-6f)
+        {
+            return false;
+        }
+        for (std::size_t c{ 0 }; c < Channels; ++c)
+        {
+            endpoint0[c] = std::clamp((bb * ax[c] - ab * bx[c]) / determinant, 0.0f, 255.0f);
+            endpoint1[c] = std::clamp((aa * bx[c] - ab * ax[c]) / determinant, 0.0f, 255.0f);
+        }
+        return true;
+    }
+
+    // Picks the nearest palette entry for every texel, returning the total squared error
+    template<std::size_t Channels, std::size_t Entries>
+    int assignIndices(const Block& block,
+                      const std::array<std::array<int, 4>, Entries>& palette,
+                      const std::size_t paletteSize,
+                      std::array<uint8_t, 16>& indices) noexcept
+    {
+        auto totalError{ 0 };
+        for (std::size_t i{ 0 }; i < block.size(); ++i)
+        {
+            auto bestError{ std::numeric_limits<int>::max() };
+            for (std::size_t entry{ 0 }; entry < paletteSize; ++entry)
+            {
+                auto error{ 0 };
+                for (std::size_t c{ 0 }; c < Channels; ++c)
+                {
+                    const auto difference{ block[i][c] - palette[entry][c] };
+                    error += difference * difference;
+                }
+                if (error < bestError)
+                {
+                    bestError = error;
+                    indices[i] = static_cast<uint8_t>(entry);
+                }
+            }
+            totalError += bestError;
+        }
+        return totalError;
+    }
+
+    // BC1 color block -------------------------------------------------------------------------------------------
+
+    uint16_t packRgb565(const std::array<float, 3>& color) noexcept
+    {
+        const auto r{ static_cast<uint16_t>(std::lround(color[0] * 31.0f / 255.0f)) };
+        const auto g{ static_cast<uint16_t>(std::lround(color[1] * 63.0f / 255.0f)) };
+        const auto b{ static_cast<uint16_t>(std::lround(color[2] * 31.0f / 255.0f)) };
+        return static_cast<uint16_t>(r << 11 | g << 5 | b);
+    }
+
+    std::array<int, 4> unpackRgb565(const uint16_t color) noexcept
+    {
+        const auto r{ color >> 11 & 0x1F };
+        const auto g{ color >> 5 & 0x3F };
+        const auto b{ color & 0x1F };
+        return { r << 3 | r >> 2, g << 2 | g >> 4, b << 3 | b >> 2, 255 };
+    }
+
+    // Only BC1 switches to three colors and transparent black when color0 <= color1; BC3 always interpolates four
+    std::array<std::array<int, 4>, 4> colorPalette(const uint16_t color0,
+                                                   const uint16_t color1,
+                                                   const bool allowThreeColor) noexcept
+    {
+        const auto c0{ unpackRgb565(color0) };
+        const auto c1{ unpackRgb565(color1) };
+        const auto fourColor{ color0 > color1 || !allowThreeColor };
+        std::array<std::array<int, 4>, 4> palette{ c0, c1, {}, {} };
+        for (std::size_t c{ 0 }; c < 3; ++c)
+        {
+            if (fourColor)
+            {
+                palette[2][c] = (2 * c0[c] + c1[c] + 1) / 3;
+                palette[3][c] = (c0[c] + 2 * c1[c] + 1) / 3;
+            }
+            else
+            {
+                palette[2][c] = (c0[c] + c1[c]) / 2;
+                palette[3][c] = 0;
+            }
+        }
+        palette[2][3] = 255;
+        palette[3][3] = fourColor ? 255 : 0;
+        return palette;
+    }
+
+    struct ColorCandidate
+    {
+        uint16_t color0{ 0 };
+        uint16_t color1{ 0 };
+        std::array<uint8_t, 16> indices{};
+        int error{ std::numeric_limits<int>::max() };
+    };
+
+    // Always produces a four-color block (color0 > color1), as BC3 requires
+    ColorCandidate evaluateColorEndpoints(const Block& block,
+                                          const std::array<float, 3>& endpoint0,
+                                          const std::array<float, 3>& endpoint1) noexcept
+    {
+        ColorCandidate candidate{ .color0 = packRgb565(endpoint0), .color1 = packRgb565(endpoint1) };
+        if (candidate.color0 < candidate.color1)
+        {
+            std::swap(candidate.color0, candidate.color1);
+        }
+        if (candidate.color0 == candidate.color1)
+        {
+            // Index 0 is the only entry guaranteed to be the endpoint color
+            const auto palette{ colorPalette(candidate.color0, candidate.color1, false) };
+            candidate.indices.fill(0);
+            candidate.error = 0;
+            for (const auto& texel : block)
+            {
+                for (std::size_t c{ 0 }; c < 3; ++c)
+                {
+                    candidate.error += (texel[c] - palette[0][c]) * (texel[c] - palette[0][c]);
+                }
+            }
+            return candidate;
+        }
+        candidate.error = assignIndices<3>(block, colorPalette(candidate.color0, candidate.color1, false), 4,
+                                           candidate.indices);
+        return candidate;
+    }
+
+    void encodeColorBlock(const Block& block, std::byte* destination) noexcept
+    {
+        auto [endpoint0, endpoint1]{ principalExtent<3>(block) };
+        auto best{ evaluateColorEndpoints(block, endpoint0, endpoint1) };
+
+        // Palette entries 0..3 lie at 0, 1, 1/3 and 2/3 of the way from color0 to color1
+        constexpr std::array INDEX_WEIGHTS{ 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+        std::array<float, 16> weights{};
+        for (std::size_t i{ 0 }; i < weights.size(); ++i)
+        {
+            weights[i] = INDEX_WEIGHTS[best.indices[i]];
+        }
+        const auto palette{ colorPalette(best.color0, best.color1, false) };
+        endpoint0 = { static_cast<float>(palette[0][0]), static_cast<float>(palette[0][1]),
+                      static_cast<float>(palette[0][2]) };
+        endpoint1 = { static_cast<float>(palette[1][0]), static_cast<float>(palette[1][1]),
+                      static_cast<float>(palette[1][2]) };
+        if (refitEndpoints<3>(block, weights, endpoint0, endpoint1))
+        {
+            if (const auto refined{ evaluateColorEndpoints(block, endpoint0, endpoint1) }; refined.error < best.error)
+            {
+                best = refined;
+            }
+        }
+
+        uint32_t indexBits{ 0 };
+        for (std::size_t i{ 0 }; i < best.indices.size(); ++i)
+        {
+            indexBits |= static_cast<uint32_t>(best.indices[i]) << (2 * i);
+        }
+        storeLittleEndian(destination, best.color0);
+        storeLittleEndian(destination + 2, best.color1);
+        storeLittleEndian(destination + 4, indexBits);
+    }
+
+    void decodeColorBlock(const std::byte* source, const bool allowThreeColor, Block& block) noexcept
+    {
+        const auto palette{
+            colorPalette(loadLittleEndian<uint16_t>(source), loadLittleEndian<uint16_t>(source + 2), allowThreeColor)
+        };
+        const auto indexBits{ loadLittleEndian<uint32_t>(source + 4) };
+        for (std::size_t i{ 0 }; i < block.size(); ++i)
+        {
+            const auto& entry{ palette[indexBits >> (2 * i) & 0x3] };
+            for (std::size_t c{ 0 }; c < 3; ++c)
+            {
+                block[i][c] = static_cast<uint8_t>(entry[c]);
+            }
+        }
+    }
+
+    // BC4 single-channel block ----------------------------------------------------------------------------------
+
+    std::array<std::array<int, 4>, 8> singleChannelPalette(const int value0, const int value1) noexcept
+    {
+        std::array<std::array<int, 4>, 8> palette{};
+        palette[0][0] = value0;
+        palette[1][0] = value1;
+        if (value0 > value1)
+        {
+            for (int i{ 1 }; i <= 6; ++i)
+            {
+                palette[i + 1][0] = ((7 - i) * value0 + i * value1 + 3) / 7;
+            }
+        }
+        else
+        {
+            for (int i{ 1 }; i <= 4; ++i)
+            {
+                palette[i + 1][0] = ((5 - i) * value0 + i * value1 + 2) / 5;
+            }
+            palette[6][0] = 0;
+            palette[7][0] = 255;
+        }
+        return palette;
+    }
+
+    void encodeSingleChannelBlock(const Block& block, const std::size_t channel, std::byte* destination) noexcept
+    {
+        Block values{};
+        auto minimum{ 255 };
+        auto maximum{ 0 };
+        for (std::size_t i{ 0 }; i < block.size(); ++i)
+        {
+            values[i][0] = block[i][channel];
+            minimum = std::min<int>(minimum, block[i][channel]);
+            maximum = std::max<int>(maximum, block[i][channel]);
+        }
+
+        std::array<uint8_t, 16> indices{};
+        if (maximum != minimum)
+        {
+            std::ignore = assignIndices<1>(values, singleChannelPalette(maximum, minimum), 8, indices);
+        }
+
+        uint64_t indexBits{ 0 };
+        for (std::size_t i{ 0 }; i < indices.size(); ++i)
+        {
+            indexBits |= static_cast<uint64_t>(indices[i]) << (3 * i);
+        }
+        destination[0] = static_cast<std::byte>(maximum);
+        destination[1] = static_cast<std::byte>(minimum);
+        for (std::size_t i{ 0 }; i < 6; ++i)
+        {
+            destination[2 + i] = static_cast<std::byte>(indexBits >> (8 * i) & 0xFF);
+        }
+    }
+
+    void decodeSingleChannelBlock(const std::byte* source, const std::size_t channel, Block& block) noexcept
+    {
+        const auto palette{
+            singleChannelPalette(static_cast<uint8_t>(source[0]), static_cast<uint8_t>(source[1]))
+        };
+        uint64_t indexBits{ 0 };
+        for (std::size_t i{ 0 }; i < 6; ++i)
+        {
+            indexBits |= static_cast<uint64_t>(static_cast<uint8_t>(source[2 + i])) << (8 * i);
+        }
+        for (std::size_t i{ 0 }; i < block.size(); ++i)
+        {
+            block[i][channel] = static_cast<uint8_t>(palette[indexBits >> (3 * i) & 0x7][0]);
+        }
+    }
+
+    // BC7 mode 6: one subset, 7-bit RGBA endpoints with a p-bit each, 4-bit indices --------------------------------
+
+    class BitWriter
+    {
+    public:
+        explicit BitWriter(std::byte* destination) noexcept
+            : m_destination{ destination }
+        {
+            std::fill_n(m_destination, 16, std::byte{ 0 });
+        }
+
+        void write(const uint32_t value, const uint32_t bitCount) noexcept
+        {
+            for (uint32_t i{ 0 }; i < bitCount; ++i, ++m_position)
+            {
+                if ((value >> i & 1) != 0)
+                {
+                    m_destination[m_position / 8] |= static_cast<std::byte>(1 << (m_position % 8));
+                }
+            }
+        }
+
+    private:
+        std::byte* m_destination;
+        uint32_t m_position{ 0 };
+    };
+
+    class BitReader
+    {
+    public:
+        explicit BitReader(const std::byte* source) noexcept
+            : m_source{ source }
+        {
+        }
+
+        [[nodiscard]] uint32_t read(const uint32_t bitCount) noexcept
+        {
+            uint32_t value{ 0 };
+            for (uint32_t i{ 0 }; i < bitCount; ++i, ++m_position)
+            {
+                value |= static_cast<uint32_t>(static_cast<uint8_t>(m_source[m_position / 8]) >> (m_position % 8) & 1)
+                        << i;
+            }
+            return value;
+        }
+
+    private:
+        const std::byte* m_source;
+        uint32_t m_position{ 0 };
+    };
+
+    struct Bc7Endpoint
+    {
+        std::array<uint32_t, 4> value{}; // 7 bits per channel
+        uint32_t pBit{ 0 };
+
+        [[nodiscard]] std::array<int, 4> expand() const noexcept
+        {
+            return {
+                static_cast<int>(value[0] << 1 | pBit), static_cast<int>(value[1] << 1 | pBit),
+                static_cast<int>(value[2] << 1 | pBit), static_cast<int>(value[3] << 1 | pBit)
+            };
+        }
+    };
+
+    Bc7Endpoint quantizeBc7Endpoint(const std::array<float, 4>& color) noexcept
+    {
+        Bc7Endpoint best{};
+        auto bestError{ std::numeric_limits<float>::max() };
+        for (uint32_t pBit{ 0 }; pBit < 2; ++pBit)
+        {
+            Bc7Endpoint candidate{ .pBit = pBit };
+            auto error{ 0.0f };
+            for (std::size_t c{ 0 }; c < 4; ++c)
+            {
+                candidate.value[c] = static_cast<uint32_t>(
+                    std::clamp(std::lround((color[c] - static_cast<float>(pBit)) / 2.0f), 0l, 127l));
+                const auto difference{ static_cast<float>(candidate.value[c] << 1 | pBit) - color[c] };
+                error += difference * difference;
+            }
+            if (error < bestError)
+            {
+                bestError = error;
+                best = candidate;
+            }
+        }
+        return best;
+    }
+
+    Palette4 bc7Palette(const Bc7Endpoint& endpoint0, const Bc7Endpoint& endpoint1) noexcept
+    {
+        const auto e0{ endpoint0.expand() };
+        const auto e1{ endpoint1.expand() };
+        Palette4 palette{};
+        for (std::size_t i{ 0 }; i < palette.size(); ++i)
+        {
+            for (std::size_t c{ 0 }; c < 4; ++c)
+            {
+                palette[i][c] = ((64 - BC7_WEIGHTS[i]) * e0[c] + BC7_WEIGHTS[i] * e1[c] + 32) >> 6;
+            }
+        }
+        return palette;
+    }
+
+    struct Bc7Candidate
+    {
+        Bc7Endpoint endpoint0;
+        Bc7Endpoint endpoint1;
+        std::array<uint8_t, 16> indices{};
+        int error{ std::numeric_limits<int>::max() };
+    };
+
+    Bc7Candidate evaluateBc7Endpoints(const Block& block,
+                                      const std::array<float, 4>& endpoint0,
+                                      const std::array<float, 4>& endpoint1) noexcept
+    {
+        Bc7Candidate candidate{
+            .endpoint0 = quantizeBc7Endpoint(endpoint0),
+            .endpoint1 = quantizeBc7Endpoint(endpoint1)
+        };
+        candidate.error = assignIndices<4>(block, bc7Palette(candidate.endpoint0, candidate.endpoint1), 16,
+                                           candidate.indices);
+        return candidate;
+    }
+
+    void encodeBc7Block(const Block& block, std::byte* destination) noexcept
+    {
+        auto [endpoint0, endpoint1]{ principalExtent<4>(block) };
+        auto best{ evaluateBc7Endpoints(block, endpoint0, endpoint1) };
+
+        std::array<float, 16> weights{};
+        for (std::size_t i{ 0 }; i < weights.size(); ++i)
+        {
+            weights[i] = static_cast<float>(BC7_WEIGHTS[best.indices[i]]) / 64.0f;
+        }
+        if (refitEndpoints<4>(block, weights, endpoint0, endpoint1))
+        {
+            if (const auto refined{ evaluateBc7Endpoints(block, endpoint0, endpoint1) }; refined.error < best.error)
+            {
+                best = refined;
+            }
+        }
+
+        // The anchor texel stores its index with an implicit zero MSB
+        if ((best.indices[0] & 0x8) != 0)
+        {
+            std::swap(best.endpoint0, best.endpoint1);
+            for (auto& index : best.indices)
+            {
+                index = static_cast<uint8_t>(15 - index);
+            }
+        }
+
+        BitWriter writer{ destination };
+        writer.write(1 << 6, 7); // Mode 6
+        for (std::size_t c{ 0 }; c < 4; ++c)
+        {
+            writer.write(best.endpoint0.value[c], 7);
+            writer.write(best.endpoint1.value[c], 7);
+        }
+        writer.write(best.endpoint0.pBit, 1);
+        writer.write(best.endpoint1.pBit, 1);
+        writer.write(best.indices[0], 3);
+        for (std::size_t i{ 1 }; i < best.indices.size(); ++i)
+        {
+            writer.write(best.indices[i], 4);
+        }
+    }
+
+    // BC7 decoding, every mode ----------------------------------------------------------------------------------------
+
+    struct Bc7Mode
+    {
+        uint32_t subsetCount;
+        uint32_t partitionBits;
+        uint32_t rotationBits;
+        uint32_t indexSelectionBits;
+        uint32_t colorBits;
+        uint32_t alphaBits; // 0 when alpha is always opaque
+        bool endpointPBits; // One p-bit per endpoint
+        bool sharedPBits; // One p-bit per subset
+        uint32_t indexBits;
+        uint32_t secondaryIndexBits; // Separate alpha (or color, by index selection) indices; 0 if none
+    };
+
+    constexpr std::array<Bc7Mode, 8> BC7_MODES{
+        {
+            { 3, 4, 0, 0, 4, 0, true, false, 3, 0 },
+            { 2, 6, 0, 0, 6, 0, false, true, 3, 0 },
+            { 3, 6, 0, 0, 5, 0, false, false, 2, 0 },
+            { 2, 6, 0, 0, 7, 0, true, false, 2, 0 },
+            { 1, 0, 2, 1, 5, 6, false, false, 2, 3 },
+            { 1, 0, 2, 0, 7, 8, false, false, 2, 2 },
+            { 1, 0, 0, 0, 7, 7, true, false, 4, 0 },
+            { 2, 6, 0, 0, 5, 5, true, false, 2, 0 }
+        }
+    };
+
+    constexpr std::array BC7_WEIGHTS2{ 0, 21, 43, 64 };
+    constexpr std::array BC7_WEIGHTS3{ 0, 9, 18, 27, 37, 46, 55, 64 };
+
+    // Two-subset partitions, bit i set when texel i belongs to the second subset
+    constexpr std::array<uint16_t, 64> BC7_PARTITIONS2{
+        0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80,
+        0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+        0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE,
+        0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+        0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A,
+        0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+        0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C,
+        0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22
+    };
+
+    // Three-subset partitions, two bits per texel holding its subset
+    constexpr std::array<uint32_t, 64> BC7_PARTITIONS3{
+        0xAA685050, 0x6A5A5040, 0x5A5A4200, 0x5450A0A8, 0xA5A50000, 0xA0A05050, 0x5555A0A0, 0x5A5A5050,
+        0xAA550000, 0xAA555500, 0xAAAA5500, 0x90909090, 0x94949494, 0xA4A4A4A4, 0xA9A59450, 0x2A0A4250,
+        0xA5945040, 0x0A425054, 0xA5A5A500, 0x55A0A0A0, 0xA8A85454, 0x6A6A4040, 0xA4A45000, 0x1A1A0500,
+        0x0050A4A4, 0xAAA59090, 0x14696914, 0x69691400, 0xA08585A0, 0xAA821414, 0x50A4A450, 0x6A5A0200,
+        0xA9A58000, 0x5090A0A8, 0xA8A09050, 0x24242424, 0x00AA5500, 0x24924924, 0x24499224, 0x50A50A50,
+        0x500AA550, 0xAAAA4444, 0x66660000, 0xA5A0A5A0, 0x50A050A0, 0x69286928, 0x44AAAA44, 0x66666600,
+        0xAA444444, 0x54A854A8, 0x95809580, 0x96969600, 0xA85454A8, 0x80959580, 0xAA141414, 0x96960000,
+        0xAAAA1414, 0xA05050A0, 0xA0A5A5A0, 0x96000000, 0x40804080, 0xA9A8A9A8, 0xAAAAAA44, 0x2A4A5254
+    };
+
+    // Anchor texels, whose index drops its top bit, of the second subset of two-subset partitions...
+    constexpr std::array<uint8_t, 64> BC7_ANCHORS2{
+        15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+        15, 2, 8, 2, 2, 8, 8, 15, 2, 8, 2, 2, 8, 8, 2, 2,
+        15, 15, 6, 8, 2, 8, 15, 15, 2, 8, 2, 2, 2, 15, 15, 6,
+        6, 2, 6, 8, 15, 15, 2, 2, 15, 15, 15, 15, 15, 2, 2, 15
+    };
+
+    // ...and of the second and third subsets of three-subset partitions; the first subset's anchor is texel 0
+    constexpr std::array<std::array<uint8_t, 64>, 2> BC7_ANCHORS3{
+        {
+            {
+                3, 3, 15, 15, 8, 3, 15, 15, 8, 8, 6, 6, 6, 5, 3, 3,
+                3, 3, 8, 15, 3, 3, 6, 10, 5, 8, 8, 6, 8, 5, 15, 15,
+                8, 15, 3, 5, 6, 10, 8, 15, 15, 3, 15, 5, 15, 15, 15, 15,
+                3, 15, 5, 5, 5, 8, 5, 10, 5, 10, 8, 13, 15, 12, 3, 3
+            },
+            {
+                15, 8, 8, 3, 15, 15, 3, 8, 15, 15, 15, 15, 15, 15, 15, 8,
+                15, 8, 15, 3, 15, 8, 15, 8, 3, 15, 6, 10, 15, 15, 10, 8,
+                15, 3, 15, 10, 10, 8, 9, 10, 6, 15, 8, 15, 3, 6, 6, 8,
+                15, 3, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 3, 15, 15, 8
+            }
+        }
+    };
+
+    uint32_t bc7Subset(const Bc7Mode& mode, const uint32_t partition, const std::size_t texel) noexcept
+    {
+        switch (mode.subsetCount)
+        {
+            case 2:
+                return BC7_PARTITIONS2[partition] >> texel & 1;
+            case 3:
+                return BC7_PARTITIONS3[partition] >> (texel * 2) & 3;
+            default:
+                return 0;
+        }
+    }
+
+    bool isBc7Anchor(const Bc7Mode& mode, const uint32_t partition, const std::size_t texel) noexcept
+    {
+        switch (mode.subsetCount)
+        {
+            case 2:
+                return texel == 0 || texel == BC7_ANCHORS2[partition];
+            case 3:
+                return texel == 0 || texel == BC7_ANCHORS3[0][partition] || texel == BC7_ANCHORS3[1][partition];
+            default:
+                return texel == 0;
+        }
+    }
+
+    int bc7Interpolate(const int endpoint0, const int endpoint1, const uint32_t index, const uint32_t indexBits)
+        noexcept
+    {
+        const auto weight{
+            indexBits == 2 ? BC7_WEIGHTS2[index] : indexBits == 3 ? BC7_WEIGHTS3[index] : BC7_WEIGHTS[index]
+        };
+        return ((64 - weight) * endpoint0 + weight * endpoint1 + 32) >> 6;
+    }
+
+    void decodeBc7Block(const std::byte* source, Block& block) noexcept
+    {
+        const auto modeIndex{ static_cast<uint32_t>(std::countr_zero(static_cast<uint8_t>(source[0]))) };
+        if (modeIndex >= BC7_MODES.size())
+        {
+            // Reserved mode, decodes to transparent black
+            block.fill({});
+            return;
+        }
+        const auto& mode{ BC7_MODES[modeIndex] };
+
+        BitReader reader{ source };
+        std::ignore = reader.read(modeIndex + 1);
+        const auto partition{ reader.read(mode.partitionBits) };
+        const auto rotation{ reader.read(mode.rotationBits) };
+        const auto indexSelection{ reader.read(mode.indexSelectionBits) };
+
+        // Each channel is stored for every endpoint before the next channel; endpoint 2s + e is end e of subset s
+        const auto endpointCount{ mode.subsetCount * 2 };
+        std::array<std::array<int, 4>, 6> endpoints{};
+        for (std::size_t c{ 0 }; c < 4; ++c)
+        {
+            for (std::size_t e{ 0 }; e < endpointCount; ++e)
+            {
+                endpoints[e][c] = static_cast<int>(reader.read(c < 3 ? mode.colorBits : mode.alphaBits));
+            }
+        }
+        std::array<uint32_t, 6> pBits{};
+        for (std::size_t e{ 0 }; e < endpointCount; ++e)
+        {
+            if (mode.endpointPBits)
+            {
+                pBits[e] = reader.read(1);
+            }
+            else if (mode.sharedPBits && e % 2 == 0)
+            {
+                pBits[e] = pBits[e + 1] = reader.read(1);
+            }
+        }
+
+        // Append the p-bit, then widen to 8 bits by replicating the top bits
+        for (std::size_t e{ 0 }; e < endpointCount; ++e)
+        {
+            for (std::size_t c{ 0 }; c < 4; ++c)
+            {
+                auto bits{ c < 3 ? mode.colorBits : mode.alphaBits };
+                if (bits == 0)
+                {
+                    endpoints[e][c] = 255;
+                    continue;
+                }
+                auto value{ endpoints[e][c] };
+                if (mode.endpointPBits || mode.sharedPBits)
+                {
+                    value = value << 1 | static_cast<int>(pBits[e]);
+                    ++bits;
+                }
+                value <<= 8 - bits;
+                endpoints[e][c] = value | value >> bits;
+            }
+        }
+
+        // Anchor texels store their index without its top bit, which is always 0
+        std::array<uint32_t, 16> indices{};
+        for (std::size_t i{ 0 }; i < indices.size(); ++i)
+        {
+            indices[i] = reader.read(isBc7Anchor(mode, partition, i) ? mode.indexBits - 1 : mode.indexBits);
+        }
+        std::array<uint32_t, 16> secondaryIndices{};
+        if (mode.secondaryIndexBits != 0)
+        {
+            for (std::size_t i{ 0 }; i < secondaryIndices.size(); ++i)
+            {
+                secondaryIndices[i] = reader.read(i == 0 ? mode.secondaryIndexBits - 1 : mode.secondaryIndexBits);
+            }
+        }
+
+        for (std::size_t i{ 0 }; i < block.size(); ++i)
+        {
+            const auto subset{ bc7Subset(mode, partition, i) };
+            const auto& endpoint0{ endpoints[subset * 2] };
+            const auto& endpoint1{ endpoints[subset * 2 + 1] };
+
+            auto colorIndex{ indices[i] };
+            auto colorBits{ mode.indexBits };
+            auto alphaIndex{ indices[i] };
+            auto alphaBits{ mode.indexBits };
+            if (mode.secondaryIndexBits != 0)
+            {
+                // Index selection swaps which set of indices drives color and which drives alpha
+                if (indexSelection == 0)
+                {
+                    alphaIndex = secondaryIndices[i];
+                    alphaBits = mode.secondaryIndexBits;
+                }
+                else
+                {
+                    colorIndex = secondaryIndices[i];
+                    colorBits = mode.secondaryIndexBits;
+                }
+            }
+
+            auto& texel{ block[i] };
+            for (std::size_t c{ 0 }; c < 3; ++c)
+            {
+                texel[c] = static_cast<uint8_t>(bc7Interpolate(endpoint0[c], endpoint1[c], colorIndex, colorBits));
+            }
+            texel[3] = static_cast<uint8_t>(bc7Interpolate(endpoint0[3], endpoint1[3], alphaIndex, alphaBits));
+
+            // Rotation swaps alpha with red, green or blue
+            if (rotation != 0)
+            {
+                std::swap(texel[3], texel[rotation - 1]);
+            }
+        }
+    }
+
+    void encodeBlock(const Block& block, const lgl::CompressedFormat format, std::byte* destination) noexcept
+    {
+        switch (format)
+        {
+            case lgl::CompressedFormat::BC1:
+                encodeColorBlock(block, destination);
+                break;
+            case lgl::CompressedFormat::BC3:
+                encodeSingleChannelBlock(block, 3, destination);
+                encodeColorBlock(block, destination + 8);
+                break;
+            case lgl::CompressedFormat::BC4:
+                encodeSingleChannelBlock(block, 0, destination);
+                break;
+            case lgl::CompressedFormat::BC5:
+                encodeSingleChannelBlock(block, 0, destination);
+                encodeSingleChannelBlock(block, 1, destination + 8);
+                break;
+            case lgl::CompressedFormat::BC7:
+                encodeBc7Block(block, destination);
+                break;
+            default:
+                break;
+        }
+    }
+
+    void decodeBlock(const std::byte* source, const lgl::CompressedFormat format, Block& block)
+    {
+        switch (format)
+        {
+            case lgl::CompressedFormat::BC1:
+                decodeColorBlock(source, true, block);
+                break;
+            case lgl::CompressedFormat::BC3:
+                decodeSingleChannelBlock(source, 3, block);
+                decodeColorBlock(source + 8, false, block);
+                break;
+            case lgl::CompressedFormat::BC4:
+                decodeSingleChannelBlock(source, 0, block);
+                break;
+            case lgl::CompressedFormat::BC5:
+                decodeSingleChannelBlock(source, 0, block);
+                decodeSingleChannelBlock(source + 8, 1, block);
+                break;
+            case lgl::CompressedFormat::BC7:
+                decodeBc7Block(source, block);
+                break;
+            default:
+                throw std::runtime_error("Not a block-compressed format");
+        }
+    }
+
+    // Vertical flips without decoding ---------------------------------------------------------------------------------
+
+    // Reverses the first rowCount texel rows of a BC1 block, whose indices take a byte per row
+    void flipColorBlock(std::byte* block, const uint32_t rowCount) noexcept
+    {
+        std::reverse(block + 4, block + 4 + rowCount);
+    }
+
+    // Reverses the first rowCount texel rows of a BC4 block, whose indices take 12 bits per row
+    void flipSingleChannelBlock(std::byte* block, const uint32_t rowCount) noexcept
+    {
+        uint64_t indexBits{ 0 };
+        for (std::size_t i{ 0 }; i < 6; ++i)
+        {
+            indexBits |= static_cast<uint64_t>(static_cast<uint8_t>(block[2 + i])) << (8 * i);
+        }
+        auto flipped{ indexBits };
+        for (uint32_t row{ 0 }; row < rowCount; ++row)
+        {
+            const auto source{ indexBits >> (12 * (rowCount - 1 - row)) & 0xFFF };
+            flipped = (flipped & ~(uint64_t{ 0xFFF } << (12 * row))) | source << (12 * row);
+        }
+        for (std::size_t i{ 0 }; i < 6; ++i)
+        {
+            block[2 + i] = static_cast<std::byte>(flipped >> (8 * i) & 0xFF);
+        }
+    }
+
+    void flipBlock(std::byte* block, const lgl::CompressedFormat format, const uint32_t rowCount) noexcept
+    {
+        switch (format)
+        {
+            case lgl::CompressedFormat::BC1:
+                flipColorBlock(block, rowCount);
+                break;
+            case lgl::CompressedFormat::BC3:
+                flipSingleChannelBlock(block, rowCount);
+                flipColorBlock(block + 8, rowCount);
+                break;
+            case lgl::CompressedFormat::BC4:
+                flipSingleChannelBlock(block, rowCount);
+                break;
+            case lgl::CompressedFormat::BC5:
+                flipSingleChannelBlock(block, rowCount);
+                flipSingleChannelBlock(block + 8, rowCount);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+namespace lgl
+{
+    std::vector<std::byte> compress(const ImageData& image, const CompressedFormat format)
+    {
+        if (!image.isValid())
+        {
+            throw std::runtime_error("Cannot compress an invalid image");
+        }
+
+        const auto blocksX{ (image.width + 3) / 4 };
+        const auto blocksY{ (image.height + 3) / 4 };
+        const auto bytesPerBlock{ blockSize(format) };
+        std::vector<std::byte> blocks(compressedSize(format, image.width, image.height));
+
+        ThreadPool::shared().parallelFor(blocksY, [&](const std::size_t blockY)
+        {
+            for (uint32_t blockX{ 0 }; blockX < blocksX; ++blockX)
+            {
+                encodeBlock(fetchBlock(image, blockX, static_cast<uint32_t>(blockY)),
+                            format,
+                            blocks.data() + (blockY * blocksX + blockX) * bytesPerBlock);
+            }
+        });
+        return blocks;
+    }
+
+    ImageData decompress(const std::span<const std::byte> blocks,
+                         const uint32_t width,
+                         const uint32_t height,
+                         const CompressedFormat format)
+    {
+        if (blocks.size() < compressedSize(format, width, height))
+        {
+            throw std::runtime_error("Compressed data is smaller than its dimensions require");
+        }
+
+        ImageData image{
+            .data = {},
+            .width = width,
+            .height = height,
+            .channels = channelCount(format),
+            .pixelFormat = ImageData::getPixelFormat(channelCount(format))
+        };
+        image.data.resize(image.rowSize() * height);
+
+        const auto blocksX{ (width + 3) / 4 };
+        const auto blocksY{ (height + 3) / 4 };
+        const auto bytesPerBlock{ blockSize(format) };
+        for (uint32_t blockY{ 0 }; blockY < blocksY; ++blockY)
+        {
+            for (uint32_t blockX{ 0 }; blockX < blocksX; ++blockX)
+            {
+                Block block{};
+                decodeBlock(blocks.data() + (static_cast<std::size_t>(blockY) * blocksX + blockX) * bytesPerBlock,
+                            format,
+                            block);
+                storeBlock(image, blockX, blockY, block);
+            }
+        }
+        return image;
+    }
+
+    void flipVertically(const std::span<std::byte> blocks,
+                        const uint32_t width,
+                        const uint32_t height,
+                        const CompressedFormat format)
+    {
+        if (!isVerticallyFlippable(format, height))
+        {
+            throw std::runtime_error(std::format("{} blocks of height {} cannot be flipped without decoding",
+                                                 format,
+                                                 height));
+        }
+        const auto size{ compressedSize(format, width, height) };
+        if (blocks.size() < size)
+        {
+            throw std::runtime_error("Compressed data is smaller than its dimensions require");
+        }
+
+        const auto blocksY{ (height + 3) / 4 };
+        const auto rowSize{ size / blocksY };
+        for (uint32_t blockY{ 0 }; blockY < blocksY / 2; ++blockY)
+        {
+            std::swap_ranges(blocks.begin() + blockY * rowSize,
+                             blocks.begin() + (blockY + 1) * rowSize,
+                             blocks.begin() + (blocksY - 1 - blockY) * rowSize);
+        }
+        // A level shorter than a block only holds that many texel rows
+        const auto rowCount{ std::min(height, 4u) };
+        for (std::size_t offset{ 0 }; offset < size; offset += blockSize(format))
+        {
+            flipBlock(blocks.data() + offset, format, rowCount);
+        }
+    }
+
+    double psnr(const ImageData& reference, const ImageData& image)
+    {
+        if (reference.width != image.width || reference.height != image.height)
+        {
+            throw std::runtime_error("PSNR requires images of the same size");
+        }
+
+        const auto channels{ std::min(reference.channels, image.channels) };
+        const auto texelCount{ static_cast<std::size_t>(reference.width) * reference.height };
+        auto squaredError{ 0.0 };
+        for (std::size_t i{ 0 }; i < texelCount; ++i)
+        {
+            for (uint8_t c{ 0 }; c < channels; ++c)
+            {
+                const auto difference{
+                    static_cast<double>(static_cast<uint8_t>(reference.data[i * reference.channels + c])) -
+                    static_cast<double>(static_cast<uint8_t>(image.data[i * image.channels + c]))
+                };
+                squaredError += difference * difference;
+            }
+        }
+        const auto meanSquaredError{ squaredError / static_cast<double>(texelCount * channels) };
+        if (meanSquaredError == 0.0)
+        {
+            return std::numeric_limits<double>::infinity();
+        }
+        return 10.0 * std::log10(255.0 * 255.0 / meanSquaredError);
+    }
+} // lgl
@@ -0,0 +1,473 @@
+//
+// Created by user on 10/17/26.
+//
+
+#include "app/TextureContainer.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <format>
+#include <string_view>
+#include <type_traits>
+
+namespace
+{
+    struct Ktx2Header
+    {
+        std::array<uint8_t, 12> identifier;
+        uint32_t vkFormat;
+        uint32_t typeSize;
+        uint32_t pixelWidth;
+        uint32_t pixelHeight;
+        uint32_t pixelDepth;
+        uint32_t layerCount;
+        uint32_t faceCount;
+        uint32_t levelCount;
+        uint32_t supercompressionScheme;
+        uint32_t dfdByteOffset;
+        uint32_t dfdByteLength;
+        uint32_t kvdByteOffset;
+        uint32_t kvdByteLength;
+        uint64_t sgdByteOffset;
+        uint64_t sgdByteLength;
+    };
+
+    struct Ktx2LevelIndex
+    {
+        uint64_t byteOffset;
+        uint64_t byteLength;
+        uint64_t uncompressedByteLength;
+    };
+
+    struct DdsPixelFormat
+    {
+        uint32_t size;
+        uint32_t flags;
+        uint32_t fourCC;
+        uint32_t rgbBitCount;
+        uint32_t rBitMask;
+        uint32_t gBitMask;
+        uint32_t bBitMask;
+        uint32_t aBitMask;
+    };
+
+    struct DdsHeader
+    {
+        uint32_t size;
+        uint32_t flags;
+        uint32_t height;
+        uint32_t width;
+        uint32_t pitchOrLinearSize;
+        uint32_t depth;
+        uint32_t mipMapCount;
+        std::array<uint32_t, 11> reserved1;
+        DdsPixelFormat pixelFormat;
+        uint32_t caps;
+        uint32_t caps2;
+        uint32_t caps3;
+        uint32_t caps4;
+        uint32_t reserved2;
+    };
+
+    struct DdsHeaderDx10
+    {
+        uint32_t dxgiFormat;
+        uint32_t resourceDimension;
+        uint32_t miscFlag;
+        uint32_t arraySize;
+        uint32_t miscFlags2;
+    };
+
+    static_assert(sizeof(Ktx2Header) == 80 && sizeof(Ktx2LevelIndex) == 24);
+    static_assert(sizeof(DdsHeader) == 124 && sizeof(DdsHeaderDx10) == 20);
+    static_assert(std::is_trivially_copyable_v<Ktx2Header> && std::is_trivially_copyable_v<DdsHeader>);
+
+    constexpr std::size_t DDS_MAGIC_SIZE{ 4 };
+    constexpr uint32_t DDSD_MIPMAPCOUNT{ 0x20000 };
+    constexpr uint32_t DDPF_FOURCC{ 0x4 };
+    constexpr uint32_t DDPF_RGB{ 0x40 };
+    constexpr uint32_t DDPF_LUMINANCE{ 0x20000 };
+    constexpr uint32_t DDSCAPS2_CUBEMAP{ 0x200 };
+    constexpr uint32_t DDSCAPS2_VOLUME{ 0x200000 };
+    constexpr uint32_t DDS_DIMENSION_TEXTURE2D{ 3 };
+    constexpr uint32_t DDS_RESOURCE_MISC_TEXTURECUBE{ 0x4 };
+
+    using Format = std::pair<lgl::PixelFormat, lgl::CompressedFormat>;
+
+    constexpr Format compressed(const lgl::CompressedFormat format)
+    {
+        return { lgl::ImageData::getPixelFormat(lgl::channelCount(format)), format };
+    }
+
+    constexpr Format uncompressed(const lgl::PixelFormat format) noexcept
+    {
+        return { format, lgl::CompressedFormat::None };
+    }
+
+    constexpr uint32_t fourCC(const std::string_view code) noexcept
+    {
+        return static_cast<uint32_t>(code[0]) |
+               static_cast<uint32_t>(code[1]) << 8 |
+               static_cast<uint32_t>(code[2]) << 16 |
+               static_cast<uint32_t>(code[3]) << 24;
+    }
+
+    // sRGB variants map to the same formats: textures are uploaded as linear data, as decoded images are
+    Format fromVkFormat(const uint32_t vkFormat)
+    {
+        switch (vkFormat)
+        {
+            case 9: // VK_FORMAT_R8_UNORM
+            case 15: // VK_FORMAT_R8_SRGB
+                return uncompressed(lgl::PixelFormat::Red);
+            case 16: // VK_FORMAT_R8G8_UNORM
+            case 22: // VK_FORMAT_R8G8_SRGB
+                return uncompressed(lgl::PixelFormat::RG);
+            case 23: // VK_FORMAT_R8G8B8_UNORM
+            case 29: // VK_FORMAT_R8G8B8_SRGB
+                return uncompressed(lgl::PixelFormat::RGB);
+            case 37: // VK_FORMAT_R8G8B8A8_UNORM
+            case 43: // VK_FORMAT_R8G8B8A8_SRGB
+                return uncompressed(lgl::PixelFormat::RGBA);
+            case 131: // VK_FORMAT_BC1_RGB_UNORM_BLOCK
+            case 132: // VK_FORMAT_BC1_RGB_SRGB_BLOCK
+                return compressed(lgl::CompressedFormat::BC1);
+            case 137: // VK_FORMAT_BC3_UNORM_BLOCK
+            case 138: // VK_FORMAT_BC3_SRGB_BLOCK
+                return compressed(lgl::CompressedFormat::BC3);
+            case 139: // VK_FORMAT_BC4_UNORM_BLOCK
+                return compressed(lgl::CompressedFormat::BC4);
+            case 141: // VK_FORMAT_BC5_UNORM_BLOCK
+                return compressed(lgl::CompressedFormat::BC5);
+            case 145: // VK_FORMAT_BC7_UNORM_BLOCK
+            case 146: // VK_FORMAT_BC7_SRGB_BLOCK
+                return compressed(lgl::CompressedFormat::BC7);
+            default:
+                throw std::runtime_error(std::format("Unsupported KTX2 format {}", vkFormat));
+        }
+    }
+
+    Format fromDxgiFormat(const uint32_t dxgiFormat)
+    {
+        switch (dxgiFormat)
+        {
+            case 61: // DXGI_FORMAT_R8_UNORM
+                return uncompressed(lgl::PixelFormat::Red);
+            case 49: // DXGI_FORMAT_R8G8_UNORM
+                return uncompressed(lgl::PixelFormat::RG);
+            case 28: // DXGI_FORMAT_R8G8B8A8_UNORM
+            case 29: // DXGI_FORMAT_R8G8B8A8_UNORM_SRGB
+                return uncompressed(lgl::PixelFormat::RGBA);
+            case 71: // DXGI_FORMAT_BC1_UNORM
+            case 72: // DXGI_FORMAT_BC1_UNORM_SRGB
+                return compressed(lgl::CompressedFormat::BC1);
+            case 77: // DXGI_FORMAT_BC3_UNORM
+            case 78: // DXGI_FORMAT_BC3_UNORM_SRGB
+                return compressed(lgl::CompressedFormat::BC3);
+            case 80: // DXGI_FORMAT_BC4_UNORM
+                return compressed(lgl::CompressedFormat::BC4);
+            case 83: // DXGI_FORMAT_BC5_UNORM
+                return compressed(lgl::CompressedFormat::BC5);
+            case 98: // DXGI_FORMAT_BC7_UNORM
+            case 99: // DXGI_FORMAT_BC7_UNORM_SRGB
+                return compressed(lgl::CompressedFormat::BC7);
+            default:
+                throw std::runtime_error(std::format("Unsupported DXGI format {}", dxgiFormat));
+        }
+    }
+
+    Format fromDdsPixelFormat(const DdsPixelFormat& pixelFormat)
+    {
+        if ((pixelFormat.flags & DDPF_FOURCC) != 0)
+        {
+            switch (pixelFormat.fourCC)
+            {
+                case fourCC("DXT1"):
+                    return compressed(lgl::CompressedFormat::BC1);
+                case fourCC("DXT5"):
+                    return compressed(lgl::CompressedFormat::BC3);
+                case fourCC("ATI1"):
+                case fourCC("BC4U"):
+                    return compressed(lgl::CompressedFormat::BC4);
+                case fourCC("ATI2"):
+                case fourCC("BC5U"):
+                    return compressed(lgl::CompressedFormat::BC5);
+                default:
+                    throw std::runtime_error("Unsupported DDS FourCC");
+            }
+        }
+        if ((pixelFormat.flags & DDPF_RGB) != 0 && pixelFormat.rgbBitCount == 32 &&
+            pixelFormat.rBitMask == 0x000000FF && pixelFormat.gBitMask == 0x0000FF00 &&
+            pixelFormat.bBitMask == 0x00FF0000)
+        {
+            return uncompressed(lgl::PixelFormat::RGBA);
+        }
+        if ((pixelFormat.flags & DDPF_LUMINANCE) != 0 && pixelFormat.rgbBitCount == 8)
+        {
+            return uncompressed(lgl::PixelFormat::Red);
+        }
+        throw std::runtime_error("Unsupported DDS pixel format");
+    }
+
+    template<typename T>
+    T readAt(const std::span<const std::byte> bytes, const std::size_t offset)
+    {
+        if (offset > bytes.size() || bytes.size() - offset < sizeof(T))
+        {
+            throw std::runtime_error("Texture container is truncated");
+        }
+        T value{};
+        std::memcpy(&value, bytes.data() + offset, sizeof(T));
+        return value;
+    }
+
+    constexpr uint8_t pixelSize(const lgl::PixelFormat pixelFormat)
+    {
+        switch (pixelFormat)
+        {
+            case lgl::PixelFormat::Red:
+                return 1;
+            case lgl::PixelFormat::RG:
+                return 2;
+            case lgl::PixelFormat::RGB:
+                return 3;
+            case lgl::PixelFormat::RGBA:
+                return 4;
+            default:
+                throw std::runtime_error("Unsupported pixel format");
+        }
+    }
+
+    std::size_t levelSize(const Format& format, const uint32_t width, const uint32_t height)
+    {
+        const auto [pixelFormat, compressedFormat]{ format };
+        if (compressedFormat != lgl::CompressedFormat::None)
+        {
+            return lgl::compressedSize(compressedFormat, width, height);
+        }
+        return static_cast<std::size_t>(width) * height * pixelSize(pixelFormat);
+    }
+
+    // Views one level inside the mapping after checking that it lies within the file and is large enough
+    lgl::MipLevel makeLevel(const std::span<const std::byte> bytes,
+                            const uint64_t offset,
+                            const uint64_t size,
+                            const Format& format,
+                            const uint32_t level,
+                            const uint32_t baseWidth,
+                            const uint32_t baseHeight)
+    {
+        const auto width{ std::max(baseWidth >> level, 1u) };
+        const auto height{ std::max(baseHeight >> level, 1u) };
+        const auto expectedSize{ levelSize(format, width, height) };
+        if (size < expectedSize || offset > bytes.size() || expectedSize > bytes.size() - offset)
+        {
+            throw std::runtime_error(std::format("Texture container level {} is truncated", level));
+        }
+        return { .width = width, .height = height, .data = bytes.subspan(offset, expectedSize) };
+    }
+
+    // KTXorientation is "rd" (top-down) unless the writer says otherwise
+    lgl::ImageData::RowOrder ktx2RowOrder(const std::span<const std::byte> bytes, const Ktx2Header& header)
+    {
+        constexpr std::string_view orientationKey{ "KTXorientation" };
+        if (header.kvdByteOffset > bytes.size() || header.kvdByteLength > bytes.size() - header.kvdByteOffset)
+        {
+            throw std::runtime_error("KTX2 key/value data is truncated");
+        }
+        const auto keyValueData{ bytes.subspan(header.kvdByteOffset, header.kvdByteLength) };
+        for (std::size_t offset{ 0 }; offset + sizeof(uint32_t) <= keyValueData.size();)
+        {
+            const auto length{ readAt<uint32_t>(keyValueData, offset) };
+            offset += sizeof(uint32_t);
+            if (length > keyValueData.size() - offset)
+            {
+                break;
+            }
+            const std::string_view entry{ reinterpret_cast<const char*>(keyValueData.data() + offset), length };
+            if (entry.starts_with(orientationKey) && entry.size() > orientationKey.size() + 2 &&
+                entry[orientationKey.size()] == '\0')
+            {
+                return entry[orientationKey.size() + 2] == 'u'
+                       ? lgl::ImageData::RowOrder::BottomUp
+                       : lgl::ImageData::RowOrder::TopDown;
+            }
+            offset += (length + 3) / 4 * 4;
+        }
+        return lgl::ImageData::RowOrder::TopDown;
+    }
+
+    lgl::TextureContainer parseKtx2(lgl::MappedFile file)
+    {
+        // Moving the mapping keeps its address, so spans taken here stay valid inside the container
+        const auto bytes{ file.bytes() };
+        if (lgl::detail::detectImageFormat(bytes) != lgl::ImageFormat::KTX2)
+        {
+            throw std::runtime_error("Not a KTX2 file");
+        }
+        const auto header{ readAt<Ktx2Header>(bytes, 0) };
+        if (header.supercompressionScheme != 0)
+        {
+            throw std::runtime_error("Supercompressed KTX2 files are not supported");
+        }
+        if (header.pixelWidth == 0 || header.pixelHeight == 0 || header.pixelDepth > 1 || header.layerCount > 1 ||
+            header.faceCount != 1)
+        {
+            throw std::runtime_error("Only 2D KTX2 textures are supported");
+        }
+
+        const auto format{ fromVkFormat(header.vkFormat) };
+        // A level count of 0 asks the loader to generate the chain; only the base level is stored then
+        const auto levelCount{ std::max(header.levelCount, 1u) };
+        if (levelCount > lgl::mipLevelCount(header.pixelWidth, header.pixelHeight))
+        {
+            throw std::runtime_error("KTX2 file declares more mip levels than its size has");
+        }
+        lgl::TextureContainer container{
+            .file = std::move(file),
+            .pixelFormat = format.first,
+            .compressedFormat = format.second,
+            .rowOrder = ktx2RowOrder(bytes, header),
+            .levels = {}
+        };
+        container.levels.reserve(levelCount);
+        for (uint32_t level{ 0 }; level < levelCount; ++level)
+        {
+            const auto index{ readAt<Ktx2LevelIndex>(bytes, sizeof(Ktx2Header) + level * sizeof(Ktx2LevelIndex)) };
+            container.levels.push_back(makeLevel(bytes, index.byteOffset, index.byteLength, format, level,
+                                                 header.pixelWidth, header.pixelHeight));
+        }
+        return container;
+    }
+
+    lgl::TextureContainer parseDds(lgl::MappedFile file)
+    {
+        // See parseKtx2: the spans outlive the move into the container
+        const auto bytes{ file.bytes() };
+        if (lgl::detail::detectImageFormat(bytes) != lgl::ImageFormat::DDS)
+        {
+            throw std::runtime_error("Not a DDS file");
+        }
+        const auto header{ readAt<DdsHeader>(bytes, DDS_MAGIC_SIZE) };
+        if (header.size != sizeof(DdsHeader) || header.width == 0 || header.height == 0 ||
+            (header.caps2 & (DDSCAPS2_CUBEMAP | DDSCAPS2_VOLUME)) != 0)
+        {
+            throw std::runtime_error("Only 2D DDS textures are supported");
+        }
+
+        auto offset{ DDS_MAGIC_SIZE + sizeof(DdsHeader) };
+        Format format{};
+        if ((header.pixelFormat.flags & DDPF_FOURCC) != 0 && header.pixelFormat.fourCC == fourCC("DX10"))
+        {
+            const auto extension{ readAt<DdsHeaderDx10>(bytes, offset) };
+            offset += sizeof(DdsHeaderDx10);
+            if (extension.resourceDimension != DDS_DIMENSION_TEXTURE2D || extension.arraySize > 1 ||
+                (extension.miscFlag & DDS_RESOURCE_MISC_TEXTURECUBE) != 0)
+            {
+                throw std::runtime_error("Only 2D DDS textures are supported");
+            }
+            format = fromDxgiFormat(extension.dxgiFormat);
+        }
+        else
+        {
+            format = fromDdsPixelFormat(header.pixelFormat);
+        }
+
+        const auto levelCount{ (header.flags & DDSD_MIPMAPCOUNT) != 0 ? std::max(header.mipMapCount, 1u) : 1u };
+        if (levelCount > lgl::mipLevelCount(header.width, header.height))
+        {
+            throw std::runtime_error("DDS file declares more mip levels than its size has");
+        }
+        lgl::TextureContainer container{
+            .file = std::move(file),
+            .pixelFormat = format.first,
+            .compressedFormat = format.second,
+            .rowOrder = lgl::ImageData::RowOrder::TopDown,
+            .levels = {}
+        };
+        container.levels.reserve(levelCount);
+        for (uint32_t level{ 0 }; level < levelCount; ++level)
+        {
+            // Levels are stored back to back, base level first
+            auto mipLevel{ makeLevel(bytes, offset, bytes.size() - offset, format, level,
+                                     header.width, header.height) };
+            offset += mipLevel.data.size();
+            container.levels.push_back(mipLevel);
+        }
+        return container;
+    }
+
+    lgl::ImageData levelImage(const lgl::TextureContainer& container, const lgl::ImageLoadOptions& options)
+    {
+        // The first stored level that fits, mirroring the scale steps of the decoders
+        const auto& levels{ container.levels };
+        const auto& base{ levels.front() };
+        const auto denominator{ lgl::scaleDenominator(base.width, base.height, options.maxDimension) };
+        const auto& level{ levels[std::min<std::size_t>(std::countr_zero(denominator), levels.size() - 1)] };
+        auto image{
+            container.compressedFormat != lgl::CompressedFormat::None
+            ? lgl::decompress(level.data, level.width, level.height, container.compressedFormat)
+            : lgl::ImageData{
+                .data = { level.data.begin(), level.data.end() },
+                .width = level.width,
+                .height = level.height,
+                .channels = pixelSize(container.pixelFormat),
+                .pixelFormat = container.pixelFormat
+            }
+        };
+        image.rowOrder = container.rowOrder;
+
+        const auto requestedOrder{
+            options.flipVertically ? lgl::ImageData::RowOrder::BottomUp : lgl::ImageData::RowOrder::TopDown
+        };
+        if (image.rowOrder != requestedOrder)
+        {
+            image.flipVerticallyInPlace();
+        }
+        return image;
+    }
+}
+
+namespace lgl
+{
+    namespace detail
+    {
+        TextureContainer ImageReader<ImageFormat::KTX2>::map(const std::filesystem::path& file_path)
+        {
+            return parseKtx2(MappedFile::open(file_path));
+        }
+
+        ImageData ImageReader<ImageFormat::KTX2>::read(const std::filesystem::path& file_path,
+                                                       const ImageLoadOptions& options)
+        {
+            return levelImage(map(file_path), options);
+        }
+
+        TextureContainer ImageReader<ImageFormat::DDS>::map(const std::filesystem::path& file_path)
+        {
+            return parseDds(MappedFile::open(file_path));
+        }
+
+        ImageData ImageReader<ImageFormat::DDS>::read(const std::filesystem::path& file_path,
+                                                      const ImageLoadOptions& options)
+        {
+            return levelImage(map(file_path), options);
+        }
+    }
+
+    std::optional<TextureContainer> mapTextureContainer(const std::filesystem::path& filePath)
+    {
+        auto file{ MappedFile::open(filePath) };
+        switch (detail::detectImageFormat(file.bytes()))
+        {
+            case ImageFormat::KTX2:
+                return parseKtx2(std::move(file));
+            case ImageFormat::DDS:
+                return parseDds(std::move(file));
+            default:
+                return std::nullopt;
+        }
+    }
+} // lgl
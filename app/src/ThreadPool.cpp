@@ -0,0 +1,71 @@
+//
+// Created by user on 10/17/26.
+//
+
+#include "app/ThreadPool.h"
+
+#include <algorithm>
+
+namespace lgl
+{
+    ThreadPool::ThreadPool(const std::size_t threadCount)
+    {
+        m_workers.reserve(threadCount);
+        for (std::size_t i{ 0 }; i < threadCount; ++i)
+        {
+            m_workers.emplace_back([this](const std::stop_token stopToken)
+            {
+                workerLoop(stopToken);
+            });
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        for (auto&& worker : m_workers)
+        {
+            worker.request_stop();
+        }
+        m_condition.notify_all();
+        // std::jthread joins on destruction; tasks still queued are dropped and their futures become broken
+        m_workers.clear();
+    }
+
+    ThreadPool& ThreadPool::shared()
+    {
+        static ThreadPool pool{ std::max(1u, std::thread::hardware_concurrency()) };
+        return pool;
+    }
+
+    std::size_t ThreadPool::size() const noexcept
+    {
+        return m_workers.size();
+    }
+
+    void ThreadPool::enqueue(std::move_only_function<void()> task)
+    {
+        {
+            std::scoped_lock lock{ m_mutex };
+            m_tasks.push(std::move(task));
+        }
+        m_condition.notify_one();
+    }
+
+    void ThreadPool::workerLoop(const std::stop_token stopToken)
+    {
+        while (true)
+        {
+            std::move_only_function<void()> task{};
+            {
+                std::unique_lock lock{ m_mutex };
+                if (!m_condition.wait(lock, stopToken, [this] { return !m_tasks.empty(); }))
+                {
+                    return; // Stop requested
+                }
+                task = std::move(m_tasks.front());
+                m_tasks.pop();
+            }
+            task();
+        }
+    }
+} // lgl
@@ -0,0 +1,138 @@
+//
+// Created by user on 10/17/26.
+//
+
+#include "app/Vertex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/gtc/packing.hpp>
+
+namespace
+{
+    int16_t toSnorm16(const float value) noexcept
+    {
+        return static_cast<int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+    }
+
+    uint16_t toUnorm16(const float value) noexcept
+    {
+        return static_cast<uint16_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 65535.0f));
+    }
+
+    float signNotZero(const float value) noexcept
+    {
+        return value >= 0.0f ? 1.0f : -1.0f;
+    }
+
+    std::array<uint16_t, 2> packTextureCoordinates(const glm::vec2& textureCoordinates) noexcept
+    {
+        return { glm::packHalf1x16(textureCoordinates.x), glm::packHalf1x16(textureCoordinates.y) };
+    }
+
+    std::array<int16_t, 4> packTangent(const lgl::Vertex& vertex) noexcept
+    {
+        const auto length{ glm::length(vertex.tangent) };
+        if (length <= std::numeric_limits<float>::epsilon())
+        {
+            return { 0, 0, 0, 32767 };
+        }
+        const auto tangent{ vertex.tangent / length };
+        const auto handedness{ signNotZero(glm::dot(glm::cross(vertex.normal, tangent), vertex.bitangent)) };
+        return { toSnorm16(tangent.x), toSnorm16(tangent.y), toSnorm16(tangent.z), toSnorm16(handedness) };
+    }
+}
+
+namespace lgl
+{
+    std::array<int16_t, 2> encodeOctahedral(const glm::vec3& direction) noexcept
+    {
+        const auto sum{ std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z) };
+        if (sum <= std::numeric_limits<float>::epsilon())
+        {
+            return { 0, 0 };
+        }
+
+        // Project onto the octahedron, then fold the lower hemisphere over the upper one
+        auto x{ direction.x / sum };
+        auto y{ direction.y / sum };
+        if (direction.z < 0.0f)
+        {
+            const auto foldedX{ (1.0f - std::abs(y)) * signNotZero(x) };
+            const auto foldedY{ (1.0f - std::abs(x)) * signNotZero(y) };
+            x = foldedX;
+            y = foldedY;
+        }
+        return { toSnorm16(x), toSnorm16(y) };
+    }
+
+    glm::vec3 decodeOctahedral(const std::array<int16_t, 2>& encoded) noexcept
+    {
+        const auto x{ std::max(encoded[0] / 32767.0f, -1.0f) };
+        const auto y{ std::max(encoded[1] / 32767.0f, -1.0f) };
+        glm::vec3 direction{ x, y, 1.0f - std::abs(x) - std::abs(y) };
+        const auto fold{ std::max(-direction.z, 0.0f) };
+        direction.x += direction.x >= 0.0f ? -fold : fold;
+        direction.y += direction.y >= 0.0f ? -fold : fold;
+        return glm::normalize(direction);
+    }
+
+    PackedVertex pack(const Vertex& vertex) noexcept
+    {
+        return {
+            .position = vertex.position,
+            .normal = encodeOctahedral(vertex.normal),
+            .textureCoordinates = packTextureCoordinates(vertex.textureCoordinates),
+            .tangent = packTangent(vertex)
+        };
+    }
+
+    Dequantization dequantization(const std::span<const Vertex> vertices) noexcept
+    {
+        if (vertices.empty())
+        {
+            return {};
+        }
+
+        auto minimum{ vertices.front().position };
+        auto maximum{ vertices.front().position };
+        for (const auto& vertex : vertices)
+        {
+            minimum = glm::min(minimum, vertex.position);
+            maximum = glm::max(maximum, vertex.position);
+        }
+        return { .scale = maximum - minimum, .offset = minimum };
+    }
+
+    BoundingSphere boundingSphere(const std::span<const Vertex> vertices) noexcept
+    {
+        const auto bounds{ dequantization(vertices) };
+        const auto center{ bounds.offset + bounds.scale * 0.5f };
+        float radius{ 0.0f };
+        for (const auto& vertex : vertices)
+        {
+            radius = std::max(radius, glm::distance(center, vertex.position));
+        }
+        return { .center = center, .radius = radius };
+    }
+
+    QuantizedVertex quantize(const Vertex& vertex, const Dequantization& dequantization) noexcept
+    {
+        const auto normalized{
+            [&](const int axis)
+            {
+                const auto extent{ dequantization.scale[axis] };
+                return extent > 0.0f ? (vertex.position[axis] - dequantization.offset[axis]) / extent : 0.0f;
+            }
+        };
+        return {
+            .position = { toUnorm16(normalized(0)), toUnorm16(normalized(1)), toUnorm16(normalized(2)), 0 },
+            .normal = encodeOctahedral(vertex.normal),
+            .textureCoordinates = packTextureCoordinates(vertex.textureCoordinates),
+            .tangent = packTangent(vertex)
+        };
+    }
+} // lgl
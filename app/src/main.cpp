@@ -3,6 +3,7 @@
 #include <fstream>
 #include <print>
 #include <ranges>
+#include <vector>
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <glm/ext/matrix_transform.hpp>
@@ -11,9 +12,12 @@
 #include "app/Image.h"
 #include "app/Model.h"
 #include "app/PerspectiveCamera.h"
+#include "app/RenderQueue.h"
 #include "app/ShaderProgram.h"
 #include "app/TimeManager.h"
 
+using namespace lgl::literals;
+
 constexpr auto DEFAULT_WINDOW_WIDTH{ 800 };
 constexpr auto DEFAULT_WINDOW_HEIGHT{ 600 };
 
@@ -151,8 +155,20 @@ int main(const int argc, char* argv[])
     controller->setMoveSpeed(5.0f);
     controller->setMouseSensitivity(0.1f);
 
+    lgl::Mesh::setVertexFormat(lgl::VertexFormat::Quantized);
+    lgl::Mesh::setBufferAllocation(lgl::BufferAllocation::Shared);
     const auto backpackShaderProgram{
-        lgl::ShaderProgram::load("shaders/backpack.vert", "shaders/backpack.frag")
+        lgl::ShaderProgram::load(lgl::Mesh::vertexFormat() == lgl::VertexFormat::Full
+                                 ? "shaders/backpack.vert"
+                                 : "shaders/backpack_packed.vert",
+                                 "shaders/backpack.frag")
+    };
+
+    const auto instancedBackpackShaderProgram{
+        lgl::ShaderProgram::load(lgl::Mesh::vertexFormat() == lgl::VertexFormat::Full
+                                 ? "shaders/backpack_instanced.vert"
+                                 : "shaders/backpack_packed_instanced.vert",
+                                 "shaders/backpack.frag")
     };
 
     const auto lightSourceShaderProgram{
@@ -163,6 +179,76 @@ int main(const int argc, char* argv[])
         lgl::Model::load("resources/models/backpack/backpack.obj")
     };
 
+    // A backpack at every cube position but the first, where the level of detail demo draws one
+    const auto backpackInstances{
+        std::views::enumerate(cubePositions)
+        | std::views::drop(1)
+        | std::views::transform([](const auto& indexed)
+        {
+            const auto& [index, position]{ indexed };
+            return glm::rotate(glm::translate(glm::mat4{ 1.0f }, position),
+                               glm::radians(20.0f * static_cast<float>(index)),
+                               glm::vec3{ 1.0f, 0.3f, 0.5f });
+        })
+        | std::ranges::to<std::vector>()
+    };
+
+    // Everything but the camera's spotlight is fixed, so those uniforms are set once
+    for (const auto shaderProgram : { &backpackShaderProgram, &instancedBackpackShaderProgram })
+    {
+        shaderProgram->use();
+        shaderProgram->setUniform("directionalLight.direction"_u, -0.2f, -1.0f, -0.3f);
+        shaderProgram->setUniform("directionalLight.ambient"_u, glm::vec3{ 0.05f });
+        shaderProgram->setUniform("directionalLight.diffuse"_u, glm::vec3{ 0.4f });
+        shaderProgram->setUniform("directionalLight.specular"_u, glm::vec3{ 0.5 });
+        for (auto&& [index, position] : std::views::enumerate(pointLightPositions))
+        {
+            shaderProgram->setUniform("pointLights[].position"_u[index], position);
+            shaderProgram->setUniform("pointLights[].ambient"_u[index], glm::vec3{ 0.05 });
+            shaderProgram->setUniform("pointLights[].diffuse"_u[index], glm::vec3{ 0.8f });
+            shaderProgram->setUniform("pointLights[].specular"_u[index], glm::vec3{ 1.0f });
+            shaderProgram->setUniform("pointLights[].constant"_u[index], 1.0f);
+            shaderProgram->setUniform("pointLights[].linear"_u[index], 0.09f);
+            shaderProgram->setUniform("pointLights[].quadratic"_u[index], 0.032f);
+        }
+        shaderProgram->setUniform("spotLight.cutoff"_u, glm::cos(glm::radians(12.5f)));
+        shaderProgram->setUniform("spotLight.outerCutoff"_u, glm::cos(glm::radians(15.0f)));
+        shaderProgram->setUniform("spotLight.ambient"_u, glm::vec3{ 0.0f });
+        shaderProgram->setUniform("spotLight.diffuse"_u, glm::vec3{ 1.0f });
+        shaderProgram->setUniform("spotLight.specular"_u, glm::vec3{ 1.0f });
+        shaderProgram->setUniform("spotLight.constant"_u, 1.0f);
+        shaderProgram->setUniform("spotLight.linear"_u, 0.09f);
+        shaderProgram->setUniform("spotLight.quadratic"_u, 0.032f);
+        shaderProgram->setUniform("material.shininess"_u, 64.0f);
+    }
+    glUseProgram(0);
+
+    // The uniforms that do change, resolved once per program
+    struct FrameUniforms
+    {
+        lgl::UniformHandle<glm::vec3> spotLightPosition;
+        lgl::UniformHandle<glm::vec3> spotLightDirection;
+        lgl::UniformHandle<glm::vec3> viewPos;
+        lgl::UniformHandle<glm::mat4> view;
+        lgl::UniformHandle<glm::mat4> projection;
+    };
+    const auto resolveFrameUniforms{
+        [](const lgl::ShaderProgram& shaderProgram)
+        {
+            return FrameUniforms{
+                .spotLightPosition = shaderProgram.uniformHandle<glm::vec3>("spotLight.position"),
+                .spotLightDirection = shaderProgram.uniformHandle<glm::vec3>("spotLight.direction"),
+                .viewPos = shaderProgram.uniformHandle<glm::vec3>("viewPos"),
+                .view = shaderProgram.uniformHandle<glm::mat4>("view"),
+                .projection = shaderProgram.uniformHandle<glm::mat4>("projection")
+            };
+        }
+    };
+    const auto backpackUniforms{ resolveFrameUniforms(backpackShaderProgram) };
+    const auto instancedBackpackUniforms{ resolveFrameUniforms(instancedBackpackShaderProgram) };
+
+    lgl::RenderQueue renderQueue{};
+
     GLuint lightSourceVertexArrayObject{};
     glGenVertexArrays(1, &lightSourceVertexArrayObject);
 
@@ -201,48 +287,37 @@ int main(const int argc, char* argv[])
         const auto viewMatrix{ camera->getViewMatrix() };
         const auto projectionMatrix{ camera->getProjectionMatrix() };
 
+        const auto setFrameUniforms{
+            [&](const lgl::ShaderProgram& shaderProgram, const FrameUniforms& uniforms)
+            {
+                shaderProgram.setUniform(uniforms.spotLightPosition, camera->getPosition());
+                shaderProgram.setUniform(uniforms.spotLightDirection, camera->getForwardVector());
+                shaderProgram.setUniform(uniforms.viewPos, camera->getPosition());
+                shaderProgram.setUniform(uniforms.view, viewMatrix);
+                shaderProgram.setUniform(uniforms.projection, projectionMatrix);
+            }
+        };
+
         backpackShaderProgram.use();
-        backpackShaderProgram.setUniform("directionalLight.direction", -0.2f, -1.0f, -0.3f);
-        backpackShaderProgram.setUniform("directionalLight.ambient", glm::vec3{ 0.05f });
-        backpackShaderProgram.setUniform("directionalLight.diffuse", glm::vec3{ 0.4f });
-        backpackShaderProgram.setUniform("directionalLight.specular", glm::vec3{ 0.5 });
-        for (auto&& [index, position] : std::views::enumerate(pointLightPositions))
-        {
-            backpackShaderProgram.setUniform(std::format("pointLights[{}].position", index), position);
-            backpackShaderProgram.setUniform(std::format("pointLights[{}].ambient", index), glm::vec3{ 0.05 });
-            backpackShaderProgram.setUniform(std::format("pointLights[{}].diffuse", index), glm::vec3{ 0.8f });
-            backpackShaderProgram.setUniform(std::format("pointLights[{}].specular", index), glm::vec3{ 1.0f });
-            backpackShaderProgram.setUniform(std::format("pointLights[{}].constant", index), 1.0f);
-            backpackShaderProgram.setUniform(std::format("pointLights[{}].linear", index), 0.09f);
-            backpackShaderProgram.setUniform(std::format("pointLights[{}].quadratic", index), 0.032f);
-        }
-        backpackShaderProgram.setUniform("spotLight.position", camera->getPosition());
-        backpackShaderProgram.setUniform("spotLight.direction", camera->getForwardVector());
-        backpackShaderProgram.setUniform("spotLight.cutoff", glm::cos(glm::radians(12.5f)));
-        backpackShaderProgram.setUniform("spotLight.outerCutoff", glm::cos(glm::radians(15.0f)));
-        backpackShaderProgram.setUniform("spotLight.ambient", glm::vec3{ 0.0f });
-        backpackShaderProgram.setUniform("spotLight.diffuse", glm::vec3{ 1.0f });
-        backpackShaderProgram.setUniform("spotLight.specular", glm::vec3{ 1.0f });
-        backpackShaderProgram.setUniform("spotLight.constant", 1.0f);
-        backpackShaderProgram.setUniform("spotLight.linear", 0.09f);
-        backpackShaderProgram.setUniform("spotLight.quadratic", 0.032f);
-        backpackShaderProgram.setUniform("viewPos", camera->getPosition());
+        setFrameUniforms(backpackShaderProgram, backpackUniforms);
 
+        // The queue sets the model and normal matrices, and draws the visible meshlet runs and levels of detail with
+        // indirect commands, in program, material and vertex array order
         constexpr glm::mat4 model{ 1.0f };
-        backpackShaderProgram.setUniform("model", model);
-        // Set view and projection matrices
-        backpackShaderProgram.setUniform("view", viewMatrix);
-        backpackShaderProgram.setUniform("projection", projectionMatrix);
-        // Calculate and set the normal matrix
-        const auto normalMatrix{ glm::transpose(glm::inverse(glm::mat3{ model })) };
-        backpackShaderProgram.setUniform("normalMatrix", normalMatrix);
-        // Set material shininess
-        backpackShaderProgram.setUniform("material.shininess", 64.0f);
-
-        backpackModel.draw(backpackShaderProgram);
+        backpackModel.enqueue(renderQueue,
+                              backpackShaderProgram,
+                              *camera,
+                              model,
+                              windowManager.getWindowSize().y);
+        renderQueue.flush();
+
+        // The other copies in one instanced draw per mesh
+        instancedBackpackShaderProgram.use();
+        setFrameUniforms(instancedBackpackShaderProgram, instancedBackpackUniforms);
+        backpackModel.drawInstanced(instancedBackpackShaderProgram, backpackInstances);
 
         lightSourceShaderProgram.use();
-        lightSourceShaderProgram.setUniform("lightColor", glm::vec3{ 1.0 });
+        lightSourceShaderProgram.setUniform("lightColor"_u, glm::vec3{ 1.0 });
         glBindVertexArray(lightSourceVertexArrayObject);
         for (auto&& position : pointLightPositions)
         {
@@ -256,11 +331,11 @@ int main(const int argc, char* argv[])
                 )
             };
             lightSourceShaderProgram.setUniform(
-                "model",
+                "model"_u,
                 lightSourceModelMatrix
             );
-            lightSourceShaderProgram.setUniform("view", viewMatrix);
-            lightSourceShaderProgram.setUniform("projection", projectionMatrix);
+            lightSourceShaderProgram.setUniform("view"_u, viewMatrix);
+            lightSourceShaderProgram.setUniform("projection"_u, projectionMatrix);
 
             glDrawArrays(GL_TRIANGLES, 0, 36);
         }
@@ -4,8 +4,45 @@
 
 #include "app/utilities.h"
 
+#include <array>
+#include <bit>
+#include <cstring>
+#include <format>
 #include <fstream>
+#include <functional>
 #include <print>
+#include <thread>
+
+namespace
+{
+    constexpr uint64_t PRIME64_1{ 0x9E3779B185EBCA87ULL };
+    constexpr uint64_t PRIME64_2{ 0xC2B2AE3D27D4EB4FULL };
+    constexpr uint64_t PRIME64_3{ 0x165667B19E3779F9ULL };
+    constexpr uint64_t PRIME64_4{ 0x85EBCA77C2B2AE63ULL };
+    constexpr uint64_t PRIME64_5{ 0x27D4EB2F165667C5ULL };
+
+    template<typename T>
+    T readLittleEndian(const std::byte* data) noexcept
+    {
+        T value{};
+        std::memcpy(&value, data, sizeof(T));
+        if constexpr (std::endian::native == std::endian::big)
+        {
+            value = std::byteswap(value);
+        }
+        return value;
+    }
+
+    uint64_t round(const uint64_t accumulator, const uint64_t input) noexcept
+    {
+        return std::rotl(accumulator + input * PRIME64_2, 31) * PRIME64_1;
+    }
+
+    uint64_t mergeRound(const uint64_t accumulator, const uint64_t value) noexcept
+    {
+        return (accumulator ^ round(0, value)) * PRIME64_1 + PRIME64_4;
+    }
+}
 
 namespace lgl
 {
@@ -29,4 +66,95 @@ namespace lgl
         file.read(content.data(), static_cast<std::streamsize>(content.size()));
         return content;
     }
+
+    bool writeAllAtomically(const std::filesystem::path& filepath, const std::span<const std::byte> bytes)
+    {
+        std::error_code error{};
+        std::filesystem::create_directories(filepath.parent_path(), error);
+
+        auto temporaryPath{ filepath };
+        temporaryPath += std::format(".{}.tmp", std::hash<std::thread::id>{}(std::this_thread::get_id()));
+        {
+            std::ofstream file{ temporaryPath, std::ios::binary | std::ios::trunc };
+            if (!file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size())))
+            {
+                std::println(stderr, "Failed to write '{}'", temporaryPath.string());
+                std::filesystem::remove(temporaryPath, error);
+                return false;
+            }
+        }
+        std::filesystem::rename(temporaryPath, filepath, error);
+        if (error)
+        {
+            std::println(stderr, "Failed to store '{}': {}", filepath.string(), error.message());
+            std::filesystem::remove(temporaryPath, error);
+            return false;
+        }
+        return true;
+    }
+
+    uint64_t hash64(const std::span<const std::byte> bytes, const uint64_t seed) noexcept
+    {
+        const auto* data{ bytes.data() };
+        const auto* const end{ data + bytes.size() };
+        uint64_t hash{};
+
+        if (bytes.size() >= 32)
+        {
+            std::array accumulators{
+                seed + PRIME64_1 + PRIME64_2,
+                seed + PRIME64_2,
+                seed,
+                seed - PRIME64_1
+            };
+            for (; data + 32 <= end; data += 32)
+            {
+                for (std::size_t lane{ 0 }; lane < accumulators.size(); ++lane)
+                {
+                    accumulators[lane] = round(accumulators[lane], readLittleEndian<uint64_t>(data + lane * 8));
+                }
+            }
+            hash = std::rotl(accumulators[0], 1) + std::rotl(accumulators[1], 7) +
+                   std::rotl(accumulators[2], 12) + std::rotl(accumulators[3], 18);
+            for (const auto accumulator : accumulators)
+            {
+                hash = mergeRound(hash, accumulator);
+            }
+        }
+        else
+        {
+            hash = seed + PRIME64_5;
+        }
+
+        hash += bytes.size();
+
+        for (; data + 8 <= end; data += 8)
+        {
+            hash ^= round(0, readLittleEndian<uint64_t>(data));
+            hash = std::rotl(hash, 27) * PRIME64_1 + PRIME64_4;
+        }
+        if (data + 4 <= end)
+        {
+            hash ^= static_cast<uint64_t>(readLittleEndian<uint32_t>(data)) * PRIME64_1;
+            hash = std::rotl(hash, 23) * PRIME64_2 + PRIME64_3;
+            data += 4;
+        }
+        for (; data < end; ++data)
+        {
+            hash ^= static_cast<uint64_t>(*data) * PRIME64_5;
+            hash = std::rotl(hash, 11) * PRIME64_1;
+        }
+
+        hash ^= hash >> 33;
+        hash *= PRIME64_2;
+        hash ^= hash >> 29;
+        hash *= PRIME64_3;
+        hash ^= hash >> 32;
+        return hash;
+    }
+
+    uint64_t hash64(const std::string_view text, const uint64_t seed) noexcept
+    {
+        return hash64(std::as_bytes(std::span{ text }), seed);
+    }
 } // lgl
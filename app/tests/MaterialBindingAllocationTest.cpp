@@ -0,0 +1,302 @@
+//
+// Created by user on 10/17/26.
+//
+
+// Binding a mesh's material after the first bind with a program must not allocate. Every GL entry point the test
+// reaches is replaced by a stub that records the state, so no context is needed.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <print>
+#include <string_view>
+#include <vector>
+#include <glad/glad.h>
+#include "app/MaterialBinding.h"
+#include "app/Mesh.h"
+#include "app/ShaderProgram.h"
+
+namespace
+{
+    std::atomic<std::size_t> allocationCount{ 0 };
+
+    template<typename F>
+    std::size_t allocationsDuring(F&& body)
+    {
+        const auto before{ allocationCount.load() };
+        body();
+        return allocationCount.load() - before;
+    }
+
+    // Active uniforms of the stub program, arrays by their first element like glGetActiveUniform reports them
+    struct StubUniform
+    {
+        std::string_view name;
+        GLint size;
+    };
+
+    constexpr std::array STUB_UNIFORMS{
+        StubUniform{ .name = "material.diffuses[0]", .size = 2 },
+        StubUniform{ .name = "material.speculars[0]", .size = 1 }
+    };
+
+    struct StubLocation
+    {
+        std::string_view name;
+        GLint location;
+    };
+
+    constexpr std::array STUB_LOCATIONS{
+        StubLocation{ .name = "material.diffuses[0]", .location = 10 },
+        StubLocation{ .name = "material.diffuses[1]", .location = 11 },
+        StubLocation{ .name = "material.speculars[0]", .location = 12 }
+    };
+
+    // State the stubs keep, in fixed storage so recording does not allocate either
+    struct StubState
+    {
+        GLuint nextName{ 1 };
+        GLenum activeTexture{ GL_TEXTURE0 };
+        std::array<GLuint, 16> boundTextures{}; // By unit
+        std::array<GLint, 16> samplerUnits{}; // By uniform location
+        std::size_t textureBindCount{ 0 };
+    };
+
+    StubState stubState{};
+
+    void APIENTRY genNames(const GLsizei count, GLuint* names)
+    {
+        for (GLsizei i{ 0 }; i < count; ++i)
+        {
+            names[i] = stubState.nextName++;
+        }
+    }
+
+    void APIENTRY deleteNames(GLsizei, const GLuint*)
+    {
+    }
+
+    void APIENTRY bindName(GLuint)
+    {
+    }
+
+    void APIENTRY bindBuffer(GLenum, GLuint)
+    {
+    }
+
+    void APIENTRY bufferData(GLenum, GLsizeiptr, const void*, GLenum)
+    {
+    }
+
+    void APIENTRY bufferSubData(GLenum, GLintptr, GLsizeiptr, const void*)
+    {
+    }
+
+    void APIENTRY vertexAttribPointer(GLuint, GLint, GLenum, GLboolean, GLsizei, const void*)
+    {
+    }
+
+    void APIENTRY vertexAttribIPointer(GLuint, GLint, GLenum, GLsizei, const void*)
+    {
+    }
+
+    void APIENTRY vertexAttribDivisor(GLuint, GLuint)
+    {
+    }
+
+    void APIENTRY getProgramiv(GLuint, const GLenum parameter, GLint* value)
+    {
+        switch (parameter)
+        {
+            case GL_LINK_STATUS:
+                *value = GL_TRUE;
+                break;
+            case GL_ACTIVE_UNIFORMS:
+                *value = static_cast<GLint>(STUB_UNIFORMS.size());
+                break;
+            case GL_ACTIVE_UNIFORM_MAX_LENGTH:
+                *value = 64;
+                break;
+            default:
+                *value = 0;
+                break;
+        }
+    }
+
+    void APIENTRY getActiveUniform(GLuint,
+                                   const GLuint index,
+                                   const GLsizei bufferSize,
+                                   GLsizei* length,
+                                   GLint* size,
+                                   GLenum* type,
+                                   GLchar* name)
+    {
+        const auto& uniform{ STUB_UNIFORMS.at(index) };
+        const auto copied{ std::min(uniform.name.size(), static_cast<std::size_t>(bufferSize - 1)) };
+        std::memcpy(name, uniform.name.data(), copied);
+        name[copied] = '\0';
+        *length = static_cast<GLsizei>(copied);
+        *size = uniform.size;
+        *type = GL_SAMPLER_2D;
+    }
+
+    GLint APIENTRY getUniformLocation(GLuint, const GLchar* name)
+    {
+        const auto location{ std::ranges::find(STUB_LOCATIONS, std::string_view{ name }, &StubLocation::name) };
+        return location == STUB_LOCATIONS.end() ? -1 : location->location;
+    }
+
+    void APIENTRY deleteProgram(GLuint)
+    {
+    }
+
+    void APIENTRY activeTexture(const GLenum texture)
+    {
+        stubState.activeTexture = texture;
+    }
+
+    void APIENTRY uniform1i(const GLint location, const GLint value)
+    {
+        if (location != -1)
+        {
+            stubState.samplerUnits.at(static_cast<std::size_t>(location)) = value;
+        }
+    }
+
+    void APIENTRY bindTexture(GLenum, const GLuint texture)
+    {
+        stubState.boundTextures.at(stubState.activeTexture - GL_TEXTURE0) = texture;
+        ++stubState.textureBindCount;
+    }
+
+    void installStubs()
+    {
+        glad_glGenBuffers = genNames;
+        glad_glGenVertexArrays = genNames;
+        glad_glDeleteBuffers = deleteNames;
+        glad_glDeleteVertexArrays = deleteNames;
+        glad_glDeleteTextures = deleteNames;
+        glad_glBindVertexArray = bindName;
+        glad_glBindBuffer = bindBuffer;
+        glad_glBufferData = bufferData;
+        glad_glBufferSubData = bufferSubData;
+        glad_glEnableVertexAttribArray = bindName;
+        glad_glVertexAttribPointer = vertexAttribPointer;
+        glad_glVertexAttribIPointer = vertexAttribIPointer;
+        glad_glVertexAttribDivisor = vertexAttribDivisor;
+        glad_glGetProgramiv = getProgramiv;
+        glad_glGetActiveUniform = getActiveUniform;
+        glad_glGetUniformLocation = getUniformLocation;
+        glad_glDeleteProgram = deleteProgram;
+        glad_glActiveTexture = activeTexture;
+        glad_glUniform1i = uniform1i;
+        glad_glBindTexture = bindTexture;
+    }
+
+    int failureCount{ 0 };
+
+    void check(const bool condition, const std::string_view what)
+    {
+        if (!condition)
+        {
+            std::println(stderr, "FAILED: {}", what);
+            ++failureCount;
+        }
+    }
+
+    // Units and sampler locations a bind of the test textures must leave behind
+    void checkBoundState(const std::string_view what)
+    {
+        check(stubState.boundTextures[0] == 101 && stubState.boundTextures[1] == 102
+              && stubState.boundTextures[2] == 103 && stubState.boundTextures[3] == 104,
+              what);
+        check(stubState.samplerUnits[10] == 0 && stubState.samplerUnits[11] == 1 && stubState.samplerUnits[12] == 2,
+              what);
+        check(stubState.activeTexture == GL_TEXTURE0, what);
+    }
+
+    constexpr std::size_t BIND_ITERATIONS{ 100 };
+}
+
+// The array and nothrow forms call this one; nothing on the tested paths is over-aligned
+void* operator new(const std::size_t size)
+{
+    ++allocationCount;
+    if (void* pointer{ std::malloc(std::max<std::size_t>(size, 1)) })
+    {
+        return pointer;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+int main()
+{
+    installStubs();
+
+    const lgl::ShaderProgram shaderProgram{ 1 };
+    // The normal map has no sampler in the program and keeps location -1
+    const std::vector<lgl::Texture> textures{
+        { .id = 101, .type = lgl::Texture::Type::DIFFUSE, .path = "diffuse0.png" },
+        { .id = 102, .type = lgl::Texture::Type::DIFFUSE, .path = "diffuse1.png" },
+        { .id = 103, .type = lgl::Texture::Type::SPECULAR, .path = "specular.png" },
+        { .id = 104, .type = lgl::Texture::Type::NORMAL, .path = "normal.png" }
+    };
+
+    const auto binding{ lgl::MaterialBinding::build(shaderProgram, textures) };
+    const auto bindingAllocations{
+        allocationsDuring([&]
+        {
+            for (std::size_t i{ 0 }; i < BIND_ITERATIONS; ++i)
+            {
+                binding.bind();
+            }
+        })
+    };
+    check(bindingAllocations == 0, "MaterialBinding::bind allocates");
+    check(stubState.textureBindCount == BIND_ITERATIONS * textures.size(), "MaterialBinding::bind misses textures");
+    checkBoundState("MaterialBinding::bind leaves the wrong textures bound");
+
+    stubState = { .nextName = stubState.nextName };
+    const lgl::Mesh mesh{
+        {
+            { .position = { 0.0f, 0.0f, 0.0f } },
+            { .position = { 1.0f, 0.0f, 0.0f } },
+            { .position = { 0.0f, 1.0f, 0.0f } }
+        },
+        { 0, 1, 2 },
+        textures
+    };
+    // The first bind with a program resolves its samplers
+    mesh.bindTextures(shaderProgram);
+    const auto meshAllocations{
+        allocationsDuring([&]
+        {
+            for (std::size_t i{ 0 }; i < BIND_ITERATIONS; ++i)
+            {
+                mesh.bindTextures(shaderProgram);
+            }
+        })
+    };
+    check(meshAllocations == 0, "Mesh::bindTextures allocates after the first bind");
+    checkBoundState("Mesh::bindTextures leaves the wrong textures bound");
+
+    if (failureCount > 0)
+    {
+        return EXIT_FAILURE;
+    }
+    std::println("{} binds of {} textures without allocating", 2 * BIND_ITERATIONS, textures.size());
+    return EXIT_SUCCESS;
+}